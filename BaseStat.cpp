@@ -14,6 +14,8 @@ double BaseStat::getPMFPercentile(double p) const {
 void BaseStat::dumpStat(const char *fname, const char *var_name,
 			bool dump_as_pmf, const char *comment)
 {
+  if (!isEnabled())
+    return;
   Logger::debugLog("# Opening output file %s for statistics\n", fname);
   FILE *file = fopen(fname, "w");
   ASSERT(file != 0, "Couldn't open output file for statistics");
@@ -28,6 +30,8 @@ void BaseStat::dumpStat(const char *fname, const char *var_name,
   fprintf(file, "# MeanPos = %g, MeanNegZero = %g, MeanAbs = %g\n",
       getMeanPos(), getMeanNegZero(),
       getMeanAbs());
+  fprintf(file, "# Samples = %ld, Weight = %g, WeightPos = %g\n",
+      getNumSamples(), getWeight(), getWeightPos());
   fprintf(
       file,
       "# Percentiles (00, 05, 10, 15, 85, 90, 95, 98, 99, 99.5, 100) = ( %g %g %g %g %g %g %g %g %g %g %g )\n",
@@ -37,8 +41,10 @@ void BaseStat::dumpStat(const char *fname, const char *var_name,
       getPMFPercentile(0.95), getPMFPercentile(0.98),
       getPMFPercentile(0.99), getPMFPercentile(0.995),
       getMax());
+  dumpSummary(file);
   fprintf(file, "# %9s %11s\n", var_name, "Pr");
-  double dx = getXValue(1) - getXValue(0);
+  /* Single-bin stats (e.g., ck of a tiny-utilization task) are dumped as they are */
+  double dx = getPMFSize() > 1 ? getXValue(1) - getXValue(0) : 1.0;
   for (long n = 0; n < getPMFSize(); ++n) {
     double x = getXValue(n);
     double p = getPMFValue(n);
@@ -22,6 +22,7 @@
 #define   __ARSIM_STAT_INTERFACE_HPP__
 
 #include <values.h>
+#include <stdio.h>
 #include <algorithm>
 
 class BaseStat {
@@ -31,12 +32,22 @@ protected:
   double min_val;       //< Minimum experimented value
   double max_val;       //< Maximum experimented value
   BaseStat() { clear(); }
+  /** Extend [min, max] to cover the one of s			*/
+  void mergeMinMax(const BaseStat & s) {
+    min_val = std::min(min_val, s.min_val);
+    max_val = std::max(max_val, s.max_val);
+  }
+
+public:
+
+  /** Feed with next sample					*/
   virtual void addSample(double value) {
     min_val = std::min(min_val, value);
     max_val = std::max(max_val, value);
   }
-
-public:
+  /** Feed with next sample, holding from time t on: time-weighted
+   ** statistics override this, the other ones ignore t		*/
+  virtual void addSample(double value, double t) { addSample(value); }
 
   /** Calculate mean from calculated PMF			*/
   virtual double calcPMFMean() const = 0;
@@ -89,9 +100,27 @@ public:
   }
 
   virtual long getNumSamples() const = 0;
+  /** Return the accumulated weight: the number of samples, or the
+   ** time over which they have been observed			*/
+  virtual double getWeight() const = 0;
+  /** Return the weight of strictly positive samples		*/
+  virtual double getWeightPos() const = 0;
+
+  /** Add the samples accumulated by s, which needs to be of the same
+   ** type and, for histograms, to have the same intervals. This allows
+   ** for combining parallel replications or split time ranges.
+   **/
+  virtual void merge(const BaseStat & s) = 0;
+
+  /** Return false for statistics disabled with "off" (NullStat),
+   ** which are not accumulated nor dumped			*/
+  virtual bool isEnabled() const { return true; }
+
+  /** Add statistic-specific summary lines to the header of dumpStat() */
+  virtual void dumpSummary(FILE *file) const { }
 
   /** Dumps statistic info contained in the TimeStat
-   ** object into the specified file
+   ** object into the specified file (nothing, if disabled)
    **/
   void dumpStat(const char *fname, const char *var_name,
 		bool dump_as_pmf, const char *comment = "No comment");
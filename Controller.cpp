@@ -34,20 +34,23 @@
 #include "MSSEController.hpp"
 #include "OCController.hpp"
 #include "util.hpp"
+#include "Profiler.hpp"
 #include "defaults.hpp"
 #include "ResourceManager.hpp"
 
 #include "TaskScheduler.hpp"
+#include "StatFactory.hpp"
 
 /* Implementation includes */
 
 #include <string.h>
 #include <math.h>
 
-Controller::Controller() :
-  pe_stat(-1.0, 1.0, 0.01),
-  pr_stat(0.0, 2.0, 1.0)
-{
+bool Controller::pred_file_enabled = true;
+
+Controller::Controller() {
+  pe_stat = StatFactory::getInstance("hist", -1.0, 1.0, 0.01, false);
+  pr_stat = StatFactory::getInstance("hist", 0.0, 2.0, 1.0, false);
   curr_k = 0;
   c_prev = 0;
   bw_prev_iot = 1.0;
@@ -72,6 +75,20 @@ Controller::Controller() :
 Controller::~Controller() {
   if (p_task != 0)
     delete p_task;
+  delete pe_stat;
+  delete pr_stat;
+}
+
+bool Controller::setStat(const string & name, const char *spec) {
+  if (name == "pe") {
+    delete pe_stat;
+    pe_stat = StatFactory::getInstance(spec, -1.0, 1.0, 0.01, false);
+  } else if (name == "pr") {
+    delete pr_stat;
+    pr_stat = StatFactory::getInstance(spec, 0.0, 2.0, 1.0, false);
+  } else
+    return false;
+  return true;
 }
 
 Controller * Controller::getInstance(const char *s) {
@@ -125,6 +142,7 @@ void Controller::calcParams() {
   p_task->calcParams();
   ASSERT(this->p_tpred != 0, "No task predictor instantiated for controller");
   p_tpred->calcParams();
+  p_tpred = TaskPredictor::compose(p_tpred);
 }
 
 void Controller::usage() {
@@ -197,7 +215,11 @@ double Controller::getTaskDev() {
 //}
 
 Interval Controller::getTaskExpInterval() const {
-  Interval iv = p_tpred->getExpInterval();
+  Interval iv;
+  {
+    PROF_SCOPE("TaskPredictor::getExpInterval", p_tpred);
+    iv = p_tpred->getExpInterval();
+  }
   double c_min = iv.getMin();
   double c_max = iv.getMax();
 
@@ -224,16 +246,16 @@ void Controller::setLastJobExecTime(double c) {
     double pred_err = (pred_val - c) / p_task->getPeriod();
     Logger::debugLog("Adding pred error sample: %g (relative), %g (absolute)\n",
         pred_err, pred_err * p_task->getPeriod());
-    pe_stat.addSample(pred_err);
+    pe_stat->addSample(pred_err);
   }
   Interval I = getTaskExpInterval();
   double c_min = I.getMin();
   double c_max = I.getMax();
   if (/*c_min > 0.0 &&*/ c_max >= c_min) {
     if (/*c_min <= c &&*/ c <= c_max)
-      pr_stat.addSample(1.0);
+      pr_stat->addSample(1.0);
     else
-      pr_stat.addSample(0.0);
+      pr_stat->addSample(0.0);
   }
   if (curr_k > 15 && (I.isEmpty() || fabs(c_min) > 1000000 || fabs(c_max) > 1000000)) {
     fprintf(stderr, "# Empty prediction range: [%g,%g]\n", I.getMin(), I.getMax());
@@ -242,6 +264,10 @@ void Controller::setLastJobExecTime(double c) {
   }
   p_tpred->addSample(c);
 
+  if (! pred_file_enabled) {
+    ++curr_k;
+    return;
+  }
   if (pred_file == 0) {
 	char *pf_fname;
 	pf_fname = strdup("pred0,0.dat");
@@ -263,14 +289,14 @@ void Controller::dumpStats() {
   pe_fname = strdup("pe_stats0,0.dat");
   pe_fname[8] = '0' + num_task;
   pe_fname[10] = '0' + num_rs;
-  pe_stat.dumpStat(pe_fname, "pe", false, "Prediction Error");
+  pe_stat->dumpStat(pe_fname, "pe", false, "Prediction Error");
 
   /** Dump stats of correct range prediction */
   char *pr_fname;
   pr_fname = strdup("pr_stats0,0.dat");
   pr_fname[8] = '0' + num_task;
   pr_fname[10] = '0' + num_rs;
-  pr_stat.dumpStat(pr_fname, "pr", true, "Correct Prediction Range");
+  pr_stat->dumpStat(pr_fname, "pr", true, "Correct Prediction Range");
 }
 
 void Controller::setTask(Task* p_t) {
@@ -28,6 +28,7 @@
 
 #include <stdio.h>
 #include <deque>
+#include <string>
 
 /**
  * @file
@@ -62,10 +63,11 @@ class Controller : public Component {
   bool dyn_bw_active;	//< If set, dynamically maximizes bandwidth right after deadline violation
   double dyn_bw_rel_dl;	//< Percentage of period at which scheduler switches to max bandwidth
 
-  Stat pe_stat;		//< Statistics of prediction error
-  Stat pr_stat;		//< Statistics of correct prediction range
+  BaseStat *pe_stat;	//< Statistics of prediction error
+  BaseStat *pr_stat;	//< Statistics of correct prediction range
 
   FILE *pred_file;	//< Trace of predictor-related info
+  static bool pred_file_enabled; //< If cleared, no predictor trace is written
 
   int num_rs;		//< Number of resource
   int num_task;		//< Number of task on this resource
@@ -98,6 +100,9 @@ class Controller : public Component {
   /** Calculate further parameters, if any */
   virtual void calcParams();
   /** Dump statistics at end of simulation      **/
+  /** Replace the statistic name (e.g., "pe") with one of type spec (see
+   ** StatFactory): return false if the controller has no such statistic */
+  virtual bool setStat(const std::string & name, const char *spec);
   virtual void dumpStats();
   /** Get last measured execution time          **/
   double getTaskTime() const { return c_prev; }
@@ -125,6 +130,9 @@ class Controller : public Component {
 
   TaskPredictor *getTaskPredictor() { return p_tpred; }
 
+  /** Enable or disable the pred*.dat traces of all controllers	**/
+  static void setPredFileEnabled(bool enabled) { pred_file_enabled = enabled; }
+
   virtual void clearHistory() { p_tpred->clearHistory(); }
 };
 
@@ -0,0 +1,332 @@
+/*
+ * ARSim
+ * Copyright (c) 2000-2010 Tommaso Cucinotta
+ *
+ * This file is part of ARSim.
+ *
+ * ARSim is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * ARSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with ARSim. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <cstring>
+#include <typeinfo>
+#include <algorithm>
+
+#include "ControllerBank.hpp"
+#include "LimitedController.hpp"
+#include "PDNVController.hpp"
+#include "InvariantController.hpp"
+#include "TaskScheduler.hpp"
+#include "ResourceManager.hpp"
+#include "Profiler.hpp"
+#include "util.hpp"
+
+ControllerBank *ControllerBank::p_cb = new ControllerBank();
+
+ControllerBank::ControllerBank() {
+  enabled = false;
+}
+
+void ControllerBank::usage() {
+  printf("  CONTROLLER BANK OPTIONS\n");
+  printf("           -cbank   Compute the bandwidths of the la, pdnv and ib controllers\n");
+  printf("                    starting a job at the same time as one batch\n");
+}
+
+bool ControllerBank::parseArg(int& argc, char **& argv) {
+  if (strcmp(*argv, "-cbank") == 0) {
+    enabled = true;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+/* Subclasses may redefine the control law, so only the exact types are
+ * registered.
+ */
+int ControllerBank::addController(Controller *p_ctrl) {
+  Kind kind;
+  unsigned int pos;
+  if (typeid(*p_ctrl) == typeid(LimitedController)
+      && ((LimitedController *) p_ctrl)->cbw_method == &LimitedController::calcBandwidthLimitedAsymm) {
+    kind = K_LA;
+    pos = la.period.size();
+    la.period.resize(pos + 1);
+    la.c_min.resize(pos + 1);
+    la.c_max.resize(pos + 1);
+    la.eps_min.resize(pos + 1);
+    la.eps_max.resize(pos + 1);
+    la.u_min.resize(pos + 1);
+  } else if (typeid(*p_ctrl) == typeid(PDNVController)) {
+    kind = K_PDNV;
+    pos = pdnv.ctrl.size();
+    pdnv.ctrl.push_back((PDNVController *) p_ctrl);
+    pdnv.period.resize(pos + 1);
+    pdnv.target_eps.resize(pos + 1);
+    pdnv.spread.resize(pos + 1);
+    pdnv.bw_max.resize(pos + 1);
+  } else if (typeid(*p_ctrl) == typeid(InvariantController)) {
+    kind = K_IB;
+    pos = ib.ctrl.size();
+    ib.ctrl.push_back((InvariantController *) p_ctrl);
+    ib.period.resize(pos + 1);
+    ib.eps_min.resize(pos + 1);
+    ib.eps_max.resize(pos + 1);
+    ib.bw_max.resize(pos + 1);
+  } else {
+    return -1;
+  }
+  slot_kind.push_back(kind);
+  slot_pos.push_back(pos);
+  slot_ctrl.push_back(p_ctrl);
+  refresh(slot_kind.size() - 1);
+  return slot_kind.size() - 1;
+}
+
+void ControllerBank::refresh(int slot) {
+  ASSERT(slot >= 0 && slot < (int) slot_kind.size(), "Wrong controller bank slot");
+  unsigned int pos = slot_pos[slot];
+  switch (slot_kind[slot]) {
+  case K_LA: {
+    LimitedController *p_lc = (LimitedController *) slot_ctrl[slot];
+    la.period[pos] = p_lc->period;
+    la.c_min[pos] = p_lc->c_min;
+    la.c_max[pos] = p_lc->c_max;
+    la.eps_min[pos] = p_lc->eps_min;
+    la.eps_max[pos] = p_lc->eps_max;
+    la.u_min[pos] = 1.0 / p_lc->getMaxBandwidth();
+    break;
+  }
+  case K_PDNV: {
+    PDNVController *p_pc = pdnv.ctrl[pos];
+    pdnv.period[pos] = p_pc->getTask()->getPeriod();
+    pdnv.target_eps[pos] = p_pc->target_eps;
+    pdnv.spread[pos] = p_pc->spread;
+    pdnv.bw_max[pos] = p_pc->getMaxBandwidth();
+    break;
+  }
+  case K_IB: {
+    InvariantController *p_ic = ib.ctrl[pos];
+    ib.period[pos] = p_ic->getTask()->getPeriod();
+    ib.eps_min[pos] = p_ic->eps_min;
+    ib.eps_max[pos] = p_ic->eps_max;
+    ib.bw_max[pos] = p_ic->getMaxBandwidth();
+    break;
+  }
+  }
+}
+
+/* The inputs depending on the controller state (statistics and predicted
+ * ranges) are gathered here, in the same order as the scalar controllers
+ * would do, so that only the arithmetic is batched.
+ */
+void ControllerBank::enqueue(int slot, TaskScheduler *p_tsched, double sched_err, Time start_err) {
+  ASSERT(slot >= 0 && slot < (int) slot_kind.size(), "Wrong controller bank slot");
+  if (pend_tsched.empty())
+    EventList::events().insert(makeEvent(0, this, &ControllerBank::handleFlush));
+
+  Kind kind = slot_kind[slot];
+  unsigned int pos = slot_pos[slot];
+  unsigned int idx = 0;
+  switch (kind) {
+  case K_LA:
+    idx = la.pos.size();
+    la.pos.push_back(pos);
+    la.b_eps.push_back(start_err);
+    break;
+  case K_PDNV: {
+    PDNVController *p_pc = pdnv.ctrl[pos];
+    Interval iv = p_pc->getTaskExpInterval();
+    CHECK(! iv.isEmpty(), "Cannot determine task variability range");
+    idx = pdnv.pos.size();
+    pdnv.pos.push_back(pos);
+    pdnv.b_eps.push_back(start_err);
+    pdnv.b_h.push_back(iv.getMax() * pdnv.spread[pos]);
+    break;
+  }
+  case K_IB: {
+    /* As in InvariantController::calcBandwidth() and calcBandwidthRange() */
+    InvariantController *p_ic = ib.ctrl[pos];
+    if (sched_err <= p_ic->eps_max) {
+      p_ic->rsteps_inv_stat->addSample(p_ic->rsteps_inv);
+      p_ic->rsteps_inv = 0;
+    } else
+      p_ic->rsteps_inv++;
+    if (Interval(-p_ic->eps_min, p_ic->eps_max).contains(sched_err))
+      p_ic->eps_inv_stat.addSample(1.0);
+    else
+      p_ic->eps_inv_stat.addSample(0.0);
+    Interval c_range = p_ic->getTaskExpInterval();
+    idx = ib.pos.size();
+    ib.pos.push_back(pos);
+    ib.b_eps.push_back(start_err);
+    if (c_range.isEmpty()) {
+      ib.b_c_min.push_back(0.0);
+      ib.b_c_max.push_back(0.0);
+      ib.b_none.push_back(1.0);
+    } else {
+      p_ic->c_min = c_range.getMin();
+      p_ic->c_max = c_range.getMax();
+      p_ic->range_width_stat->addSample((p_ic->c_max - p_ic->c_min) / ib.period[pos]);
+      p_ic->range_alpha_stat->addSample(p_ic->c_min / p_ic->c_max);
+      ib.b_c_min.push_back(p_ic->c_min);
+      ib.b_c_max.push_back(p_ic->c_max);
+      ib.b_none.push_back(0.0);
+    }
+    break;
+  }
+  }
+  pend_tsched.push_back(p_tsched);
+  pend_start_err.push_back(start_err);
+  pend_kind.push_back(kind);
+  pend_idx.push_back(idx);
+}
+
+/* Loops below use only conditional selections, so that they may be
+ * vectorized, and select the same operands as the scalar versions do,
+ * so that results are the same.
+ */
+
+/* LimitedController::calcBandwidthLimitedAsymm() */
+void ControllerBank::calcLA() {
+  unsigned int n = la.pos.size();
+  if (n == 0)
+    return;
+  la.b_period.resize(n);  la.b_c_min.resize(n);  la.b_c_max.resize(n);
+  la.b_eps_min.resize(n);  la.b_eps_max.resize(n);  la.b_u_min.resize(n);
+  la.b_bw.resize(n);  la.b_ok.resize(n);
+  for (unsigned int i = 0; i < n; ++i) {
+    unsigned int p = la.pos[i];
+    la.b_period[i] = la.period[p];
+    la.b_c_min[i] = la.c_min[p];
+    la.b_c_max[i] = la.c_max[p];
+    la.b_eps_min[i] = la.eps_min[p];
+    la.b_eps_max[i] = la.eps_max[p];
+    la.b_u_min[i] = la.u_min[p];
+  }
+
+  const double *T = &la.b_period[0], *h = &la.b_c_min[0], *H = &la.b_c_max[0];
+  const double *e = &la.b_eps_min[0], *E = &la.b_eps_max[0], *u_min = &la.b_u_min[0];
+  const double *eps = &la.b_eps[0];
+  double *bw = &la.b_bw[0], *ok = &la.b_ok[0];
+  for (unsigned int i = 0; i < n; ++i) {
+    double uu = eps[i] > 0 ? (T[i] - e[i] - eps[i]) / h[i] : (T[i] - e[i]) / h[i];
+    double UU = eps[i] > 0 ? (T[i] + E[i] - eps[i]) / H[i] : (T[i] + E[i]) / H[i];
+    double l = MAX(uu, u_min[i]);
+    double L = MIN(UU, MAXDOUBLE);
+    ok[i] = (uu <= UU && !(UU < u_min[i]) && !(uu > MAXDOUBLE)) ? 1.0 : 0.0;
+    bw[i] = 2.0 / (l + L);
+  }
+  for (unsigned int i = 0; i < n; ++i)
+    ASSERT(ok[i] != 0.0, "Scheduling impossible");
+}
+
+/* PDNVController::calcBandwidth() */
+void ControllerBank::calcPDNV() {
+  unsigned int n = pdnv.pos.size();
+  if (n == 0)
+    return;
+  pdnv.b_period.resize(n);  pdnv.b_target_eps.resize(n);  pdnv.b_bw_max.resize(n);
+  pdnv.b_bw.resize(n);  pdnv.b_bw_iot.resize(n);
+  for (unsigned int i = 0; i < n; ++i) {
+    unsigned int p = pdnv.pos[i];
+    pdnv.b_period[i] = pdnv.period[p];
+    pdnv.b_target_eps[i] = pdnv.target_eps[p];
+    pdnv.b_bw_max[i] = pdnv.bw_max[p];
+  }
+
+  const double *T = &pdnv.b_period[0], *d = &pdnv.b_target_eps[0], *bw_max = &pdnv.b_bw_max[0];
+  const double *eps = &pdnv.b_eps[0], *H = &pdnv.b_h[0];
+  double *bw = &pdnv.b_bw[0], *bw_iot = &pdnv.b_bw_iot[0];
+  for (unsigned int i = 0; i < n; ++i) {
+    double b = eps[i] > 0 ? H[i] / (T[i] + d[i] - eps[i]) : H[i] / (T[i] + d[i]);
+    bw[i] = eps[i] < T[i] + d[i] - H[i] / bw_max[i] ? b : bw_max[i];
+    double b_iot = H[i] / T[i];
+    bw_iot[i] = (b_iot > bw_max[i] || b_iot <= 0.0001) ? bw_max[i] : b_iot;
+  }
+}
+
+/* InvariantController::calcBandwidthLimitedAsymm(), with the bandwidth
+ * ranges of InvariantController::calcBwRange() for the start error and
+ * for eps_max (bandwidth if on time).
+ */
+void ControllerBank::calcIB() {
+  unsigned int n = ib.pos.size();
+  if (n == 0)
+    return;
+  ib.b_period.resize(n);  ib.b_eps_min.resize(n);  ib.b_eps_max.resize(n);
+  ib.b_bw_max.resize(n);  ib.b_bw.resize(n);  ib.b_bw_iot.resize(n);
+  for (unsigned int i = 0; i < n; ++i) {
+    unsigned int p = ib.pos[i];
+    ib.b_period[i] = ib.period[p];
+    ib.b_eps_min[i] = ib.eps_min[p];
+    ib.b_eps_max[i] = ib.eps_max[p];
+    ib.b_bw_max[i] = ib.bw_max[p];
+  }
+
+  const double *T = &ib.b_period[0], *e = &ib.b_eps_min[0], *E = &ib.b_eps_max[0];
+  const double *bw_max = &ib.b_bw_max[0], *eps = &ib.b_eps[0];
+  const double *h = &ib.b_c_min[0], *H = &ib.b_c_max[0], *none = &ib.b_none[0];
+  double *bw = &ib.b_bw[0], *bw_iot = &ib.b_bw_iot[0];
+  for (unsigned int i = 0; i < n; ++i) {
+    double BB = h[i] / (T[i] - e[i] - eps[i]);
+    double bb = H[i] / (T[i] + E[i] - eps[i]);
+    BB = BB <= bb ? bb + DELTA : BB;
+    /* An empty Interval(bb, BB) has mid-point 0, then saturated */
+    double b = bb <= BB ? (bb + BB) / 2.0 : 0.0;
+    b = (none[i] != 0.0 || eps[i] > T[i] - e[i]) ? bw_max[i] : b;
+    bw[i] = (b > bw_max[i] || b <= 0.0001) ? bw_max[i] : b;
+
+    BB = h[i] / (T[i] - e[i] - E[i]);
+    bb = H[i] / (T[i] + E[i] - E[i]);
+    BB = BB <= bb ? bb + DELTA : BB;
+    b = bb <= BB ? (bb + BB) / 2.0 : 0.0;
+    b = (none[i] != 0.0 || E[i] > T[i] - e[i]) ? bw_max[i] : b;
+    bw_iot[i] = (b > bw_max[i] || b <= 0.0001) ? bw_max[i] : b;
+  }
+}
+
+void ControllerBank::handleFlush(const Event & ev) {
+  PROF_SCOPE("ControllerBank::handleFlush", this);
+  calcLA();
+  calcPDNV();
+  calcIB();
+  for (unsigned int i = 0; i < pdnv.pos.size(); ++i)
+    pdnv.ctrl[pdnv.pos[i]]->bw_prev_iot = pdnv.b_bw_iot[i];
+  for (unsigned int i = 0; i < ib.pos.size(); ++i)
+    ib.ctrl[ib.pos[i]]->bw_prev_iot = ib.b_bw_iot[i];
+
+  vector<ResourceManager*> rms;
+  for (unsigned int i = 0; i < pend_tsched.size(); ++i) {
+    double bw = 0.0;
+    switch (pend_kind[i]) {
+    case K_LA:  bw = la.b_bw[pend_idx[i]];  break;
+    case K_PDNV:  bw = pdnv.b_bw[pend_idx[i]];  break;
+    case K_IB:  bw = ib.b_bw[pend_idx[i]];  break;
+    }
+    pend_tsched[i]->completeJobStart(bw, pend_start_err[i]);
+    ResourceManager *p_rm = pend_tsched[i]->getResourceManager();
+    if (find(rms.begin(), rms.end(), p_rm) == rms.end())
+      rms.push_back(p_rm);
+  }
+
+  la.pos.clear();  la.b_eps.clear();
+  pdnv.pos.clear();  pdnv.b_eps.clear();  pdnv.b_h.clear();
+  ib.pos.clear();  ib.b_eps.clear();  ib.b_c_min.clear();  ib.b_c_max.clear();  ib.b_none.clear();
+  pend_tsched.clear();  pend_start_err.clear();  pend_kind.clear();  pend_idx.clear();
+
+  /* New jobs could have caused overload		*/
+  for (unsigned int i = 0; i < rms.size(); ++i)
+    rms[i]->checkGlobalConstraint(ev);
+}
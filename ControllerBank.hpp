@@ -0,0 +1,140 @@
+/*
+ * ARSim
+ * Copyright (c) 2000-2010 Tommaso Cucinotta
+ *
+ * This file is part of ARSim.
+ *
+ * ARSim is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * ARSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with ARSim. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef __ARSIM_CONTROLLER_BANK_HPP__
+#  define __ARSIM_CONTROLLER_BANK_HPP__
+
+#include "Component.hpp"
+#include "Events.hpp"
+
+#include <vector>
+
+using namespace std;
+
+class Controller;
+class LimitedController;
+class PDNVController;
+class InvariantController;
+class TaskScheduler;
+class ResourceManager;
+
+/** Batched computation of the bandwidths of the jobs starting at the same
+ ** time, for populations of homogeneous controllers.
+ **
+ ** When enabled (-cbank), each la, pdnv and ib controller is registered at
+ ** simulation start into the population of its kind, which keeps its
+ ** static parameters in struct-of-arrays form, copied again whenever the
+ ** task recomputes them (see TaskScheduler::calcParams()). A job start of
+ ** a registered task only gathers the per-job inputs (scheduling errors,
+ ** and predicted range where needed) into the batch of its kind, and
+ ** defers the rest of the start to a flush event inserted at the same
+ ** time, after all the events already pending. The flush evaluates each
+ ** batch as one loop over contiguous arrays, completes the starts in their
+ ** original order, then checks the global constraint once per touched
+ ** resource.
+ **
+ ** The computed bandwidths are the same as the scalar ones. However, the
+ ** other events at the same time are now dispatched before the starts are
+ ** completed, so zero-duration intermediate states may differ.
+ **/
+class ControllerBank : public Component {
+  static ControllerBank *p_cb;
+  friend class SimContext;
+
+  bool enabled;
+
+  /** Kinds of controllers supported by the bank	*/
+  enum Kind { K_LA, K_PDNV, K_IB };
+
+  /** Registered controllers: kind and position within its population */
+  vector<Kind> slot_kind;
+  vector<unsigned int> slot_pos;
+  vector<Controller*> slot_ctrl;
+
+  /** LimitedController with calcBandwidthLimitedAsymm() (la)	*/
+  struct LABank {
+    vector<double> period, c_min, c_max, eps_min, eps_max;
+    vector<double> u_min;	/**< 1 / bw_max */
+    /** Batch: population position, gathered parameters, inputs, results */
+    vector<unsigned int> pos;
+    vector<double> b_period, b_c_min, b_c_max, b_eps_min, b_eps_max, b_u_min;
+    vector<double> b_eps, b_bw;
+    vector<double> b_ok;
+  } la;
+
+  /** PDNVController (pdnv)	*/
+  struct PDNVBank {
+    vector<PDNVController*> ctrl;
+    vector<double> period, target_eps, spread, bw_max;
+    vector<unsigned int> pos;
+    vector<double> b_period, b_target_eps, b_bw_max;
+    vector<double> b_eps, b_h, b_bw, b_bw_iot;	/**< b_h: predicted H_k	*/
+  } pdnv;
+
+  /** InvariantController (ib)	*/
+  struct IBBank {
+    vector<InvariantController*> ctrl;
+    vector<double> period, eps_min, eps_max, bw_max;
+    vector<unsigned int> pos;
+    vector<double> b_period, b_eps_min, b_eps_max, b_bw_max;
+    /** b_none is 1.0 if the predicted range [b_c_min, b_c_max] is empty */
+    vector<double> b_eps, b_c_min, b_c_max, b_none, b_bw, b_bw_iot;
+  } ib;
+
+  /** Starts pending for the flush, in the order they were dispatched */
+  vector<TaskScheduler*> pend_tsched;
+  vector<Time> pend_start_err;
+  vector<Kind> pend_kind;
+  vector<unsigned int> pend_idx;	/**< Position within the batch	*/
+
+  void calcLA();
+  void calcPDNV();
+  void calcIB();
+
+public:
+
+  ControllerBank();
+
+  static inline ControllerBank *getInstance() { return p_cb; }
+
+  static void usage();
+  virtual bool parseArg(int& argc, char **& argv);
+
+  bool isEnabled() const { return enabled; }
+
+  /** Register the controller, returning its slot, or -1 if its kind is
+   ** not supported by the bank (it is then used as usual)	*/
+  int addController(Controller *p_ctrl);
+
+  /** Copy again the parameters of the controller at slot, after they
+   ** have been recomputed by its calcParams()			*/
+  void refresh(int slot);
+
+  /** Gather the inputs of a job start of the task at slot, deferring
+   ** its completion to the flush at the current time		*/
+  void enqueue(int slot, TaskScheduler *p_tsched, double sched_err, Time start_err);
+
+  /** Compute the pending batches and complete the deferred starts */
+  void handleFlush(const Event & ev);
+
+  virtual ~ControllerBank() { }
+};
+
+#endif
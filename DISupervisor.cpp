@@ -22,12 +22,14 @@
 #include "DoubleInvariantController.hpp"
 #include "TaskScheduler.hpp"
 #include "ResourceManager.hpp"
+#include "TimelineExporter.hpp"
+#include "Profiler.hpp"
 
 #include <set>
 
 /** Method for retrieving the currently required bandwidth, as well as the quantity defined at step (3) in paper */
-pair<double, double> getBwMin(TaskScheduler *p_sched, set<TaskScheduler *> & S, set<TaskScheduler *> & T) {
-  DoubleInvariantController * p_ctrl = dynamic_cast<DoubleInvariantController *>(p_sched->getController());
+pair<double, double> getBwMin(TaskScheduler *p_sched, DoubleInvariantController *p_ctrl,
+                              set<TaskScheduler *> & S, set<TaskScheduler *> & T) {
   if (S.find(p_sched) == S.end())
     return pair<double, double>(p_sched->getRequiredBandwidth(), p_ctrl->getBwRangeI().getMin());
   else if (T.find(p_sched) == S.end())
@@ -63,12 +65,21 @@ void DISupervisor::updateStats(vector<TaskScheduler*>& tasks, set<TaskScheduler
   }
 }
 
+/** Cast the controllers once, instead of at each loop of each check */
+void DISupervisor::updateControllers(vector<TaskScheduler*>& tasks) {
+  ctrls.clear();
+  for (vector<TaskScheduler*>::iterator it = tasks.begin(); it != tasks.end(); ++it)
+    ctrls.push_back(dynamic_cast<DoubleInvariantController *>((*it)->getController()));
+}
+
 void DISupervisor::checkGlobalConstraint(vector<TaskScheduler*>& tasks) {
-  double bw_sum = 0.0;
+  PROF_SCOPE("Supervisor::checkGlobalConstraint", this);
+  if (ctrls.size() != tasks.size())
+    updateControllers(tasks);
+  const TaskTable & tbl = getTaskTable();
+  double bw_sum = tbl.sumRunningRequired();
   vector<TaskScheduler*>::iterator it;
-  for (it = tasks.begin(); it != tasks.end(); ++it)
-    if ((*it)->isRunning())
-      bw_sum += (*it)->getRequiredBandwidth();
+  countCheck(bw_sum > getSpeed());
   if (bw_sum <= getSpeed()) {
     /* Possibly assign the originally required bandwidth,
      * if a job end (or a job start with a new bandwidth less than
@@ -77,13 +88,15 @@ void DISupervisor::checkGlobalConstraint(vector<TaskScheduler*>& tasks) {
      * 
      * This part corresponds to the step (4) in the paper.
      */
-    for (it = tasks.begin(); it != tasks.end(); it++) {
-      if ((*it)->isRunning())
-        (*it)->changeCurrentBandwidth((*it)->getRequiredBandwidth());
-    }
+    const double *req = tbl.getRequiredBandwidth();
+    for (unsigned int i = 0; i < tbl.size(); ++i)
+      if (tbl.isRunning(i))
+        tasks[i]->changeCurrentBandwidth(req[i]);
   } else {
     /* Apply compression algorithm  */
     Logger::debugLog("# Warning: bw_sum = %g: enforcing global constraint...\n", bw_sum);
+    if (TimelineExporter::getInstance()->isEnabled())
+      TimelineExporter::getInstance()->compression(getResourceId(), bw_sum, getSpeed());
     std::set<TaskScheduler *> S; //< Internal invariant not guaranteed, external unprecised
     std::set<TaskScheduler *> T; //< External invariant not guaranteed (only best effort apps)
 
@@ -91,7 +104,7 @@ void DISupervisor::checkGlobalConstraint(vector<TaskScheduler*>& tasks) {
 
       Logger::debugLog("Set S: ");
       for (set<TaskScheduler *>::iterator sit = S.begin(); sit != S.end(); ++sit) {
-	DoubleInvariantController * p_ctrl = dynamic_cast<DoubleInvariantController *>((*sit)->getController());
+	DoubleInvariantController * p_ctrl = getDIController(*sit);
 	Logger::debugLog("<%g,I:[%g,%g],[%g,%g]> ", (*sit)->getRequiredBandwidth(),
 			 p_ctrl->getBwRangeI().getMin(), p_ctrl->getBwRangeI().getMax(),
 			 p_ctrl->getBwRange().getMin(), p_ctrl->getBwRange().getMax());
@@ -100,7 +113,7 @@ void DISupervisor::checkGlobalConstraint(vector<TaskScheduler*>& tasks) {
 
       Logger::debugLog("Set T: ");
       for (set<TaskScheduler *>::iterator sit = T.begin(); sit != T.end(); ++sit) {
-	DoubleInvariantController * p_ctrl = dynamic_cast<DoubleInvariantController *>((*sit)->getController());
+	DoubleInvariantController * p_ctrl = getDIController(*sit);
 	Logger::debugLog("<%g,I:[%g,%g],[%g,%g]> ", (*sit)->getRequiredBandwidth(),
 			 p_ctrl->getBwRangeI().getMin(), p_ctrl->getBwRangeI().getMax(),
 			 p_ctrl->getBwRange().getMin(), p_ctrl->getBwRange().getMax());
@@ -111,10 +124,10 @@ void DISupervisor::checkGlobalConstraint(vector<TaskScheduler*>& tasks) {
       bw_sum = 0.0;
       for (it = tasks.begin(); it != tasks.end(); ++it) {
         TaskScheduler *p_sched = (*it);
-        DoubleInvariantController *p_ctrl = dynamic_cast<DoubleInvariantController *>(p_sched->getController());
+        DoubleInvariantController *p_ctrl = getDIController(p_sched);
         CHECK(p_ctrl != 0, "Not a double invariant controller with DISupervisor");
         if ((*it)->isRunning()) {
-          pair<double, double> bws = getBwMin(*it, S, T);
+          pair<double, double> bws = getBwMin(*it, p_ctrl, S, T);
           bw_sum += bws.first;
           bw_min_sum += bws.second;
         }
@@ -123,7 +136,7 @@ void DISupervisor::checkGlobalConstraint(vector<TaskScheduler*>& tasks) {
         /** This part corresponds to the step (5) in the paper.     */
         for (it = tasks.begin(); it != tasks.end(); ++it) {
           if ((*it)->isRunning()) {
-            pair<double, double> bws = getBwMin(*it, S, T);
+            pair<double, double> bws = getBwMin(*it, getDIController(*it), S, T);
             double bw_req = bws.first;
             double bw_min = bws.second;
 	    double bw = bw_min + (bw_req - bw_min) / (bw_sum - bw_min_sum) * (getSpeed() - bw_min_sum);
@@ -137,7 +150,7 @@ void DISupervisor::checkGlobalConstraint(vector<TaskScheduler*>& tasks) {
       /** Step (6): search for a task still with internal invariant guaranteed */
       bool found = false;
       for (it = tasks.begin(); it != tasks.end(); ++it) {
-        DoubleInvariantController *p_ctrl = dynamic_cast<DoubleInvariantController *>((*it)->getController());
+        DoubleInvariantController *p_ctrl = getDIController(*it);
         if ((*it)->isRunning() && p_ctrl->isBestEffort() && S.find(*it) == S.end()) {
           S.insert(*it);
           found = true;
@@ -149,7 +162,7 @@ void DISupervisor::checkGlobalConstraint(vector<TaskScheduler*>& tasks) {
 
       /** Step (7): search for a task from the guaranteed set and degrade the invariant (add it to the S set) */
       for (it = tasks.begin(); it != tasks.end(); ++it) {
-        DoubleInvariantController *p_ctrl = dynamic_cast<DoubleInvariantController *>((*it)->getController());
+        DoubleInvariantController *p_ctrl = getDIController(*it);
         if ((*it)->isRunning() && (! p_ctrl->isBestEffort()) && S.find(*it) == S.end()) {
           S.insert(*it);
           found = true;
@@ -161,7 +174,7 @@ void DISupervisor::checkGlobalConstraint(vector<TaskScheduler*>& tasks) {
 
       /** Step (8): search for a task from the best effort set and do not guarantee anything (add it to the T set) */
       for (it = tasks.begin(); it != tasks.end(); ++it) {
-        DoubleInvariantController *p_ctrl = dynamic_cast<DoubleInvariantController *>((*it)->getController());
+        DoubleInvariantController *p_ctrl = getDIController(*it);
         if ((*it)->isRunning() && p_ctrl->isBestEffort() && T.find(*it) == T.end()) {
           T.insert(*it);
           found = true;
@@ -24,6 +24,8 @@
 #include "Supervisor.hpp"
 #include <set>
 
+class DoubleInvariantController;
+
 class DISupervisor : public Supervisor {
 
   vector<TimeStat *> stat_bw_req_granted;
@@ -31,6 +33,13 @@ class DISupervisor : public Supervisor {
   vector<TimeStat *> stat_bw_req_scaled2;
   void updateStats(vector<TaskScheduler*>& tasks, set<TaskScheduler *> & S, set<TaskScheduler *> & T);
 
+  /** Controllers of the tasks, cast once (null if of another type)	*/
+  vector<DoubleInvariantController *> ctrls;
+  void updateControllers(vector<TaskScheduler*>& tasks);
+  DoubleInvariantController *getDIController(TaskScheduler *p_sched) const {
+    return ctrls[p_sched->getTaskPos()];
+  }
+
 public:
 
   void checkGlobalConstraint(vector<TaskScheduler*>& tasks);
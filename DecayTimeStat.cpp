@@ -0,0 +1,77 @@
+/*
+ * ARSim
+ * Copyright (c) 2000-2010 Tommaso Cucinotta
+ *
+ * This file is part of ARSim.
+ *
+ * ARSim is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * ARSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with ARSim. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <math.h>
+
+#include "DecayTimeStat.hpp"
+#include "util.hpp"
+
+DecayTimeStat::DecayTimeStat(double half_life, double now) {
+  CHECK(half_life > 0.0, "Half-life of a DecayTimeStat must be positive");
+  lambda = log(2.0) / half_life;
+  clear(now);
+}
+
+void DecayTimeStat::clear(double now) {
+  w_sum = x_sum = x_sqr_sum = 0.0;
+  prev_x = 0.0;
+  prev_t = now;
+  has_samples = false;
+}
+
+void DecayTimeStat::getSums(double now, double & w, double & xs, double & xss) const {
+  double a = exp(-lambda * (now - prev_t));
+  /* Decayed weight of the interval [prev_t, now]: integral of e^(-lambda s) */
+  double dw = has_samples ? (1.0 - a) / lambda : 0.0;
+  w = w_sum * a + dw;
+  xs = x_sum * a + prev_x * dw;
+  xss = x_sqr_sum * a + prev_x * prev_x * dw;
+}
+
+void DecayTimeStat::addSample(double x, double t) {
+  getSums(t, w_sum, x_sum, x_sqr_sum);
+  prev_x = x;
+  prev_t = t;
+  has_samples = true;
+}
+
+double DecayTimeStat::getMean(double now) const {
+  double w, xs, xss;
+  getSums(now, w, xs, xss);
+  if (w <= 0.0)
+    return prev_x;
+  return xs / w;
+}
+
+double DecayTimeStat::getDev(double now) const {
+  double w, xs, xss;
+  getSums(now, w, xs, xss);
+  if (w <= 0.0)
+    return 0.0;
+  double m = xs / w;
+  double v = xss / w - m * m;
+  return v > 0.0 ? sqrt(v) : 0.0;
+}
+
+double DecayTimeStat::getWeight(double now) const {
+  double w, xs, xss;
+  getSums(now, w, xs, xss);
+  return w;
+}
@@ -0,0 +1,54 @@
+/*
+ * ARSim
+ * Copyright (c) 2000-2010 Tommaso Cucinotta
+ *
+ * This file is part of ARSim.
+ *
+ * ARSim is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * ARSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with ARSim. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef __ARSIM_DECAY_TIME_STAT_HPP__
+#define   __ARSIM_DECAY_TIME_STAT_HPP__
+
+#include "MovingTimeStat.hpp"
+
+/** Exponentially decayed time-weighted mean and variance: the value held
+ ** at time s is weighted by 2^(-(now-s)/half_life), so the samples
+ ** observed half_life time units ago count half as much as current ones.
+ **/
+class DecayTimeStat : public MovingTimeStat {
+  double lambda;	// Decay rate: ln(2) / half_life
+  double w_sum;		// Decayed time weight, up to prev_t
+  double x_sum;		// Decayed time-weighted sum of samples, up to prev_t
+  double x_sqr_sum;	// Decayed time-weighted sum of square samples, up to prev_t
+  double prev_x;	// Last sample
+  double prev_t;	// Time of insertion of last sample
+  bool has_samples;
+
+  /** Sums at time now, accounting for prev_x held since prev_t	*/
+  void getSums(double now, double & w, double & xs, double & xss) const;
+
+ public:
+
+  DecayTimeStat(double half_life, double now = 0.0);
+
+  virtual void addSample(double x, double t);
+  virtual double getMean(double now) const;
+  virtual double getDev(double now) const;
+  virtual double getWeight(double now) const;
+  virtual bool hasSamples() const { return has_samples; }
+  virtual void clear(double now);
+};
+
+#endif
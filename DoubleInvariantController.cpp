@@ -40,7 +40,7 @@ using namespace std;
 #define MAX_O_LEN 10	/* Max length value for outside chain length statistics */
 
 DoubleInvariantController::DoubleInvariantController()
-  : parent(), stat_o_len(0, MAX_O_LEN, 1.0) {
+  : parent() {
 //   setTask(Task::getInstance("p"));
   coeff_pos_i = DEF_P;
   eps_max_i = eps_min_i = UNASSIGNED;
@@ -301,16 +301,16 @@ void DoubleInvariantController::setLastJobExecTime(double c) {
   if (pred_val > 0) {
     double pred_err = (pred_val - c) / getTask()->getPeriod();
     Logger::debugLog("Adding pred error sample: %g\n", pred_err);
-    pe_stat.addSample(pred_err);
+    pe_stat->addSample(pred_err);
   }
   Interval iv = getTaskExpInterval();
   double c_min = iv.getMin();
   double c_max = iv.getMax();
   if (c_min > 0.0 && c_max > c_min) {
   	if (c_min <= c && c <= c_max)
-  	  pr_stat.addSample(1.0);
+  	  pr_stat->addSample(1.0);
   	else
-  	  pr_stat.addSample(0.0);
+  	  pr_stat->addSample(0.0);
   }
 
   getTaskPredictor()->addSample(c);
@@ -24,7 +24,7 @@
 
 #include "InvariantController.hpp"
 #include "Interval.hpp"
-#include "Stat.hpp"
+#include "MeanStat.hpp"
 #include <deque>
 #include <vector>
 
@@ -42,7 +42,7 @@ class DoubleInvariantController : public InvariantController {
 
   int n_eps_i;      /**< Track # of times e(k) is in internal range		*/
   int n_eps_o;      /**< Track # of times e(k) is out of internal range	*/
-  Stat stat_o_len;
+  MeanStat stat_o_len;
   int curr_o_len;	  /**< Calc length of current chain outside internal range	*/
 
   /** Calculate mean of dist_o_len distribution */
@@ -0,0 +1,265 @@
+/*
+ * ARSim
+ * Copyright (c) 2000-2010 Tommaso Cucinotta
+ *
+ * This file is part of ARSim.
+ *
+ * ARSim is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * ARSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with ARSim. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include "DumpedStat.hpp"
+#include "util.hpp"
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+
+DumpedStat::DumpedStat() {
+  dump_as_pmf = false;
+  has_tail = false;
+  mean = dev = 0.0;
+  mean_pos = mean_neg_zero = mean_abs = 0.0;
+  num_samples = 0;
+  weight = weight_pos = 0.0;
+}
+
+/** Split a comma-separated list, trimming blanks */
+void DumpedStat::parseList(const char *s, std::vector<std::string> & items) const {
+  std::string item;
+  for (const char *p = s; ; ++p) {
+    if (*p == ',' || *p == '\0') {
+      size_t b = item.find_first_not_of(" \t");
+      size_t e = item.find_last_not_of(" \t");
+      if (b != std::string::npos)
+        items.push_back(item.substr(b, e - b + 1));
+      item.clear();
+      if (*p == '\0')
+        break;
+    } else {
+      item += *p;
+    }
+  }
+}
+
+bool DumpedStat::load(const char *fname) {
+  FILE *f = fopen(fname, "r");
+  if (f == NULL)
+    return false;
+  char line[4096];
+  /* Header: "# <comment> (PMF)" or "# <comment> (PDF)" */
+  if (fgets(line, sizeof(line), f) == NULL || strncmp(line, "# ", 2) != 0) {
+    fclose(f);
+    return false;
+  }
+  line[strcspn(line, "\n")] = '\0';
+  int len = strlen(line);
+  if (len < 8 || (strcmp(line + len - 5, "(PMF)") != 0 && strcmp(line + len - 5, "(PDF)") != 0)) {
+    fclose(f);
+    return false;
+  }
+  dump_as_pmf = strcmp(line + len - 5, "(PMF)") == 0;
+  comment = std::string(line + 2, len - 8);
+  bool has_weight = false;
+  fields.clear();
+  x_values.clear();
+  pmf.clear();
+  while (fgets(line, sizeof(line), f) != NULL) {
+    line[strcspn(line, "\n")] = '\0';
+    if (line[0] != '#') {
+      double x, p;
+      if (sscanf(line, "%lg %lg", &x, &p) == 2) {
+        x_values.push_back(x);
+        pmf.push_back(p);
+      }
+      continue;
+    }
+    const char *body = line + 1;
+    const char *eq = strchr(body, '=');
+    const char *par = strchr(body, '(');
+    if (eq == NULL) {
+      /* Column names: "# <var_name> Pr" */
+      char name[256];
+      if (sscanf(body, "%255s", name) == 1)
+        var_name = name;
+    } else if (par != NULL && par < eq) {
+      /* "# <Title> (l1, l2, ...) = ( v1 v2 ... )" */
+      std::string title(body, par - body);
+      bool tail = title.find("Tail") != std::string::npos;
+      has_tail = has_tail || tail;
+      const char *par_end = strchr(par, ')');
+      const char *vals = strchr(eq, '(');
+      if (par_end == NULL || vals == NULL)
+        continue;
+      std::vector<std::string> labels;
+      parseList(std::string(par + 1, par_end - par - 1).c_str(), labels);
+      char *p = (char *) vals + 1;
+      for (unsigned int i = 0; i < labels.size(); ++i) {
+        char *end;
+        double v = strtod(p, &end);
+        if (end == p)
+          break;
+        fields.push_back(std::make_pair((tail ? "tail_p" : "p") + labels[i], v));
+        p = end;
+      }
+    } else {
+      /* "# Name = value, Name = value, ..." */
+      std::vector<std::string> items;
+      parseList(body, items);
+      for (unsigned int i = 0; i < items.size(); ++i) {
+        size_t e = items[i].find('=');
+        if (e == std::string::npos)
+          continue;
+        std::string name = items[i].substr(0, e);
+        name = name.substr(0, name.find_last_not_of(" ") + 1);
+        fields.push_back(std::make_pair(name, strtod(items[i].c_str() + e + 1, NULL)));
+      }
+    }
+  }
+  fclose(f);
+
+  for (unsigned int i = 0; i < fields.size(); ++i) {
+    const std::string & name = fields[i].first;
+    double v = fields[i].second;
+    if (name == "Min")
+      min_val = v;
+    else if (name == "Max")
+      max_val = v;
+    else if (name == "Mean")
+      mean = v;
+    else if (name == "SDev")
+      dev = v;
+    else if (name == "MeanPos")
+      mean_pos = v;
+    else if (name == "MeanNegZero")
+      mean_neg_zero = v;
+    else if (name == "MeanAbs")
+      mean_abs = v;
+    else if (name == "Samples")
+      num_samples = long(v);
+    else if (name == "Weight") {
+      weight = v;
+      has_weight = true;
+    } else if (name == "WeightPos")
+      weight_pos = v;
+  }
+  if (!dump_as_pmf)
+    for (unsigned int n = 0; n < pmf.size(); ++n)
+      pmf[n] *= getDX();
+  if (!has_weight) {
+    weight = 1.0;
+    weight_pos = 0.0;
+    for (unsigned int n = 0; n < pmf.size(); ++n)
+      if (x_values[n] > 0.0)
+        weight_pos += pmf[n];
+  }
+  return true;
+}
+
+double DumpedStat::getCDF(double x) const {
+  double dx = getDX();
+  double cdf = 0.0;
+  for (unsigned int n = 0; n < pmf.size(); ++n) {
+    if (x >= x_values[n] + dx)
+      cdf += pmf[n];
+    else if (x > x_values[n])
+      cdf += pmf[n] * (x - x_values[n]) / dx;
+  }
+  return cdf;
+}
+
+double DumpedStat::calcPMFMean() const {
+  double sum = 0.0;
+  for (unsigned int n = 0; n < pmf.size(); ++n)
+    sum += pmf[n] * x_values[n];
+  return sum;
+}
+
+double DumpedStat::getPDFValue(double x) const {
+  if (pmf.empty() || x < x_values[0])
+    return 0.0;
+  unsigned long n = (unsigned long) ((x - x_values[0]) / getDX());
+  return n < pmf.size() ? pmf[n] / getDX() : 0.0;
+}
+
+double DumpedStat::sumPMFValues() const {
+  double sum = 0.0;
+  for (unsigned int n = 0; n < pmf.size(); ++n)
+    sum += pmf[n];
+  return sum;
+}
+
+void DumpedStat::dumpSummary(FILE *file) const {
+  if (has_tail)
+    fprintf(file, "# Tail percentiles (99, 99.9, 99.99) = ( %g %g %g )\n",
+            getPMFPercentile(0.99), getPMFPercentile(0.999), getPMFPercentile(0.9999));
+}
+
+/** Weighted mean of a and b, ignoring terms with no weight (and maybe NaN) */
+static double wmean(double a, double wa, double b, double wb) {
+  if (wa <= 0.0)
+    return b;
+  if (wb <= 0.0)
+    return a;
+  return (a * wa + b * wb) / (wa + wb);
+}
+
+void DumpedStat::merge(const BaseStat & s) {
+  const DumpedStat *p_s = dynamic_cast<const DumpedStat *>(&s);
+  CHECK(p_s != 0, "Merging statistics of different types");
+  const DumpedStat & d = *p_s;
+  if (d.weight <= 0.0)
+    return;
+  if (weight <= 0.0) {
+    *this = d;
+    return;
+  }
+  double w = weight + d.weight;
+
+  if (x_values == d.x_values) {
+    for (unsigned int n = 0; n < pmf.size(); ++n)
+      pmf[n] = (pmf[n] * weight + d.pmf[n] * d.weight) / w;
+  } else {
+    /* Resample both PMFs over the union of the ranges */
+    double lo = std::min(x_values.empty() ? d.x_values[0] : x_values[0],
+                         d.x_values.empty() ? x_values[0] : d.x_values[0]);
+    double hi = -MAXDOUBLE;
+    if (!x_values.empty())
+      hi = x_values.back() + getDX();
+    if (!d.x_values.empty())
+      hi = std::max(hi, d.x_values.back() + d.getDX());
+    long size = std::max(x_values.size(), d.x_values.size());
+    double dx = (hi - lo) / size;
+    std::vector<double> new_x(size), new_pmf(size);
+    for (long n = 0; n < size; ++n) {
+      double a = lo + dx * n, b = lo + dx * (n + 1);
+      new_x[n] = a;
+      new_pmf[n] = ((getCDF(b) - getCDF(a)) * weight + (d.getCDF(b) - d.getCDF(a)) * d.weight) / w;
+    }
+    x_values = new_x;
+    pmf = new_pmf;
+  }
+
+  double e2 = ((dev * dev + mean * mean) * weight + (d.dev * d.dev + d.mean * d.mean) * d.weight) / w;
+  mean = (mean * weight + d.mean * d.weight) / w;
+  dev = sqrt(std::max(0.0, e2 - mean * mean));
+  mean_abs = (mean_abs * weight + d.mean_abs * d.weight) / w;
+  mean_pos = wmean(mean_pos, weight_pos, d.mean_pos, d.weight_pos);
+  mean_neg_zero = wmean(mean_neg_zero, weight - weight_pos, d.mean_neg_zero, d.weight - d.weight_pos);
+  num_samples += d.num_samples;
+  weight = w;
+  weight_pos += d.weight_pos;
+  has_tail = has_tail || d.has_tail;
+  mergeMinMax(d);
+}
@@ -0,0 +1,91 @@
+/*
+ * ARSim
+ * Copyright (c) 2000-2010 Tommaso Cucinotta
+ *
+ * This file is part of ARSim.
+ *
+ * ARSim is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * ARSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with ARSim. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef __ARSIM_DUMPED_STAT_HPP__
+#define   __ARSIM_DUMPED_STAT_HPP__
+
+#include "BaseStat.hpp"
+
+#include <string>
+#include <vector>
+#include <utility>
+
+/** Statistic loaded back from a stats file written by BaseStat::dumpStat(),
+ ** so that the results of separate runs may be merged and dumped again.
+ **
+ ** The summary values and the PMF are the ones in the file, whose
+ ** "Samples" line provides the weights for merging. Files lacking that
+ ** line (older versions) are given unit weight. Merged PMFs are summed
+ ** bin by bin if the intervals are the same, otherwise they are resampled
+ ** over the union of the ranges, assuming a uniform PDF within each bin.
+ **/
+class DumpedStat : public BaseStat {
+  std::string comment;
+  std::string var_name;
+  bool dump_as_pmf;
+  bool has_tail;	// Whether the file reported tail percentiles
+  double mean, dev;
+  double mean_pos, mean_neg_zero, mean_abs;
+  long num_samples;
+  double weight, weight_pos;
+  std::vector<double> x_values;
+  std::vector<double> pmf;
+  /** Summary fields, as reported in the file, in order of appearance */
+  std::vector< std::pair<std::string, double> > fields;
+
+  void parseList(const char *s, std::vector<std::string> & items) const;
+  /** CDF at x, linear within each interval			*/
+  double getCDF(double x) const;
+  double getDX() const { return x_values.size() > 1 ? x_values[1] - x_values[0] : 1.0; }
+
+ public:
+
+  typedef BaseStat parent;
+
+  DumpedStat();
+
+  /** Load a stats file, returning false if it is not one		*/
+  bool load(const char *fname);
+  /** Write the statistic to fname, in the format it was loaded from	*/
+  void dump(const char *fname) { dumpStat(fname, var_name.c_str(), dump_as_pmf, comment.c_str()); }
+  /** Summary fields (Min, Mean, ..., percentiles) as in the file	*/
+  const std::vector< std::pair<std::string, double> > & getFields() const { return fields; }
+
+  virtual long getNumSamples() const { return num_samples; }
+  virtual double getWeight() const { return weight; }
+  virtual double getWeightPos() const { return weight_pos; }
+  double calcPMFMean() const;
+  double getMean() const { return mean; }
+  double getMeanPos() const { return mean_pos; }
+  double getMeanNegZero() const { return mean_neg_zero; }
+  double getDev() const { return dev; }
+  double getMeanAbs() const { return mean_abs; }
+  double getPDFValue(double x) const;
+  double getPMFValue(long n_sample) const { return pmf[n_sample]; }
+  double sumPMFValues() const;
+  long getPMFSize() const { return pmf.size(); }
+  double getXValue(long n_sample) const { return x_values[n_sample]; }
+  virtual void dumpSummary(FILE *file) const;
+
+  /** Add the samples of s, another DumpedStat			*/
+  virtual void merge(const BaseStat & s);
+};
+
+#endif
@@ -21,13 +21,24 @@
 #include "Events.hpp"
 
 #include "util.hpp"
+#include "Profiler.hpp"
 
-EventList::EventList() : v_events(), curr_time(0.0) {  }
+EventList *EventList::p_events = 0;
+
+EventList::EventList() : v_events(), curr_time(0.0), num_dispatched(0) {  }
+
+EventList::~EventList() {
+  for (list<Event*>::iterator it = v_events.begin(); it != v_events.end(); ++it)
+    delete *it;
+}
 
 /// Singleton pattern and enforcement of correct static initialization order.
+/// The list is built on first use, and switched by SimContext when several
+/// simulations are hosted within the same process.
 EventList & EventList::events() {
-  static EventList event_list;
-  return event_list;
+  if (p_events == 0)
+    p_events = new EventList();
+  return *p_events;
 }
 
 void EventList::insert(Event *p_ev) {
@@ -64,8 +75,9 @@ void EventList::step() {
   curr_time += p_ev->delta_time;
   /* Dispatch all simultaneous events, if any   */
   do {
-    Logger::debugLog("# T=%g: extracted event with dt=%g\n", curr_time, p_ev->delta_time);
+    Logger::debugLogC(Logger::LOG_EVENTS, 2, "# T=%g: extracted event with dt=%g\n", curr_time, p_ev->delta_time);
     events().dispatch();
     p_ev = events().getNextEvent();
   } while ((p_ev != 0) && (p_ev->delta_time == 0));
+  PROF_QUEUE(events().v_events.size());
 }
@@ -70,11 +70,15 @@ Event *makeEvent(Time delta_time,
   return new EventT<T>(delta_time, p_handler, p_method, p_data);
 }
 
+class SimContext;
+
 /** The next events to be managed       **/
 class EventList {
 private:
+  static EventList *p_events;   /**< Current event list (see SimContext) */
   list<Event*> v_events;
   Time curr_time;        /**< Current time (ms)          */
+  unsigned long num_dispatched; /**< Number of dispatched events */
   Event *getNextEvent() {
     if (v_events.empty())
       return 0;
@@ -84,6 +88,8 @@ private:
 public:
 
   EventList();
+  /** Delete all the pending events                     **/
+  ~EventList();
 
   /** Insert a new event into the event list            **/
   void insert(Event *p_ev);
@@ -93,12 +99,20 @@ public:
   void dispatch() {
     Event *p_ev = *(v_events.begin());
     v_events.pop_front();
+    num_dispatched++;
     p_ev->dispatch();
     delete p_ev;
   }
   // Singleton pattern and enforcement of correct static construction order.
   static EventList & events();
   static Time getTime() { return events().curr_time; }
+  /** Number of events dispatched since the simulation start       **/
+  unsigned long getNumDispatched() const { return num_dispatched; }
+  /** Time of the next event, or a negative value if there is none **/
+  Time getNextTime() {
+    Event *p_ev = getNextEvent();
+    return p_ev == 0 ? -1.0 : curr_time + p_ev->delta_time;
+  }
 
   /** Perform an event-based simulation step
    **
@@ -106,6 +120,8 @@ public:
    ** the dispatch of all the events occurring at the same new time
    **/
   void step();
+
+  friend class SimContext;
 };
 
 #endif
@@ -20,6 +20,8 @@
 
 #include <cstring>
 #include "FairSupervisor.hpp"
+#include "TimelineExporter.hpp"
+#include "Profiler.hpp"
 
 FairSupervisor::FairSupervisor() {
   soft = false;
@@ -41,49 +43,47 @@ bool FairSupervisor::parseArg(int& argc, char **& argv) {
 }
 
 void FairSupervisor::checkGlobalConstraint(vector<TaskScheduler*>& tasks) {
+  PROF_SCOPE("Supervisor::checkGlobalConstraint", this);
+  const TaskTable & tbl = getTaskTable();
+  const double *run = tbl.getRunning();
+  const double *req = tbl.getRequiredBandwidth();
+  const double *min = tbl.getMinBandwidth();
+  const double *wgt = tbl.getWeight();
+  unsigned int n = tbl.size();
   double bw_req_sum = 0.0;	// Sum of required values
   double bw_req_wsum = 0.0;	// Sum of weighted required values
   double bw_min_sum = 0.0;      // Sum of configured minimum guaranteed values
   double bw_gua_sum = 0.0;	// Sum of actual guaranteed values
   double bw_gua_wsum = 0.0;	// Sum of weighted guaranteed values
   double weight_sum = 0.0;	// Sum of weights
-  vector<TaskScheduler*>::iterator it = tasks.begin();
-  for (; it != tasks.end(); ++it) {
-    double bw_req;
-    if ((*it)->isRunning())
-      bw_req = (*it)->getRequiredBandwidth();
-    else
-      bw_req = 0.0;
+  for (unsigned int i = 0; i < n; ++i) {
+    double bw_req = run[i] * req[i];
     bw_req_sum += bw_req;
-
-    double bw_min = (*it)->getController()->getMinBandwidth();
-    bw_min_sum += bw_min;
-    double bw_gua = std::min(bw_req, bw_min);
+    bw_min_sum += min[i];
+    double bw_gua = std::min(bw_req, min[i]);
     bw_gua_sum += bw_gua;
-    double weight = (*it)->getWeight();
-    weight_sum += weight;
-    bw_req_wsum += weight * bw_req;
-    bw_gua_wsum += weight * bw_gua;
+    weight_sum += wgt[i];
+    bw_req_wsum += wgt[i] * bw_req;
+    bw_gua_wsum += wgt[i] * bw_gua;
   }
-  Logger::debugLog("bw_req_sum=%g, bw_gua_sum=%g, bw_min_sum=%g, speed=%g\n", bw_req_sum, bw_gua_sum, bw_min_sum, getSpeed());
+  Logger::debugLogC(Logger::LOG_SUPERVISOR, 2, "bw_req_sum=%g, bw_gua_sum=%g, bw_min_sum=%g, speed=%g\n", bw_req_sum, bw_gua_sum, bw_min_sum, getSpeed());
+  countCheck(bw_req_sum > getSpeed());
   if (bw_req_sum > getSpeed()) {
     /* Apply compression algorithm	*/
-    Logger::debugLog("# Warning: bw_sum = %g: enforcing global constraint...\n", bw_req_sum);
+    Logger::debugLogC(Logger::LOG_SUPERVISOR, 1, "# Warning: bw_sum = %g: enforcing global constraint...\n", bw_req_sum);
+    if (TimelineExporter::getInstance()->isEnabled())
+      TimelineExporter::getInstance()->compression(getResourceId(), bw_req_sum, getSpeed());
     // Use some tolerance in this assertion check
     ASSERT(bw_req_sum + 0.0001 >= bw_gua_sum, "Sum of requests below minimum guarantees but resource speed is not enough !");
     // Total available bandwidth after assigning minimum guarantees
     double bw_avail = getSpeed() - bw_gua_sum;
     // Use some tolerance in this assertion check
     ASSERT(bw_avail + 0.0001 >= 0, "Sum of minimum guarantees exceeding resource speed !");
-    for (it = tasks.begin(); it != tasks.end(); ++it)
-      if ((*it)->isRunning()) {
-        TaskScheduler * p_sched = *it;
-        double bw_req = p_sched->getRequiredBandwidth();
-        double bw_min = p_sched->getController()->getMinBandwidth();
-        double bw_gua = std::min(bw_req, bw_min);
-	double weight = p_sched->getWeight();
-        p_sched->changeCurrentBandwidth(
-            bw_gua + bw_avail * weight * (bw_req - bw_gua) / (bw_req_wsum - bw_gua_wsum)
+    for (unsigned int i = 0; i < n; ++i)
+      if (tbl.isRunning(i)) {
+        double bw_gua = std::min(req[i], min[i]);
+        tasks[i]->changeCurrentBandwidth(
+            bw_gua + bw_avail * wgt[i] * (req[i] - bw_gua) / (bw_req_wsum - bw_gua_wsum)
         );
       }
   } else {
@@ -93,20 +93,16 @@ void FairSupervisor::checkGlobalConstraint(vector<TaskScheduler*>& tasks) {
        * the previously requested one) caused an overload condition
        * to end
        */
-      for (it = tasks.begin(); it != tasks.end(); ++it)
-	if ((*it)->isRunning())
-	  (*it)->changeCurrentBandwidth((*it)->getRequiredBandwidth());
+      for (unsigned int i = 0; i < n; ++i)
+	if (tbl.isRunning(i))
+	  tasks[i]->changeCurrentBandwidth(req[i]);
     } else {
       double bw_avail = getSpeed() - bw_req_sum;
-      for (it = tasks.begin(); it != tasks.end(); ++it)
-	if ((*it)->isRunning()) {
-	  TaskScheduler * p_sched = *it;
-	  double bw_req = p_sched->getRequiredBandwidth();
-	  double weight = p_sched->getWeight();
-	  p_sched->changeCurrentBandwidth(
-		bw_req + bw_avail * weight / weight_sum
+      for (unsigned int i = 0; i < n; ++i)
+	if (tbl.isRunning(i))
+	  tasks[i]->changeCurrentBandwidth(
+		req[i] + bw_avail * wgt[i] / weight_sum
 	  );
-	}
     }
   }
 }
@@ -21,6 +21,7 @@
 #include <cstring>
 #include "FileUtil.hpp"
 #include "util.hpp"
+#include "TraceReader.hpp"
 
 #include <iostream>
 #include <sstream>
@@ -31,63 +32,9 @@
  ** Returns the number of correctly read lines.
  **/
 long loadTrace(std::vector<double> & samples, const char * trace_fname, long disc_lines, int col_number, double mul_factor) {
-  FILE *ff;
   printf("# Loading column %d of trace file '%s' scaled by %g, discarding %ld lines\n", col_number, trace_fname, mul_factor, disc_lines);
-  ff = fopen(trace_fname, "r");
-  ASSERT(ff != 0, "Couldn't find task trace file");
-
-  char line_buf[256];
-  long int line_num = 0;
-  for (int i = 0; i < disc_lines && ! feof(ff); ++i) {
-    if (fgets(line_buf, sizeof(line_buf), ff) == NULL)
-      continue;
-    ++line_num;
-  }
-
-  while (! feof(ff)) {
-    double sample;
-    if (fgets(line_buf, sizeof(line_buf), ff) == NULL)
-      continue;
-    ++line_num;
-    if (strlen(line_buf) == 0) {
-      fprintf(stderr, "Warning: skipping empty line %ld\n", line_num);
-      continue;
-    }
-    while (strlen(line_buf) > 0
-        && (line_buf[strlen(line_buf) - 1] == 0x0A || line_buf[strlen(line_buf) - 1] == 0x0D))
-              line_buf[strlen(line_buf) - 1] = '\0';
-    Logger::debugLog("Scanning line %ld: '%s'\n", line_num, line_buf);
-    if (strlen(line_buf) > 0 && line_buf[0] == '#') {
-      Logger::debugLog("Warning: skipping commented line %ld: '%s'\n", line_num, line_buf);
-      continue;
-    }
-    std::istringstream iss(line_buf);
-    bool sample_valid = true;
-    std::string sample_string;
-    for (int i = 0; i < col_number - 1; ++i) {
-      if (iss.eof()) {
-        sample_valid = false;
-        break;
-      } else
-        iss >> sample_string;
-    }
-    if (sample_valid) {
-      if (iss.eof())
-        sample_valid = false;
-      else
-        iss >> sample_string;
-      if (sample_valid && sscanf(sample_string.c_str(), "%lf", &sample) != 1)
-        sample_valid = false;
-    }
-    if (sample_valid) {
-      double actual_sample = sample * mul_factor;
-      //Logger::debugLog("Adding sample %g reworked as %g\n", sample, actual_sample);
-      samples.push_back(actual_sample);
-    } else {
-      fprintf(stderr, "Warning: skipping line %ld '%s': column %d not numeric\n", line_num, line_buf, col_number);
-    }
-  }
-  fclose(ff);
+  TraceReader reader(trace_fname);
+  reader.readColumn(samples, disc_lines, col_number, mul_factor);
   printf("# Loaded %d samples\n", (int) samples.size());
   return samples.size();
 }
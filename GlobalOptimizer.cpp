@@ -29,6 +29,9 @@
 #include "qos_opt_glpk.h"
 #include "qos_opt_heur.h"
 #include "defaults.hpp"
+#include "TimelineExporter.hpp"
+#include "Profiler.hpp"
+#include "StatFactory.hpp"
 
 GlobalOptimizer *GlobalOptimizer::p_gc = new GlobalOptimizer();
 
@@ -36,6 +39,7 @@ GlobalOptimizer *GlobalOptimizer::p_gc = new GlobalOptimizer();
 GlobalOptimizer::GlobalOptimizer()
  : obj_val_stat(0.0, 400.0, 1.0), perf_index_stat(0.0, 400.0, 1.0) {
   opt_type = "glpk";
+  bw_avg_type = "epoch";
   p_opt = NULL;
   na=0;
   nam=0;
@@ -45,6 +49,8 @@ GlobalOptimizer::GlobalOptimizer()
   opt_period = 0;
   p_opt_ev = NULL;
   gc_file = NULL;
+  num_solves = 0;
+  solve_time_last = solve_time_sum = solve_time_max = 0.0;
 }
 
 void GlobalOptimizer::dumpStatistics() {
@@ -85,9 +91,12 @@ void GlobalOptimizer::dumpStatistics() {
 }
 
 GlobalOptimizer::~GlobalOptimizer() {
-  if (p_opt_ev != NULL)
-    EventList::events().remove(p_opt_ev);
-  fclose(gc_file);
+  if (p_opt_ev != NULL && EventList::events().remove(p_opt_ev))
+    delete p_opt_ev;
+  if (gc_file != NULL)
+    fclose(gc_file);
+  if (p_opt != NULL)
+    qos_opt_destroy(p_opt);
 }
 
 void GlobalOptimizer::usage() {
@@ -104,6 +113,11 @@ void GlobalOptimizer::usage() {
   printf("           -gc-p    period: set optimization period (and start periodic optimization)\n");
   printf("           -gc-max-pow power: set maximum allowed power (unimplemented yet)\n");
   printf("           -gc-it-lim num: set maximum number of iterations per optimization step\n");
+  printf("           -gc-bw-avg type: estimate of the required bandwidth fed to the optimizer:\n");
+  printf("                    epoch                  average since the last optimization (default)\n");
+  printf("                    decay[:half_life]      exponentially decayed average (default: -gc-p, or task, period)\n");
+  printf("                    window[:len[,buckets]] sliding window average (default: -gc-p, or task, period, %d buckets)\n",
+         DEF_WINDOW_BUCKETS);
   printf("           -mmp:    Activate Multi-Mode Predictor (disabled by default)\n");
 }
 
@@ -119,43 +133,7 @@ bool GlobalOptimizer::parseArg(int& argc, char **& argv) {
     CHECK(argc > 1, "Option requires an argument");
     argv++;  argc--;
     CHECK(sscanf(*argv, "%d,%d,%d,%d", &na, &nam, &nr, &nrm) == 4, "Expecting 4 comma-separated naturals as argument to -gc-nums option");
-    Logger::debugLog("na=%d, nam=%d, nr=%d, nrm=%d\n", na, nam, nr, nrm);
-    if (strcmp(opt_type, "glpk") == 0)
-      p_opt = qos_opt_glpk_create(na, nam, nr, nrm);
-    else if (strcmp(opt_type, "heur") == 0)
-      p_opt = qos_opt_heur_create(na, nam, nr, nrm);
-    else
-      CHECK(0, "Invalid global controller type supplied to -gc-type option");
-
-    CHECK(p_opt != NULL, "Invalid numbers supplied to -gc-nums or not enough memory");
-    /* Setting default flat params */
-    for (app = 0; app < na; ++app) {
-      for (app_mode = 0; app_mode < nam; ++app_mode)
-        // Default QoS Level for app_mode = 100 - app_mode
-	qos_opt_set_qos_level(p_opt, app, app_mode, 100 - app_mode*10);
-      // Default application weight = 1
-      qos_opt_set_qos_gain(p_opt, app, 1);
-      for (int am1 = 0; am1 < nam; ++am1)
-        for (int am2 = 0; am2 < nam; ++am2)
-          // Default QoS variation penalty = 0
-          if (am1 != am2)
-            qos_opt_set_qos_var_penalty(p_opt, app, am1, am2, 0);
-      // Default application mode = 0 (first mode, maximum QoS)
-      qos_opt_set_app_mode(p_opt, app, 0);
-    }
-    for (res = 0; res < nr; ++res) {
-      for (res_mode = 0; res_mode < nrm; ++res_mode)
-        // Default power level for res_mode = 100 - res_mode
-	qos_opt_set_pow_level(p_opt, res, res_mode, 100 - res_mode*80);
-      // Default weight for power consumption in objective function = 1
-      qos_opt_set_pow_penalty(p_opt, res, 1);
-    }
-    for (app = 0; app < na; ++app)
-      for (app_mode = 0; app_mode < nam; ++app_mode)
-	for (res = 0; res < nr; ++res)
-	  for (res_mode = 0; res_mode < nrm; ++res_mode)
-	    // Default workload for each application and resource mode = 1/na
-	    qos_opt_set_load(p_opt, app, app_mode, res, res_mode, 1.0 / na);
+    setNums(na, nam, nr, nrm);
   } else if (strcmp(*argv, "-gc-ql") == 0) {
     CHECK(argc > 1, "Option requires an argument");
     argv++;  argc--;
@@ -205,6 +183,12 @@ bool GlobalOptimizer::parseArg(int& argc, char **& argv) {
     argv++;  argc--;
     CHECK(sscanf(*argv, "%lu", &it_limit) == 1, "Expecting integer as argument to -gc-it-lim option");
     CHECK(qos_opt_set_it_limit(p_opt, it_limit) == 0, "Global optimizer does not support iteration limit");
+  } else if (strcmp(*argv, "-gc-bw-avg") == 0) {
+    CHECK(argc > 1, "Option requires an argument");
+    argv++;  argc--;
+    CHECK(strcmp(*argv, "epoch") == 0 || StatFactory::isValidMoving(*argv),
+          "Wrong type specification for -gc-bw-avg option");
+    bw_avg_type = *argv;
   } else if (strcmp(*argv, "-gc-max-pow") == 0) {
     CHECK(argc > 1, "Option requires an argument");
     argv++;  argc--;
@@ -219,6 +203,52 @@ bool GlobalOptimizer::parseArg(int& argc, char **& argv) {
   return true;
 }
 
+/** Create the optimization problem with the supplied sizes and flat default params */
+void GlobalOptimizer::setNums(int num_apps, int num_app_modes, int num_res, int num_res_modes) {
+  int app, app_mode, res, res_mode;
+  na = num_apps;
+  nam = num_app_modes;
+  nr = num_res;
+  nrm = num_res_modes;
+  Logger::debugLog("na=%d, nam=%d, nr=%d, nrm=%d\n", na, nam, nr, nrm);
+  if (strcmp(opt_type, "glpk") == 0)
+    p_opt = qos_opt_glpk_create(na, nam, nr, nrm);
+  else if (strcmp(opt_type, "heur") == 0)
+    p_opt = qos_opt_heur_create(na, nam, nr, nrm);
+  else
+    CHECK(0, "Invalid global controller type supplied to -gc-type option");
+
+  CHECK(p_opt != NULL, "Invalid numbers supplied to -gc-nums or not enough memory");
+  /* Setting default flat params */
+  for (app = 0; app < na; ++app) {
+    for (app_mode = 0; app_mode < nam; ++app_mode)
+      // Default QoS Level for app_mode = 100 - app_mode
+      qos_opt_set_qos_level(p_opt, app, app_mode, 100 - app_mode*10);
+    // Default application weight = 1
+    qos_opt_set_qos_gain(p_opt, app, 1);
+    for (int am1 = 0; am1 < nam; ++am1)
+      for (int am2 = 0; am2 < nam; ++am2)
+        // Default QoS variation penalty = 0
+        if (am1 != am2)
+          qos_opt_set_qos_var_penalty(p_opt, app, am1, am2, 0);
+    // Default application mode = 0 (first mode, maximum QoS)
+    qos_opt_set_app_mode(p_opt, app, 0);
+  }
+  for (res = 0; res < nr; ++res) {
+    for (res_mode = 0; res_mode < nrm; ++res_mode)
+      // Default power level for res_mode = 100 - res_mode
+      qos_opt_set_pow_level(p_opt, res, res_mode, 100 - res_mode*80);
+    // Default weight for power consumption in objective function = 1
+    qos_opt_set_pow_penalty(p_opt, res, 1);
+  }
+  for (app = 0; app < na; ++app)
+    for (app_mode = 0; app_mode < nam; ++app_mode)
+      for (res = 0; res < nr; ++res)
+        for (res_mode = 0; res_mode < nrm; ++res_mode)
+          // Default workload for each application and resource mode = 1/na
+          qos_opt_set_load(p_opt, app, app_mode, res, res_mode, 1.0 / na);
+}
+
 bool GlobalOptimizer::checkParams() {
   CHECK(p_opt != NULL, "Need to provide -gc-nums");
   Logger::debugLog("Solving optimization problem\n");
@@ -241,6 +271,7 @@ bool GlobalOptimizer::checkParams() {
 }
 
 void GlobalOptimizer::optimize() {
+  PROF_SCOPE("GlobalOptimizer::optimize", 0);
   if (gc_file == NULL) {
     gc_file = fopen("gc.dat", "w");
     CHECK(gc_file != NULL, "Could not open file gc.dat");
@@ -324,7 +355,17 @@ void GlobalOptimizer::optimize() {
   // Run the optimization engine
   Logger::debugLog("Optimizing...\n");
   bool solved = true;
-  if (! qos_opt_solve(p_opt)) {
+  double t_solve = getWallClock();
+  int rv;
+  {
+    PROF_SCOPE("qos_opt_solve", 0);
+    rv = qos_opt_solve(p_opt);
+  }
+  solve_time_last = getWallClock() - t_solve;
+  solve_time_sum += solve_time_last;
+  solve_time_max = MAX(solve_time_max, solve_time_last);
+  num_solves++;
+  if (! rv) {
     solved = false;
     Logger::debugLog("...PROBLEM NOT SOLVED\n");
     // First (best) resource mode for every resource
@@ -363,7 +404,7 @@ void GlobalOptimizer::optimize() {
       if (solved) {
         Logger::debugLog("Setting app %d to app_mode %d (on res %d res_mode %d) and gua_bw %g (est_load was %g)\n",
             app, new_app_mode, res, res_mode, est_bw, est_load);
-        p_sched->getController()->setMinBandwidth(est_bw);
+        p_sched->setMinBandwidth(est_bw);
       } else {
         /* Problem was unfeasible: reuse latest minimum bw assignments */
         Logger::debugLog("Setting app %d to app_mode %d (on res %d res_mode %d) but gua_bw untouched (est_load was %g)\n",
@@ -374,12 +415,16 @@ void GlobalOptimizer::optimize() {
       task->setAppMode(new_app_mode);
       if (app_mode_changed)
         p_sched->clearHistory();
+      if (TimelineExporter::getInstance()->isEnabled())
+        TimelineExporter::getInstance()->appMode(app, res, new_app_mode);
       fprintf(gc_file, "%11d", new_app_mode);
     }
     Logger::debugLog("Setting res %d to power mode %d\n", res, res_mode);
     // At this time, I already changed the minimum bandwidths according to
     // latest required measurements, so the assert in setSpeed() cannot fail
     p->setPowerMode(res_mode);
+    if (TimelineExporter::getInstance()->isEnabled())
+      TimelineExporter::getInstance()->resourceMode(res, res_mode);
   }
   double obj_val = 0.0;
   rs_it = ResourceManager::rs_controllers.begin();
@@ -406,6 +451,8 @@ void GlobalOptimizer::optimize() {
     Logger::debugLog("obj_val: %g (recomputed as %g, diff %g)\n", qos_opt_get_obj_value(p_opt), obj_val, qos_opt_get_obj_value(p_opt) - obj_val);
   obj_val_stat.addSample(obj_val);
   fprintf(gc_file, " %10g", obj_val);
+  if (TimelineExporter::getInstance()->isEnabled())
+    TimelineExporter::getInstance()->optimization(solved, obj_val);
 
   double pdnv_sum = 0.0;
   rs_it = ResourceManager::rs_controllers.begin();
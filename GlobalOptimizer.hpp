@@ -35,15 +35,21 @@
  **/
 class GlobalOptimizer : public Component {
   const char * opt_type;
+  const char * bw_avg_type; //< Required bandwidth estimate: epoch, or a moving one (see StatFactory)
   qos_opt *p_opt;
   int na, nam, nr, nrm;
   int use_mmp;
   static GlobalOptimizer *p_gc;
+  friend class SimContext;
   Event *p_opt_ev;
   long unsigned opt_period; //< If different from zero, then enable global optimization
   FILE *gc_file;
   Stat obj_val_stat;
   Stat perf_index_stat;
+  unsigned long num_solves;     //< Number of qos_opt_solve() invocations
+  double solve_time_last;       //< Wall-clock duration of the last solve (s)
+  double solve_time_sum;        //< Total wall-clock time spent solving (s)
+  double solve_time_max;        //< Maximum wall-clock duration of a solve (s)
 
 public:
 
@@ -58,9 +64,19 @@ public:
   /** Optimize globally the system QoS by reconfiguring application modes,
    ** resource power modes and minimum guaranteed bandwidths                    **/
   void optimize();
+  /** Create the optimization problem, as done by -gc-nums		*/
+  void setNums(int num_apps, int num_app_modes, int num_res, int num_res_modes);
+  bool hasNums() const { return p_opt != NULL; }
   void handleUpdateBandEvent(const Event & ev);
   virtual ~GlobalOptimizer();
   double getOptPeriod() const { return opt_period; }
+  /** Return "epoch" if the required bandwidth averages are reset at each
+   ** optimization, or the moving-horizon type specification to use	*/
+  const char *getBwAvgType() const { return bw_avg_type; }
+  unsigned long getNumSolves() const { return num_solves; }
+  double getLastSolveTime() const { return solve_time_last; }
+  double getAvgSolveTime() const { return num_solves == 0 ? 0.0 : solve_time_sum / num_solves; }
+  double getMaxSolveTime() const { return solve_time_max; }
 };
 
 #endif
@@ -0,0 +1,145 @@
+/*
+ * ARSim
+ * Copyright (c) 2000-2010 Tommaso Cucinotta
+ *
+ * This file is part of ARSim.
+ *
+ * ARSim is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * ARSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with ARSim. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include "HdrStat.hpp"
+#include "util.hpp"
+
+#include <math.h>
+
+/** Largest quantized magnitude: larger ones are saturated	*/
+#define HDR_MAX_VALUE (INT64_C(1) << 62)
+
+HdrStat::HdrStat(double unit, int digits, bool time_weighted, double now, long pmf_size)
+  : QuantileStat(time_weighted, now, pmf_size) {
+  CHECK(unit > 0.0, "HdrStat unit must be positive");
+  CHECK(digits >= 1 && digits <= 5, "HdrStat significant digits must be in [1,5]");
+  this->unit = unit;
+  this->inv_unit = 1.0 / unit;
+  this->digits = digits;
+  int64_t largest_single_unit = 2;
+  for (int d = 0; d < digits; ++d)
+    largest_single_unit *= 10;
+  int sub_bucket_count_magnitude = 0;
+  while ((INT64_C(1) << sub_bucket_count_magnitude) < largest_single_unit)
+    sub_bucket_count_magnitude++;
+  sub_bucket_half_count_magnitude = sub_bucket_count_magnitude - 1;
+  sub_bucket_half_count = INT64_C(1) << sub_bucket_half_count_magnitude;
+  sub_bucket_mask = (INT64_C(1) << sub_bucket_count_magnitude) - 1;
+}
+
+void HdrStat::clear(double now) {
+  parent::clear(now);
+  pos_counts.clear();
+  neg_counts.clear();
+}
+
+void HdrStat::addWeighted(double x, double w) {
+  double m = fabs(x) * inv_unit;
+  int64_t v = m < double(HDR_MAX_VALUE) ? int64_t(m) : HDR_MAX_VALUE;
+  std::vector<double> & counts = (x < 0.0 && v > 0) ? neg_counts : pos_counts;
+  unsigned long idx = getIndex(v);
+  if (idx >= counts.size())
+    counts.resize(idx + 1, 0.0);
+  counts[idx] += w;
+}
+
+int64_t HdrStat::getLowestValue(long idx) const {
+  long bucket_idx = (idx >> sub_bucket_half_count_magnitude) - 1;
+  int64_t sub_bucket_idx = (idx & (sub_bucket_half_count - 1)) + sub_bucket_half_count;
+  if (bucket_idx < 0) {
+    sub_bucket_idx -= sub_bucket_half_count;
+    bucket_idx = 0;
+  }
+  return sub_bucket_idx << bucket_idx;
+}
+
+int64_t HdrStat::getBucketSize(long idx) const {
+  long bucket_idx = (idx >> sub_bucket_half_count_magnitude) - 1;
+  return INT64_C(1) << std::max(0L, bucket_idx);
+}
+
+double HdrStat::getMidValue(long idx, bool neg) const {
+  double m = (getLowestValue(idx) + getBucketSize(idx) / 2.0) * unit;
+  return neg ? -m : m;
+}
+
+double HdrStat::calcPMFMean() const {
+  double sum = 0.0;
+  for (unsigned long i = 0; i < neg_counts.size(); ++i)
+    sum += neg_counts[i] * getMidValue(i, true);
+  for (unsigned long i = 0; i < pos_counts.size(); ++i)
+    sum += pos_counts[i] * getMidValue(i, false);
+  return sum / w_sum;
+}
+
+double HdrStat::getCDF(double x) const {
+  if (w_sum == 0.0 || x < getMin())
+    return 0.0;
+  if (x >= getMax())
+    return 1.0;
+  double w = 0.0;
+  for (long i = long(neg_counts.size()) - 1; i >= 0; --i)
+    if (getMidValue(i, true) <= x)
+      w += neg_counts[i];
+  for (unsigned long i = 0; i < pos_counts.size() && getMidValue(i, false) <= x; ++i)
+    w += pos_counts[i];
+  return w / w_sum;
+}
+
+double HdrStat::getQuantile(double p) const {
+  if (w_sum == 0.0)
+    return getMax();
+  double target = std::min(p, 1.0) * w_sum;
+  double w = 0.0;
+  double x = getMax();
+  bool found = false;
+  /* From the most negative values up to the most positive ones	*/
+  for (long i = long(neg_counts.size()) - 1; i >= 0 && !found; --i) {
+    w += neg_counts[i];
+    if (neg_counts[i] > 0.0 && w >= target) {
+      x = -double(getLowestValue(i)) * unit;
+      found = true;
+    }
+  }
+  for (unsigned long i = 0; i < pos_counts.size() && !found; ++i) {
+    w += pos_counts[i];
+    if (pos_counts[i] > 0.0 && w >= target) {
+      x = double(getLowestValue(i) + getBucketSize(i)) * unit;
+      found = true;
+    }
+  }
+  return std::max(getMin(), std::min(getMax(), x));
+}
+
+void HdrStat::merge(const BaseStat & s) {
+  const HdrStat *p_h = dynamic_cast<const HdrStat *>(&s);
+  CHECK(p_h != 0, "Merging statistics of different types");
+  const HdrStat & h = *p_h;
+  CHECK(h.unit == unit && h.digits == digits, "Merging HdrStat objects with different layouts");
+  mergeMoments(h);
+  if (h.pos_counts.size() > pos_counts.size())
+    pos_counts.resize(h.pos_counts.size(), 0.0);
+  for (unsigned long i = 0; i < h.pos_counts.size(); ++i)
+    pos_counts[i] += h.pos_counts[i];
+  if (h.neg_counts.size() > neg_counts.size())
+    neg_counts.resize(h.neg_counts.size(), 0.0);
+  for (unsigned long i = 0; i < h.neg_counts.size(); ++i)
+    neg_counts[i] += h.neg_counts[i];
+}
@@ -0,0 +1,98 @@
+/*
+ * ARSim
+ * Copyright (c) 2000-2010 Tommaso Cucinotta
+ *
+ * This file is part of ARSim.
+ *
+ * ARSim is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * ARSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with ARSim. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef __ARSIM_HDR_STAT_HPP__
+#define   __ARSIM_HDR_STAT_HPP__
+
+#include "QuantileStat.hpp"
+
+#include <stdint.h>
+#include <vector>
+
+/** Log-linear bucketed histogram, in the style of HdrHistogram, for
+ ** heavy-tailed statistics such as scheduling errors.
+ **
+ ** Values are quantized to integer multiples of unit, then each power
+ ** of 2 range is split into enough linear sub-buckets to keep the given
+ ** number of significant decimal digits. Bucket indexes are computed with
+ ** shifts and a count-leading-zeros instruction, so addSample() is O(1)
+ ** with no floating-point division. Buckets are allocated as far as the
+ ** largest magnitude seen, and negative values have their own buckets,
+ ** so that no sample is ever clipped. Histograms with the same layout are
+ ** merged by summing the bucket weights.
+ **/
+class HdrStat : public QuantileStat {
+  int digits;		// Significant decimal digits
+  double unit;		// Lowest discernible value
+  double inv_unit;
+  int sub_bucket_half_count_magnitude;
+  int64_t sub_bucket_half_count;
+  int64_t sub_bucket_mask;
+  std::vector<double> pos_counts; // Weight of each bucket for x >= 0
+  std::vector<double> neg_counts; // Weight of each bucket for x < 0, by magnitude
+
+  /** Return the bucket index of the quantized magnitude v	*/
+  inline long getIndex(int64_t v) const;
+  /** Return the lowest quantized magnitude in bucket idx	*/
+  int64_t getLowestValue(long idx) const;
+  /** Return the number of quantized magnitudes in bucket idx	*/
+  int64_t getBucketSize(long idx) const;
+  /** Return the value representing bucket idx (midpoint)	*/
+  double getMidValue(long idx, bool neg) const;
+
+ protected:
+
+  void addWeighted(double x, double w);
+
+ public:
+
+  typedef QuantileStat parent;
+
+  /** Build a HdrStat with the given resolution and precision	*/
+  HdrStat(double unit, int digits = DEF_HDR_DIGITS, bool time_weighted = false,
+          double now = 0.0, long pmf_size = DEF_QUANTILE_PMF_SIZE);
+
+  /** Calculate mean from the bucket midpoints			*/
+  double calcPMFMean() const;
+  /** Return the fraction of samples in buckets not greater than x	*/
+  double getCDF(double x) const;
+  /** Return the highest value equivalent to the p-quantile sample,
+   ** within the configured precision, with p in [0,1].		*/
+  double getQuantile(double p) const;
+  /** Return the number of buckets currently allocated		*/
+  long getNumBuckets() const { return pos_counts.size() + neg_counts.size(); }
+
+  /** Add the samples of s, a HdrStat with the same unit and digits,
+   ** by summing the bucket weights				*/
+  virtual void merge(const BaseStat & s);
+
+  /** Clear all accumulated statistics.				*/
+  using QuantileStat::clear;
+  virtual void clear(double now);
+};
+
+inline long HdrStat::getIndex(int64_t v) const {
+  int pow2ceiling = 64 - __builtin_clzll(v | sub_bucket_mask);
+  int bucket_idx = pow2ceiling - (sub_bucket_half_count_magnitude + 1);
+  long sub_bucket_idx = long(v >> bucket_idx);
+  return (long(bucket_idx + 1) << sub_bucket_half_count_magnitude) + sub_bucket_idx - sub_bucket_half_count;
+}
+
+#endif
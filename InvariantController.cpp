@@ -26,6 +26,7 @@
 #include "defaults.hpp"
 #include "ResourceManager.hpp"
 #include "LimitedController.hpp"
+#include "StatFactory.hpp"
 
 /* Implementation related includes */
 
@@ -35,18 +36,38 @@
 #include <values.h>
 
 InvariantController::InvariantController()
-  : parent(),
-    eps_inv_stat(0.0, 2.0, 1.0),
-    rsteps_inv_stat(0.0, 10.0, 1.0),
-    range_width_stat(0.0, 1.0, 0.05),
-    range_alpha_stat(0.0, 1.0, 0.05)
+  : parent()
 {
+  rsteps_inv_stat = StatFactory::getInstance("hist", 0.0, 10.0, 1.0, false);
+  range_width_stat = StatFactory::getInstance("hist", 0.0, 1.0, 0.05, false);
+  range_alpha_stat = StatFactory::getInstance("hist", 0.0, 1.0, 0.05, false);
   coeff_pos = DEF_P;
   eps_min = eps_max = UNASSIGNED;
   rsteps_inv = 0;
   strict_checks = false;
 }
 
+InvariantController::~InvariantController() {
+  delete rsteps_inv_stat;
+  delete range_width_stat;
+  delete range_alpha_stat;
+}
+
+bool InvariantController::setStat(const string & name, const char *spec) {
+  if (name == "ri") {
+    delete rsteps_inv_stat;
+    rsteps_inv_stat = StatFactory::getInstance(spec, 0.0, 10.0, 1.0, false);
+  } else if (name == "rw") {
+    delete range_width_stat;
+    range_width_stat = StatFactory::getInstance(spec, 0.0, 1.0, 0.05, false);
+  } else if (name == "ra") {
+    delete range_alpha_stat;
+    range_alpha_stat = StatFactory::getInstance(spec, 0.0, 1.0, 0.05, false);
+  } else
+    return parent::setStat(name, spec);
+  return true;
+}
+
 bool InvariantController::checkParams() {
   if (! parent::checkParams())
     return false;
@@ -121,7 +142,7 @@ bool InvariantController::parseArg(int& argc, char **& argv) {
 
 double InvariantController::calcBandwidth(double sched_err, double start_err) {
   if (sched_err <= eps_max) {
-    rsteps_inv_stat.addSample(rsteps_inv);	// Avoid imprecisions in accounting
+    rsteps_inv_stat->addSample(rsteps_inv);	// Avoid imprecisions in accounting
     rsteps_inv = 0;
   } else
     rsteps_inv++;
@@ -141,8 +162,8 @@ Interval InvariantController::calcBandwidthRange(double sched_err, double start_
     return Interval(bw_max, bw_max);
   c_min = c_range.getMin();
   c_max = c_range.getMax();
-  range_width_stat.addSample((c_max - c_min) / getTask()->getPeriod());
-  range_alpha_stat.addSample(c_min / c_max);
+  range_width_stat->addSample((c_max - c_min) / getTask()->getPeriod());
+  range_alpha_stat->addSample(c_min / c_max);
 
   double period = getTask()->getPeriod();
 
@@ -191,21 +212,21 @@ void InvariantController::dumpStats() {
   rsteps_inv_fname = strdup("ri_stats0,0.dat");
   rsteps_inv_fname[8] = '0' + num_task;
   rsteps_inv_fname[10] = '0' + num_rs;
-  rsteps_inv_stat.dumpStat(rsteps_inv_fname, "ri", true, "Return steps into invariant");
+  rsteps_inv_stat->dumpStat(rsteps_inv_fname, "ri", true, "Return steps into invariant");
 
   /* Dump range width stats */
   char *rw_fname;
   rw_fname = strdup("rw_stats0,0.dat");
   rw_fname[8] = '0' + num_task;
   rw_fname[10] = '0' + num_rs;
-  range_width_stat.dumpStat(rw_fname, "rw", false, "Prediction Range Width");
+  range_width_stat->dumpStat(rw_fname, "rw", false, "Prediction Range Width");
 
   /* Dump range alpha stats */
   char *ra_fname;
   ra_fname = strdup("ra_stats0,0.dat");
   ra_fname[8] = '0' + num_task;
   ra_fname[10] = '0' + num_rs;
-  range_alpha_stat.dumpStat(ra_fname, "ra", false, "Prediction Range Alpha");
+  range_alpha_stat->dumpStat(ra_fname, "ra", false, "Prediction Range Alpha");
 }
 
 Interval InvariantController::calcBwRange(
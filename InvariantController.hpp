@@ -24,6 +24,7 @@
 
 #include "Controller.hpp"
 #include "Interval.hpp"
+#include "MeanStat.hpp"
 
 /** Relaxed limited scheduler: uses a Double Limited Task, but		*
  * calculates invariant and bandwidth based on the internal range.	*
@@ -32,6 +33,8 @@
 
 class InvariantController : public Controller {
 
+  friend class ControllerBank;
+
  protected:
 
   typedef Controller parent;
@@ -41,13 +44,13 @@ class InvariantController : public Controller {
   double coeff_pos;	// Percentage of the minimum invariant that remains positive
   double c_min, c_max;	// Minimum and maximum task instance duration
 
-  Stat eps_inv_stat;	// Experimental probability of staying into the invariant
+  MeanStat eps_inv_stat;	// Experimental probability of staying into the invariant
 
   /**
    * Event-based statistics for number of consecutive jobs for which the
    * sched err remains outside the invariant set
    */
-  Stat rsteps_inv_stat;
+  BaseStat *rsteps_inv_stat;
 
   /**
    * Partial number of consecutive jobs for which the sched err remains
@@ -59,9 +62,9 @@ class InvariantController : public Controller {
   char *rsteps_inv_fname;
 
   /** Stat of prediction range widths		*/
-  Stat range_width_stat;
+  BaseStat *range_width_stat;
   /** Stat of prediction range alphas		*/
-  Stat range_alpha_stat;
+  BaseStat *range_alpha_stat;
 
   /** Turns on strict checking on invariant conditions */
   bool strict_checks;
@@ -97,8 +100,10 @@ class InvariantController : public Controller {
 
   static void usage();
 
+  virtual bool setStat(const std::string & name, const char *spec);
   void dumpStats();
 
+  virtual ~InvariantController();
 };
 
 #endif
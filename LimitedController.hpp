@@ -28,6 +28,8 @@
 /** Limited controller */
 class LimitedController : public Controller {
 
+  friend class ControllerBank;
+
  protected:
 
   double eps_max;	//< Control such that -eps_min < e(k) < eps_max
@@ -0,0 +1,126 @@
+/*
+ * ARSim
+ * Copyright (c) 2000-2010 Tommaso Cucinotta
+ *
+ * This file is part of ARSim.
+ *
+ * ARSim is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * ARSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with ARSim. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <cstring>
+
+#include "LiveMetrics.hpp"
+#include "ResourceManager.hpp"
+#include "GlobalOptimizer.hpp"
+#include "Events.hpp"
+#include "util.hpp"
+
+#include <stdio.h>
+#include <unistd.h>
+
+LiveMetrics *LiveMetrics::p_lm = new LiveMetrics();
+
+LiveMetrics::LiveMetrics() {
+  enabled = false;
+  period = 1.0;
+  check_steps = 256;
+  steps = 0;
+  t_start = t_last = 0.0;
+  ev_last = 0;
+  ev_rate = 0.0;
+}
+
+void LiveMetrics::usage() {
+  printf("  LIVE METRICS OPTIONS\n");
+  printf("           -lm     file: periodically publish live metrics to file (e.g., within /dev/shm)\n");
+  printf("           -lm-p   ms: minimum wall-clock time between metrics updates (defaults to 1000)\n");
+}
+
+bool LiveMetrics::parseArg(int& argc, char **& argv) {
+  if (strcmp(*argv, "-lm") == 0) {
+    CHECK(argc > 1, "Option requires an argument");
+    argv++;  argc--;
+    lm_fname = *argv;
+    lm_tmp_fname = lm_fname + ".tmp";
+    enabled = true;
+    t_start = t_last = getWallClock();
+  } else if (strcmp(*argv, "-lm-p") == 0) {
+    CHECK(argc > 1, "Option requires an argument");
+    argv++;  argc--;
+    double ms;
+    CHECK(sscanf(*argv, "%lg", &ms) == 1 && ms > 0, "Expecting positive real as argument to -lm-p option");
+    period = ms / 1000.0;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+void LiveMetrics::updateNow(double progress, bool force) {
+  double t_now = getWallClock();
+  if (! force && t_now - t_last < period)
+    return;
+  unsigned long ev_now = EventList::events().getNumDispatched();
+  if (t_now > t_last)
+    ev_rate = (ev_now - ev_last) / (t_now - t_last);
+  t_last = t_now;
+  ev_last = ev_now;
+  write(progress, force ? "finished" : "running");
+}
+
+void LiveMetrics::write(double progress, const char *status) {
+  FILE *f = fopen(lm_tmp_fname.c_str(), "w");
+  if (f == NULL) {
+    fprintf(stderr, "# Warning: could not write live metrics to %s\n", lm_tmp_fname.c_str());
+    enabled = false;
+    return;
+  }
+  GlobalOptimizer *p_gc = GlobalOptimizer::getInstance();
+  fprintf(f, "# ARSim live metrics (pid %d)\n", (int) getpid());
+  fprintf(f, "status %s\n", status);
+  fprintf(f, "wall_time %.3f\n", t_last - t_start);
+  fprintf(f, "sim_time %g\n", EventList::getTime());
+  fprintf(f, "progress %.4f\n", progress);
+  fprintf(f, "events %lu\n", ev_last);
+  fprintf(f, "events_per_sec %.0f\n", ev_rate);
+  fprintf(f, "opt_solves %lu\n", p_gc->getNumSolves());
+  fprintf(f, "opt_solve_ms_last %.3f\n", p_gc->getLastSolveTime() * 1000.0);
+  fprintf(f, "opt_solve_ms_avg %.3f\n", p_gc->getAvgSolveTime() * 1000.0);
+  fprintf(f, "opt_solve_ms_max %.3f\n", p_gc->getMaxSolveTime() * 1000.0);
+  fprintf(f, "# resource  name  power_mode  overload_frac\n");
+  vector<ResourceManager*>::iterator rs_it = ResourceManager::rs_controllers.begin();
+  for (; rs_it != ResourceManager::rs_controllers.end(); ++rs_it)
+    fprintf(f, "resource %d %s %d %.5f\n", (*rs_it)->getResourceId(), (*rs_it)->getResourceName().c_str(),
+	    (*rs_it)->getPowerMode(), (*rs_it)->getSupervisor()->getOverloadFraction());
+  fprintf(f, "# task  t,r  jobs  pinv  bw_mean  bw_current  bw_required\n");
+  for (rs_it = ResourceManager::rs_controllers.begin(); rs_it != ResourceManager::rs_controllers.end(); ++rs_it) {
+    for (unsigned int t = 0; t < (*rs_it)->getTaskSchedulerNum(); ++t) {
+      TaskScheduler *p_tsched = (*rs_it)->getTaskSchedulerAt(t);
+      fprintf(f, "task %u,%d %ld %.5f %.5f %.5f %.5f\n", t, (*rs_it)->getResourceId(),
+	      p_tsched->getLastFinishedJobID(), p_tsched->getPinv(), p_tsched->getMeanBandwidth(),
+	      p_tsched->getCurrentBandwidth(), p_tsched->getRequiredBandwidth());
+    }
+  }
+  fclose(f);
+  if (rename(lm_tmp_fname.c_str(), lm_fname.c_str()) != 0) {
+    fprintf(stderr, "# Warning: could not rename live metrics file to %s\n", lm_fname.c_str());
+    enabled = false;
+  }
+}
+
+void LiveMetrics::close() {
+  if (enabled)
+    updateNow(1.0, true);
+  enabled = false;
+}
@@ -0,0 +1,82 @@
+/*
+ * ARSim
+ * Copyright (c) 2000-2010 Tommaso Cucinotta
+ *
+ * This file is part of ARSim.
+ *
+ * ARSim is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * ARSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with ARSim. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef __ARSIM_LIVE_METRICS_HPP__
+#  define __ARSIM_LIVE_METRICS_HPP__
+
+#include "Component.hpp"
+
+#include <string>
+
+/** Live metrics of a running simulation, published as a small text file.
+ **
+ ** The file is rewritten from the main loop at most once per configured
+ ** period (of wall-clock time), by writing a temporary file and renaming
+ ** it over the target, so readers never see a partial update. Placing it
+ ** within /dev/shm keeps it in shared memory, e.g.:
+ **
+ **   arsim -lm /dev/shm/arsim.txt ... &  watch cat /dev/shm/arsim.txt
+ **/
+class LiveMetrics : public Component {
+  static LiveMetrics *p_lm;
+  friend class SimContext;
+
+  std::string lm_fname;
+  std::string lm_tmp_fname;
+  bool enabled;
+  /** Minimum wall-clock time between two updates (s) */
+  double period;
+  /** Main loop steps between two checks of the wall clock */
+  unsigned long check_steps;
+  unsigned long steps;
+  double t_start, t_last;
+  unsigned long ev_last;
+  double ev_rate;
+
+  void write(double progress, const char *status);
+
+public:
+
+  LiveMetrics();
+
+  static inline LiveMetrics *getInstance() { return p_lm; }
+
+  static void usage();
+  virtual bool parseArg(int& argc, char **& argv);
+
+  bool isEnabled() const { return enabled; }
+
+  /** Called from the main loop after each simulation step, with the
+   ** current simulation progress within [0,1]. Cheap, unless it is
+   ** time to rewrite the metrics file.
+   **/
+  void update(double progress) {
+    if (enabled && ++steps >= check_steps) {
+      steps = 0;
+      updateNow(progress, false);
+    }
+  }
+  /** Rewrite the metrics file if the period elapsed, or if forced	*/
+  void updateNow(double progress, bool force);
+  /** Write the final metrics at the end of the simulation		*/
+  void close();
+};
+
+#endif
@@ -0,0 +1,46 @@
+/*
+ * ARSim
+ * Copyright (c) 2000-2010 Tommaso Cucinotta
+ *
+ * This file is part of ARSim.
+ *
+ * ARSim is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * ARSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with ARSim. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef __ARSIM_MEAN_STAT_HPP__
+#define   __ARSIM_MEAN_STAT_HPP__
+
+/** Plain sample counter and sum, for internal accumulators of which only
+ ** the mean is ever used, and that are not dumped: with no intervals and
+ ** no virtual methods, updates reduce to two inlined additions.
+ **/
+class MeanStat {
+  long num_samples;	// Number of x samples
+  double x_sum;		// Exact sum of samples
+
+ public:
+
+  MeanStat() { clear(); }
+
+  /** Feed with next sample					*/
+  void addSample(double x) { num_samples++; x_sum += x; }
+  /** Get number of samples   */
+  long getNumSamples() const { return num_samples; }
+  /** Return mean of provided samples (NaN if none, as for Stat)	*/
+  double getMean() const { return x_sum / double(num_samples); }
+  /** Clear all accumulated statistics.				*/
+  void clear() { num_samples = 0; x_sum = 0.0; }
+};
+
+#endif
@@ -0,0 +1,50 @@
+/*
+ * ARSim
+ * Copyright (c) 2000-2010 Tommaso Cucinotta
+ *
+ * This file is part of ARSim.
+ *
+ * ARSim is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * ARSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with ARSim. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef __ARSIM_MOVING_TIME_STAT_HPP__
+#define   __ARSIM_MOVING_TIME_STAT_HPP__
+
+/** Time-weighted mean and deviation of x(t) over a moving horizon, for
+ ** feedback loops that need a smooth estimate which can be read at any
+ ** instant, and which never restarts from scratch. Updates are O(1).
+ **
+ ** As in TimeStat, each sample holds from its insertion time up to the
+ ** next one; the readers account for the last sample up to now.
+ **/
+class MovingTimeStat {
+ public:
+  /** Feed with next sample at time t				*/
+  virtual void addSample(double x, double t) = 0;
+  /** Return the time-weighted mean within the horizon at time now,
+   ** or the last sample, if no time elapsed since the first one	*/
+  virtual double getMean(double now) const = 0;
+  /** Return the time-weighted standard deviation at time now	*/
+  virtual double getDev(double now) const = 0;
+  /** Return the (possibly decayed) time covered by the samples	*/
+  virtual double getWeight(double now) const = 0;
+  /** Return true if at least one sample has been provided	*/
+  virtual bool hasSamples() const = 0;
+  /** Forget all samples, restarting at time now		*/
+  virtual void clear(double now) = 0;
+
+  virtual ~MovingTimeStat() { }
+};
+
+#endif
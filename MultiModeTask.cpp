@@ -57,6 +57,12 @@ double MultiModeTask::generateWorkingTime() {
   return retval;
 }
 
+void MultiModeTask::setStreamId(uint64_t id) {
+  parent::setStreamId(id);
+  for (unsigned int am = 0; am < app_mode_tasks.size(); ++am)
+    app_mode_tasks[am]->setStreamId(id | ((uint64_t) (am + 1) << 48));
+}
+
 bool MultiModeTask::parseArg(int& argc, char **& argv) {
   if ((app_mode_tasks.size() > 0) && (*(app_mode_tasks.end()-1))->parseArg(argc, argv)) {
     return true;
@@ -112,10 +118,11 @@ void MultiModeTask::calcParams() {
       CHECK(p_ref_task != 0, "First mode is not a trace task ! Please, provide best-fit model by hand");
       TraceTask const *p_task = dynamic_cast<TraceTask *>(app_mode_tasks[am]);
       CHECK(p_task != 0, "Current mode is not a trace task ! Please, provide best-fit model by hand");
-      vector<double>::const_iterator x_it_beg = p_ref_task->getSamples().begin();
-      vector<double>::const_iterator x_it_end = p_ref_task->getSamples().end();
-      vector<double>::const_iterator y_it_beg = p_task->getSamples().begin();
-      vector<double>::const_iterator y_it_end = p_task->getSamples().end();
+      CHECK(! p_ref_task->isStreaming() && ! p_task->isStreaming(), "Cannot auto-fit models of streamed traces ! Please, provide best-fit model by hand");
+      const double *x_it_beg = p_ref_task->getSamples();
+      const double *x_it_end = x_it_beg + p_ref_task->getNumSamples();
+      const double *y_it_beg = p_task->getSamples();
+      const double *y_it_end = y_it_beg + p_task->getNumSamples();
       p_mdl->fit(x_it_beg, x_it_end, y_it_beg, y_it_end);
       Logger::debugLog("Pushing auto-fitted model: m=%g, q=%g\n", p_mdl->getM(), p_mdl->getQ());
       app_mode_models.push_back(p_mdl);
@@ -44,6 +44,7 @@ class MultiModeTask : public Task {
    ** but returns only the value associated with the current application mode.
    **/
   virtual double generateWorkingTime();
+  virtual void setStreamId(uint64_t id);
 
   virtual void setAppMode(unsigned int mode);
   virtual unsigned int getAppMode() const { return mmt_app_mode; }
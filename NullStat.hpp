@@ -0,0 +1,55 @@
+/*
+ * ARSim
+ * Copyright (c) 2000-2010 Tommaso Cucinotta
+ *
+ * This file is part of ARSim.
+ *
+ * ARSim is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * ARSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with ARSim. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef __ARSIM_NULL_STAT_HPP__
+#define   __ARSIM_NULL_STAT_HPP__
+
+#include "BaseStat.hpp"
+
+#include <math.h>
+
+/** Disabled statistic, selected with the "off" type specification: it
+ ** ignores all samples, has no intervals and is not dumped.
+ **/
+class NullStat : public BaseStat {
+ public:
+  virtual void addSample(double value) { }
+  virtual void addSample(double value, double t) { }
+  virtual bool isEnabled() const { return false; }
+
+  virtual double calcPMFMean() const { return NAN; }
+  virtual double getMean() const { return NAN; }
+  virtual double getMeanPos() const { return NAN; }
+  virtual double getMeanNegZero() const { return NAN; }
+  virtual double getDev() const { return NAN; }
+  virtual double getMeanAbs() const { return NAN; }
+  virtual double getPDFValue(double x) const { return 0.0; }
+  virtual double getPMFValue(long n_sample) const { return 0.0; }
+  virtual double sumPMFValues() const { return 0.0; }
+  virtual long getPMFSize() const { return 0; }
+  virtual double getXValue(long n_sample) const { return 0.0; }
+  virtual double getPMFPercentile(double p) const { return NAN; }
+  virtual long getNumSamples() const { return 0; }
+  virtual double getWeight() const { return 0.0; }
+  virtual double getWeightPos() const { return 0.0; }
+  virtual void merge(const BaseStat & s) { }
+};
+
+#endif
@@ -0,0 +1,118 @@
+/*
+ * ARSim
+ * Copyright (c) 2000-2010 Tommaso Cucinotta
+ *
+ * This file is part of ARSim.
+ *
+ * ARSim is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * ARSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with ARSim. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include "OrderStatTree.hpp"
+#include "util.hpp"
+
+OrderStatTree::OrderStatTree() {
+  root = -1;
+  prio_state = 2463534242u;
+}
+
+void OrderStatTree::clear() {
+  nodes.clear();
+  free_nodes.clear();
+  root = -1;
+}
+
+int OrderStatTree::newNode(double key) {
+  /* xorshift32 priorities */
+  prio_state ^= prio_state << 13;
+  prio_state ^= prio_state >> 17;
+  prio_state ^= prio_state << 5;
+  int t;
+  if (free_nodes.empty()) {
+    t = nodes.size();
+    nodes.push_back(Node());
+  } else {
+    t = free_nodes.back();
+    free_nodes.pop_back();
+  }
+  nodes[t].key = key;
+  nodes[t].prio = prio_state;
+  nodes[t].left = nodes[t].right = -1;
+  nodes[t].size = 1;
+  return t;
+}
+
+void OrderStatTree::split(int t, double key, bool inclusive, int & l, int & r) {
+  if (t < 0) {
+    l = r = -1;
+    return;
+  }
+  if (nodes[t].key < key || (inclusive && nodes[t].key == key)) {
+    split(nodes[t].right, key, inclusive, nodes[t].right, r);
+    l = t;
+  } else {
+    split(nodes[t].left, key, inclusive, l, nodes[t].left);
+    r = t;
+  }
+  update(t);
+}
+
+int OrderStatTree::merge(int l, int r) {
+  if (l < 0)
+    return r;
+  if (r < 0)
+    return l;
+  if (nodes[l].prio > nodes[r].prio) {
+    nodes[l].right = merge(nodes[l].right, r);
+    update(l);
+    return l;
+  }
+  nodes[r].left = merge(l, nodes[r].left);
+  update(r);
+  return r;
+}
+
+void OrderStatTree::insert(double x) {
+  int l, r;
+  split(root, x, false, l, r);
+  root = merge(merge(l, newNode(x)), r);
+}
+
+bool OrderStatTree::erase(double x) {
+  int l, m, r;
+  split(root, x, false, l, r);
+  split(r, x, true, m, r);
+  bool found = m >= 0;
+  if (found) {
+    free_nodes.push_back(m);
+    m = merge(nodes[m].left, nodes[m].right);
+  }
+  root = merge(merge(l, m), r);
+  return found;
+}
+
+double OrderStatTree::select(int k) const {
+  ASSERT1(k >= 0 && k < size(), "OrderStatTree::select(): k out of range: %d", k);
+  int t = root;
+  while (true) {
+    int ls = getSize(nodes[t].left);
+    if (k < ls) {
+      t = nodes[t].left;
+    } else if (k == ls) {
+      return nodes[t].key;
+    } else {
+      k -= ls + 1;
+      t = nodes[t].right;
+    }
+  }
+}
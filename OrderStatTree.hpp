@@ -0,0 +1,70 @@
+/*
+ * ARSim
+ * Copyright (c) 2000-2010 Tommaso Cucinotta
+ *
+ * This file is part of ARSim.
+ *
+ * ARSim is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * ARSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with ARSim. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef __ARSIM_ORDER_STAT_TREE_HPP__
+#  define __ARSIM_ORDER_STAT_TREE_HPP__
+
+#include <stdint.h>
+#include <vector>
+
+/** Multiset of doubles supporting insertion, removal and selection of
+ ** the k-th smallest element in O(log n) expected time, meant for
+ ** order statistics over sliding windows of samples.
+ **
+ ** It is a treap with subtree sizes, whose nodes live in a pool that is
+ ** recycled on removal, so that a window of steady size allocates no
+ ** memory. Priorities come from a private generator, in order not to
+ ** perturb the random() sequence of the simulation.
+ **/
+class OrderStatTree {
+  struct Node {
+    double key;
+    uint32_t prio;
+    int left, right;
+    int size;
+  };
+
+  std::vector<Node> nodes;
+  std::vector<int> free_nodes;
+  int root;
+  uint32_t prio_state;
+
+  int getSize(int t) const { return t < 0 ? 0 : nodes[t].size; }
+  void update(int t) { nodes[t].size = 1 + getSize(nodes[t].left) + getSize(nodes[t].right); }
+  /** Split t into keys < key (or <= key, if inclusive), and the rest */
+  void split(int t, double key, bool inclusive, int & l, int & r);
+  int merge(int l, int r);
+  int newNode(double key);
+
+public:
+
+  OrderStatTree();
+
+  /** Add one occurrence of x					*/
+  void insert(double x);
+  /** Remove one occurrence of x, returning false if x is not present */
+  bool erase(double x);
+  /** Return the k-th smallest element, with k in [0, size()-1]	*/
+  double select(int k) const;
+  int size() const { return getSize(root); }
+  void clear();
+};
+
+#endif
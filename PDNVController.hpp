@@ -30,6 +30,8 @@
 
 class PDNVController : public Controller {
 
+  friend class ControllerBank;
+
  protected:
 
   typedef Controller parent;
@@ -0,0 +1,118 @@
+/*
+ * ARSim
+ * Copyright (c) 2000-2010 Tommaso Cucinotta
+ *
+ * This file is part of ARSim.
+ *
+ * ARSim is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * ARSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with ARSim. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include "PairedDiff.hpp"
+#include "util.hpp"
+
+#include <math.h>
+
+/** Number of batches for the batch means confidence interval		*/
+#define PD_NUM_BATCHES 20
+/** 97.5% quantile of the Student t with PD_NUM_BATCHES-1 degrees of freedom */
+#define PD_T_QUANTILE 2.093
+
+static const char *pd_names[] = { "c_k", "start_err", "bw_req", "bw_granted", "sched_err" };
+
+void PairedDiff::load(const char *fname, std::vector<Row> & rows) {
+  FILE *f = fopen(fname, "r");
+  CHECK1(f != NULL, "Could not open job record file %s", fname);
+  char line[1024];
+  while (fgets(line, sizeof(line), f) != NULL) {
+    if (line[0] == '#')
+      continue;
+    Row r;
+    CHECK1(sscanf(line, "%ld %lg %lg %lg %lg %lg", &r.job_id, &r.v[0], &r.v[1],
+                  &r.v[2], &r.v[3], &r.v[4]) == 6,
+           "Wrong format of job record file %s", fname);
+    rows.push_back(r);
+  }
+  fclose(f);
+  CHECK1(rows.size() > 0, "No jobs in job record file %s", fname);
+}
+
+void PairedDiff::compare(const char *fname_a, const char *fname_b, FILE *out) {
+  std::vector<Row> rows_a, rows_b;
+  load(fname_a, rows_a);
+  load(fname_b, rows_b);
+
+  /* Pair jobs by ID, as records are sorted by job ID */
+  std::vector<long> pos_a, pos_b;
+  unsigned int i = 0, j = 0;
+  while (i < rows_a.size() && j < rows_b.size()) {
+    if (rows_a[i].job_id < rows_b[j].job_id)
+      i++;
+    else if (rows_a[i].job_id > rows_b[j].job_id)
+      j++;
+    else {
+      pos_a.push_back(i++);
+      pos_b.push_back(j++);
+    }
+  }
+  long n = pos_a.size();
+  CHECK(n >= 2, "Less than two jobs in common between the job record files");
+
+  long num_ck_diff = 0;
+  for (long k = 0; k < n; ++k)
+    if (rows_a[pos_a[k]].v[0] != rows_b[pos_b[k]].v[0])
+      num_ck_diff++;
+
+  fprintf(out, "# Paired differences (%s - %s) over %ld jobs\n", fname_b, fname_a, n);
+  fprintf(out, "# %9s %13s %13s %13s %13s %13s %13s\n",
+          "metric", "mean_a", "mean_b", "mean_diff", "ci95_diff", "dev_diff", "var_ratio");
+  long batch_len = n >= 2 * PD_NUM_BATCHES ? n / PD_NUM_BATCHES : 0;
+  for (int m = 0; m < 5; ++m) {
+    double sum_a = 0.0, sum_b = 0.0, sum_d = 0.0;
+    double sqr_a = 0.0, sqr_b = 0.0, sqr_d = 0.0;
+    double batch_sum = 0.0, batch_sqr = 0.0, batch_acc = 0.0;
+    for (long k = 0; k < n; ++k) {
+      double a = rows_a[pos_a[k]].v[m];
+      double b = rows_b[pos_b[k]].v[m];
+      sum_a += a;  sqr_a += a * a;
+      sum_b += b;  sqr_b += b * b;
+      sum_d += b - a;  sqr_d += (b - a) * (b - a);
+      if (batch_len > 0 && k < batch_len * PD_NUM_BATCHES) {
+        batch_acc += b - a;
+        if ((k + 1) % batch_len == 0) {
+          batch_sum += batch_acc / batch_len;
+          batch_sqr += (batch_acc / batch_len) * (batch_acc / batch_len);
+          batch_acc = 0.0;
+        }
+      }
+    }
+    double mean_a = sum_a / n, mean_b = sum_b / n, mean_d = sum_d / n;
+    double var_a = MAX(0.0, (sqr_a - n * mean_a * mean_a) / (n - 1));
+    double var_b = MAX(0.0, (sqr_b - n * mean_b * mean_b) / (n - 1));
+    double var_d = MAX(0.0, (sqr_d - n * mean_d * mean_d) / (n - 1));
+    double ci;
+    if (batch_len > 0) {
+      double bmean = batch_sum / PD_NUM_BATCHES;
+      double bvar = MAX(0.0, (batch_sqr - PD_NUM_BATCHES * bmean * bmean) / (PD_NUM_BATCHES - 1));
+      ci = PD_T_QUANTILE * sqrt(bvar / PD_NUM_BATCHES);
+    } else {
+      ci = 1.96 * sqrt(var_d / n);
+    }
+    /* Variance of the difference of independent runs, over the paired one */
+    double var_ratio = var_d > 0.0 ? (var_a + var_b) / var_d : HUGE_VAL;
+    fprintf(out, "  %9s %13g %13g %13g %13g %13g %13g\n",
+            pd_names[m], mean_a, mean_b, mean_d, ci, sqrt(var_d), var_ratio);
+  }
+  if (num_ck_diff > 0)
+    fprintf(out, "# Warning: c_k differs in %ld jobs, runs do not share common random numbers\n", num_ck_diff);
+}
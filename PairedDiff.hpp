@@ -0,0 +1,52 @@
+/*
+ * ARSim
+ * Copyright (c) 2000-2010 Tommaso Cucinotta
+ *
+ * This file is part of ARSim.
+ *
+ * ARSim is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * ARSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with ARSim. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef __ARSIM_PAIRED_DIFF_HPP__
+#  define __ARSIM_PAIRED_DIFF_HPP__
+
+#include <stdio.h>
+#include <vector>
+
+/** Paired-difference comparison of two configurations, from the per-job
+ ** records (-rec) of a task simulated under each of them.
+ **
+ ** With common random numbers (-crn), both runs see the same c_k sequence,
+ ** so the per-job differences of bandwidth and scheduling error exclude the
+ ** workload variability, and their mean is estimated with a much narrower
+ ** confidence interval than the difference of two independent means. As
+ ** per-job values are autocorrelated, the interval is computed by batch
+ ** means.
+ **/
+class PairedDiff {
+  typedef struct {
+    long job_id;
+    double v[5];	/**< c_k, start_err, bw_req, bw_granted, sched_err */
+  } Row;
+
+  static void load(const char *fname, std::vector<Row> & rows);
+
+public:
+
+  /** Compare the records in fname_a and fname_b, writing the summary of the
+   ** differences (b - a) to out				*/
+  static void compare(const char *fname_a, const char *fname_b, FILE *out);
+};
+
+#endif
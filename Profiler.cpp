@@ -0,0 +1,163 @@
+/*
+ * ARSim
+ * Copyright (c) 2000-2010 Tommaso Cucinotta
+ *
+ * This file is part of ARSim.
+ *
+ * ARSim is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * ARSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with ARSim. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include "Profiler.hpp"
+
+#ifdef WITH_PROFILER
+
+#include "Events.hpp"
+#include "util.hpp"
+
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+
+/** Maximum number of (time, size) event queue samples kept: when full,
+ ** every other sample is dropped and the sampling stride doubles.
+ **/
+#define PROF_QUEUE_SAMPLES 4096
+
+ProfCounter::ProfCounter() : count(0), cycles(0) {
+  memset(hist, 0, sizeof(hist));
+}
+
+void ProfCounter::add(unsigned long long c) {
+  count++;
+  cycles += c;
+  int bin = 0;
+  while (c > 1 && bin < PROF_HIST_BINS - 1) {
+    c >>= 1;
+    bin++;
+  }
+  hist[bin]++;
+}
+
+unsigned long long ProfCounter::getPercentile(double p) const {
+  unsigned long acc = 0;
+  for (int bin = 0; bin < PROF_HIST_BINS; ++bin) {
+    acc += hist[bin];
+    if (acc >= p * count)
+      return 2ULL << bin;
+  }
+  return 0;
+}
+
+/* Function-local statics avoid static initialization order issues with
+ * the sites, which are statics of other translation units
+ */
+static std::vector<ProfSite *> & getSites() {
+  static std::vector<ProfSite *> sites;
+  return sites;
+}
+
+static std::map<const void *, std::string> & getNames() {
+  static std::map<const void *, std::string> names;
+  return names;
+}
+
+static std::vector< std::pair<Time, unsigned long> > q_samples;
+static unsigned long q_stride = 1, q_count = 0, q_max = 0;
+static double q_sum = 0.0;
+
+ProfSite::ProfSite(const char *name) : name(name) {
+  memset(cache_inst, 0, sizeof(cache_inst));
+  Profiler::addSite(this);
+}
+
+void Profiler::addSite(ProfSite *p_site) {
+  getSites().push_back(p_site);
+}
+
+void Profiler::nameInstance(const void *p_inst, const std::string & name) {
+  getNames()[p_inst] = name;
+}
+
+void Profiler::sampleQueue(unsigned long size) {
+  q_sum += size;
+  q_max = MAX(q_max, size);
+  if (q_count++ % q_stride != 0)
+    return;
+  if (q_samples.size() == PROF_QUEUE_SAMPLES) {
+    for (unsigned int i = 0; i < PROF_QUEUE_SAMPLES / 2; ++i)
+      q_samples[i] = q_samples[2 * i];
+    q_samples.resize(PROF_QUEUE_SAMPLES / 2);
+    q_stride *= 2;
+  }
+  q_samples.push_back(std::make_pair(EventList::getTime(), size));
+}
+
+static bool cmpSites(const ProfSite *p1, const ProfSite *p2) {
+  return p1->total.cycles > p2->total.cycles;
+}
+
+static bool cmpInstances(const std::pair<const void *, ProfCounter> & i1,
+			 const std::pair<const void *, ProfCounter> & i2) {
+  return i1.second.cycles > i2.second.cycles;
+}
+
+static void reportTo(FILE *f) {
+  std::vector<ProfSite *> sites = getSites();
+  std::sort(sites.begin(), sites.end(), cmpSites);
+  unsigned long long tot = 0;
+  for (unsigned int i = 0; i < sites.size(); ++i)
+    tot += sites[i]->total.cycles;
+  fprintf(f, "# Self-profile (inclusive cycles, nested sites are counted also in the enclosing ones)\n");
+  fprintf(f, "# %-30s %10s %14s %7s %10s %10s %10s\n", "site", "calls", "cycles", "%", "avg", "p50", "p99");
+  for (unsigned int i = 0; i < sites.size(); ++i) {
+    const ProfSite *p = sites[i];
+    if (p->total.count == 0)
+      continue;
+    fprintf(f, "%-32s %10lu %14llu %7.2f %10.0f %10llu %10llu\n", p->name, p->total.count, p->total.cycles,
+	    tot == 0 ? 0.0 : 100.0 * p->total.cycles / tot, double(p->total.cycles) / p->total.count,
+	    p->total.getPercentile(0.5), p->total.getPercentile(0.99));
+    std::vector< std::pair<const void *, ProfCounter> > insts(p->instances.begin(), p->instances.end());
+    std::sort(insts.begin(), insts.end(), cmpInstances);
+    for (unsigned int j = 0; j < insts.size(); ++j) {
+      const ProfCounter & c = insts[j].second;
+      std::map<const void *, std::string>::const_iterator it = getNames().find(insts[j].first);
+      char inst_name[64];
+      if (it != getNames().end())
+	snprintf(inst_name, sizeof(inst_name), "  %s", it->second.c_str());
+      else
+	snprintf(inst_name, sizeof(inst_name), "  %p", insts[j].first);
+      fprintf(f, "%-32s %10lu %14llu %7.2f %10.0f %10llu %10llu\n", inst_name, c.count, c.cycles,
+	      tot == 0 ? 0.0 : 100.0 * c.cycles / tot, double(c.cycles) / c.count,
+	      c.getPercentile(0.5), c.getPercentile(0.99));
+    }
+  }
+  fprintf(f, "# Event queue size: avg %g, max %lu (%lu samples)\n",
+	  q_count == 0 ? 0.0 : q_sum / q_count, q_max, q_count);
+}
+
+void Profiler::report() {
+  reportTo(stderr);
+  FILE *f = fopen("prof.dat", "w");
+  CHECK(f != NULL, "Could not open file prof.dat");
+  reportTo(f);
+  fclose(f);
+  f = fopen("prof_queue.dat", "w");
+  CHECK(f != NULL, "Could not open file prof_queue.dat");
+  fprintf(f, "# %9s %11s\n", "time", "queue_size");
+  for (unsigned int i = 0; i < q_samples.size(); ++i)
+    fprintf(f, "%11.4f %11lu\n", q_samples[i].first, q_samples[i].second);
+  fclose(f);
+}
+
+#endif
@@ -0,0 +1,137 @@
+/*
+ * ARSim
+ * Copyright (c) 2000-2010 Tommaso Cucinotta
+ *
+ * This file is part of ARSim.
+ *
+ * ARSim is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * ARSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with ARSim. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef __ARSIM_PROFILER_HPP__
+#  define __ARSIM_PROFILER_HPP__
+
+/** Self-profiler of the simulator, compiled in only with -DWITH_PROFILER.
+ **
+ ** PROF_SCOPE(name, p_inst) accounts the (inclusive) cycles spent until
+ ** the end of the enclosing block to the named site and to the component
+ ** instance p_inst. PROF_QUEUE(n) samples the event queue size. At exit,
+ ** Profiler::report() ranks sites by total cycles on stderr and prof.dat,
+ ** and writes the event queue size over time to prof_queue.dat.
+ **/
+
+#ifdef WITH_PROFILER
+
+#include <map>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#if defined(__i386__) || defined(__x86_64__)
+#  include <x86intrin.h>
+#  define PROF_CYCLES() __rdtsc()
+#else
+#  include <time.h>
+static inline unsigned long long profNanoSecs() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+#  define PROF_CYCLES() profNanoSecs()
+#endif
+
+/** Number of log2 bins of the cycles histograms */
+#define PROF_HIST_BINS 48
+
+/** Call count and cycles histogram */
+struct ProfCounter {
+  unsigned long count;
+  unsigned long long cycles;
+  unsigned long hist[PROF_HIST_BINS];
+  ProfCounter();
+  void add(unsigned long long c);
+  /** Approximate (upper bound of the log2 bin) cycles percentile */
+  unsigned long long getPercentile(double p) const;
+};
+
+/** Number of entries of the per-site instance counters cache */
+#define PROF_SITE_CACHE 16
+
+/** An instrumented code site, with totals and per-instance counters.
+ ** The counters of the instances seen last are cached, by address, so
+ ** that the map is only looked up when a new instance collides.
+ **/
+class ProfSite {
+  const void *cache_inst[PROF_SITE_CACHE];
+  ProfCounter *cache_cnt[PROF_SITE_CACHE];
+public:
+  const char *name;
+  ProfCounter total;
+  std::map<const void *, ProfCounter> instances;
+  ProfSite(const char *name);
+  void add(const void *p_inst, unsigned long long c) {
+    total.add(c);
+    if (p_inst == 0)
+      return;
+    unsigned int i = ((uintptr_t) p_inst >> 4) % PROF_SITE_CACHE;
+    if (cache_inst[i] != p_inst) {
+      cache_inst[i] = p_inst;
+      cache_cnt[i] = &instances[p_inst];
+    }
+    cache_cnt[i]->add(c);
+  }
+};
+
+class ProfScope {
+  ProfSite & site;
+  const void *p_inst;
+  unsigned long long t0;
+public:
+  ProfScope(ProfSite & site, const void *p_inst) : site(site), p_inst(p_inst) {
+    t0 = PROF_CYCLES();
+  }
+  ~ProfScope() {
+    site.add(p_inst, PROF_CYCLES() - t0);
+  }
+};
+
+namespace Profiler {
+  /** Register a site (done automatically by PROF_SCOPE)		*/
+  void addSite(ProfSite *p_site);
+  /** Associate a human readable name to a component instance	*/
+  void nameInstance(const void *p_inst, const std::string & name);
+  /** Sample the event queue size					*/
+  void sampleQueue(unsigned long size);
+  /** Write the ranked report					*/
+  void report();
+}
+
+#define PROF_CAT2(a, b) a ## b
+#define PROF_CAT(a, b) PROF_CAT2(a, b)
+#define PROF_SCOPE(name, p_inst) \
+  static ProfSite PROF_CAT(prof_site_, __LINE__)(name); \
+  ProfScope PROF_CAT(prof_scope_, __LINE__)(PROF_CAT(prof_site_, __LINE__), p_inst)
+#define PROF_QUEUE(size) Profiler::sampleQueue(size)
+#define PROF_NAME(p_inst, name) Profiler::nameInstance(p_inst, name)
+#define PROF_REPORT() Profiler::report()
+
+#else
+
+#define PROF_SCOPE(name, p_inst) do { } while (0)
+#define PROF_QUEUE(size) do { } while (0)
+#define PROF_NAME(p_inst, name) do { } while (0)
+#define PROF_REPORT() do { } while (0)
+
+#endif
+
+#endif
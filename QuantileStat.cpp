@@ -0,0 +1,174 @@
+/*
+ * ARSim
+ * Copyright (c) 2000-2010 Tommaso Cucinotta
+ *
+ * This file is part of ARSim.
+ *
+ * ARSim is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * ARSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with ARSim. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include "QuantileStat.hpp"
+#include "util.hpp"
+
+#include <math.h>
+
+QuantileStat::QuantileStat(bool time_weighted, double now, long pmf_size) {
+  CHECK(pmf_size > 0, "PMF view size must be positive");
+  this->time_weighted = time_weighted;
+  this->pmf_size = pmf_size;
+  QuantileStat::clear(now);
+}
+
+void QuantileStat::clear(double now) {
+  parent::clear();
+  num_samples = 0;
+  w_sum = 0;
+  x_sum = 0;
+  x_sqr_sum = 0;
+  x_abs_sum = 0;
+  x_sum_pos = 0;
+  w_sum_pos = 0;
+  x_sum_neg_zero = 0;
+  w_sum_neg_zero = 0;
+  prev_x = 0.0;
+  prev_t = now;
+}
+
+void QuantileStat::addSample(double x) {
+  ASSERT(!time_weighted, "Time-weighted statistics need the sample time");
+  BaseStat::addSample(x);
+  num_samples++;
+  w_sum += 1.0;
+  x_sum += x;
+  x_sqr_sum += x * x;
+  x_abs_sum += fabs(x);
+  if (x > 0.0) {
+    x_sum_pos += x;
+    w_sum_pos += 1.0;
+  } else {
+    x_sum_neg_zero += x;
+    w_sum_neg_zero += 1.0;
+  }
+  addWeighted(x, 1.0);
+}
+
+void QuantileStat::addSample(double x, double t) {
+  if (!time_weighted) {
+    addSample(x);
+    return;
+  }
+  BaseStat::addSample(x);
+  num_samples++;
+  /* Use previous sample, that was kept for a time equal to t-prev_t	*/
+  double w = t - prev_t;
+  if (w > 0.0) {
+    w_sum += w;
+    x_sum += prev_x * w;
+    x_sqr_sum += prev_x * prev_x * w;
+    x_abs_sum += fabs(prev_x) * w;
+    if (prev_x > 0.0) {
+      x_sum_pos += prev_x * w;
+      w_sum_pos += w;
+    } else {
+      x_sum_neg_zero += prev_x * w;
+      w_sum_neg_zero += w;
+    }
+    addWeighted(prev_x, w);
+  }
+  prev_x = x;
+  prev_t = t;
+}
+
+void QuantileStat::mergeMoments(const QuantileStat & qs) {
+  mergeMinMax(qs);
+  num_samples += qs.num_samples;
+  w_sum += qs.w_sum;
+  x_sum += qs.x_sum;
+  x_sqr_sum += qs.x_sqr_sum;
+  x_abs_sum += qs.x_abs_sum;
+  x_sum_pos += qs.x_sum_pos;
+  w_sum_pos += qs.w_sum_pos;
+  x_sum_neg_zero += qs.x_sum_neg_zero;
+  w_sum_neg_zero += qs.w_sum_neg_zero;
+}
+
+double QuantileStat::getMean() const {
+  if (w_sum == 0.0)
+    return prev_x;
+  return x_sum / w_sum;
+}
+
+double QuantileStat::getMeanPos() const {
+  if (w_sum_pos == 0.0)
+    return 0.0;
+  return x_sum_pos / w_sum_pos;
+}
+
+double QuantileStat::getMeanNegZero() const {
+  if (w_sum_neg_zero == 0.0)
+    return 0.0;
+  return x_sum_neg_zero / w_sum_neg_zero;
+}
+
+double QuantileStat::getDev() const {
+  if (w_sum == 0.0)
+    return 0;
+  double mean = getMean();
+  return sqrt(std::max(0.0, x_sqr_sum / w_sum - mean * mean));
+}
+
+double QuantileStat::getMeanAbs() const {
+  if (w_sum == 0.0)
+    return fabs(prev_x);
+  return x_abs_sum / w_sum;
+}
+
+long QuantileStat::getPMFSize() const {
+  if (w_sum == 0.0)
+    return 0;
+  if (getMax() == getMin())
+    return 1;
+  return pmf_size;
+}
+
+double QuantileStat::getXValue(long n_sample) const {
+  ASSERT1((n_sample >= 0) && (n_sample < getPMFSize()), "getXValue(): n_sample out of range: %ld", n_sample);
+  return getMin() + getDX() * double(n_sample);
+}
+
+double QuantileStat::getPMFValue(long n_sample) const {
+  long size = getPMFSize();
+  ASSERT1((n_sample >= 0) && (n_sample < size), "getPMFValue(): n_sample out of range: %ld", n_sample);
+  double cdf_left = n_sample == 0 ? 0.0 : getCDF(getXValue(n_sample));
+  if (n_sample == size - 1)
+    return 1.0 - cdf_left;
+  return getCDF(getXValue(n_sample + 1)) - cdf_left;
+}
+
+double QuantileStat::getPDFValue(double x) const {
+  long size = getPMFSize();
+  if (size <= 1 || x < getMin() || x > getMax())
+    return 0.0;
+  long n_sample = std::min(size - 1, long((x - getMin()) / getDX()));
+  return getPMFValue(n_sample) / getDX();
+}
+
+double QuantileStat::sumPMFValues() const {
+  return w_sum == 0.0 ? 0.0 : 1.0;
+}
+
+void QuantileStat::dumpSummary(FILE *file) const {
+  fprintf(file, "# Tail percentiles (99, 99.9, 99.99) = ( %g %g %g )\n",
+          getQuantile(0.99), getQuantile(0.999), getQuantile(0.9999));
+}
@@ -0,0 +1,109 @@
+/*
+ * ARSim
+ * Copyright (c) 2000-2010 Tommaso Cucinotta
+ *
+ * This file is part of ARSim.
+ *
+ * ARSim is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * ARSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with ARSim. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef __ARSIM_QUANTILE_STAT_HPP__
+#define   __ARSIM_QUANTILE_STAT_HPP__
+
+#include "BaseStat.hpp"
+#include "defaults.hpp"
+
+#include <stdio.h>
+
+/** Base for statistics answering quantile queries from their own summary
+ ** structure (sketch, log-bucketed histogram), instead of a fixed-range
+ ** PMF. It keeps the exact moments, handles the time-weighted mode, and
+ ** exposes a PMF view of pmf_size intervals over [min, max], recomputed
+ ** from getCDF().
+ **
+ ** In time-weighted mode, samples are fed through addSample(x, t) and
+ ** each value is weighted by the time it has been kept, as in TimeStat.
+ **/
+class QuantileStat : public BaseStat {
+ protected:
+  bool time_weighted;
+  long pmf_size;	// Number of intervals of the PMF view
+  long num_samples;	// Number of x samples
+  double w_sum;		// Sum of weights (samples, or time)
+  double x_sum;		// Weighted sum of samples
+  double x_sqr_sum;	// Weighted sum of square samples
+  double x_abs_sum;	// Weighted sum of absolute samples
+  double x_sum_pos;	// Weighted sum of positive samples
+  double w_sum_pos;	// Sum of weights of positive samples
+  double x_sum_neg_zero; // Weighted sum of negative or zero samples
+  double w_sum_neg_zero; // Sum of weights of negative or zero samples
+  double prev_x;	// Last sample (time-weighted mode)
+  double prev_t;	// Time of insertion of last sample (time-weighted mode)
+
+  QuantileStat(bool time_weighted, double now, long pmf_size);
+
+  /** Account for x with weight w in the summary structure	*/
+  virtual void addWeighted(double x, double w) = 0;
+  /** Width of the intervals of the PMF view			*/
+  double getDX() const { return (getMax() - getMin()) / pmf_size; }
+  /** Sum the moments of another statistic into this one	*/
+  void mergeMoments(const QuantileStat & qs);
+
+ public:
+
+  typedef BaseStat parent;
+
+  /** Feed with next sample					*/
+  void addSample(double x);
+  /** Feed with next sample at time t (time-weighted mode)	*/
+  void addSample(double x, double t);
+  /** Get number of samples   */
+  virtual long getNumSamples() const { return num_samples; }
+  virtual double getWeight() const { return w_sum; }
+  virtual double getWeightPos() const { return w_sum_pos; }
+  /** Return mean of provided samples				*/
+  double getMean() const;
+  /** Return mean of positive provided samples			*/
+  double getMeanPos() const;
+  /** Return mean of negative or zero provided samples		*/
+  double getMeanNegZero() const;
+  /** Return standard deviation of provided samples		*/
+  double getDev() const;
+  /** Return mean of absolute values of provided samples        */
+  double getMeanAbs() const;
+  /** Evaluate the distribution function at a single point	*/
+  double getPDFValue(double x) const;
+  /** Return the n-th pmf sample				*/
+  double getPMFValue(long n_sample) const;
+  /** Sum up PMF values (always 1, as no sample is out of range)	*/
+  double sumPMFValues() const;
+  /** Return the PMF size					*/
+  long getPMFSize() const;
+  /** Return x value getPMFValue(n_sample) refers to		*/
+  double getXValue(long n_sample) const;
+
+  /** Return the estimated fraction of samples not greater than x	*/
+  virtual double getCDF(double x) const = 0;
+  /** Return the estimated p-quantile, with p in [0,1]		*/
+  virtual double getQuantile(double p) const = 0;
+  virtual double getPMFPercentile(double p) const { return getQuantile(p); }
+  /** Add the tail percentiles, that the summary keeps accurate	*/
+  virtual void dumpSummary(FILE *file) const;
+
+  /** Clear all accumulated statistics.				*/
+  virtual void clear() { clear(prev_t); }
+  virtual void clear(double now);
+};
+
+#endif
@@ -25,7 +25,7 @@
 
 RPRangeTrace::RPRangeTrace() {
   trace_fname = 0;
-  ff = 0;
+  p_reader = 0;
   num_samples = 0;
   curr_iv = Interval(0, 0);
 }
@@ -33,6 +33,8 @@ RPRangeTrace::RPRangeTrace() {
 RPRangeTrace::~RPRangeTrace() {
   if (trace_fname != 0)
     free(trace_fname);
+  if (p_reader != 0)
+    delete p_reader;
 }
 
 bool RPRangeTrace::parseArg(int& argc, char **& argv) {
@@ -64,21 +66,24 @@ void RPRangeTrace::addSample(double c_k) {
 
 /* Read next prediction interval from file */
 void RPRangeTrace::nextInterval() {
-  if (ff == 0) {
+  if (p_reader == 0) {
     printf("# Opening trace file: %s\n", trace_fname);
-    ff = fopen(trace_fname, "r");
-    ASSERT(ff != 0, "Couldn't find task trace file");
+    p_reader = new TraceReader(trace_fname);
   }
-  double lb, ub;
-  char line_buf[256];
-  if (fgets(line_buf, sizeof(line_buf), ff) != NULL) {
-    while (strlen(line_buf) == 0
-	   || sscanf(line_buf, "%lf %lf", &lb, &ub) != 2)
-    {
-      Logger::debugLog("Warning: skipping line: %s", line_buf);
-      if (fgets(line_buf, sizeof(line_buf), ff) == NULL)
-	break;
+  /* At end of trace, keep on using the last interval	*/
+  double lb = curr_iv.getMin(), ub = curr_iv.getMax();
+  const char *beg, *end;
+  const char *cols_beg[2], *cols_end[2];
+  while (p_reader->nextLine(&beg, &end)) {
+    double l, u;
+    if (TraceReader::splitColumns(beg, end, cols_beg, cols_end, 2) == 2
+	&& TraceReader::parseDouble(cols_beg[0], cols_end[0], &l)
+	&& TraceReader::parseDouble(cols_beg[1], cols_end[1], &u)) {
+      lb = l;
+      ub = u;
+      break;
     }
+    Logger::debugLog("Warning: skipping line %ld\n", p_reader->getLineNum());
   }
   if (lb < 0.0)
     lb = 0.0;
@@ -89,7 +94,7 @@ void RPRangeTrace::nextInterval() {
 
 /* Return range in which next sample would reside with high probability */
 Interval RPRangeTrace::getExpInterval() {
-  if (ff == 0)	// Only occurrs for 1st sample
+  if (p_reader == 0)	// Only occurrs for 1st sample
       nextInterval();
 
   return curr_iv;
@@ -22,8 +22,7 @@
 #  define _RP_RANGE_TRACE_H_
 
 #include "RangePredictor.hpp"
-
-#include <stdio.h>
+#include "TraceReader.hpp"
 
 using namespace std;
 
@@ -32,7 +31,7 @@ class RPRangeTrace : public RangePredictor {
  protected:
 
   char *trace_fname;
-  FILE *ff;
+  TraceReader *p_reader;
   int num_samples;	/** Just counting how many samples                */
   Interval curr_iv;	/** Current interval, used for statistics getters */
 
@@ -29,13 +29,17 @@
 RPStatBased::RPStatBased() {
   sample_size = 12;
   percentile = 0.83;
+  curr_iv_valid = false;
 }
 
 void RPStatBased::clearHistory() {
+  curr_iv_valid = false;
   q.clear();
+  q_sorted.clear();
 }
 
 bool RPStatBased::parseArg(int& argc, char **& argv) {
+  curr_iv_valid = false;
   if (strcmp(*argv, "-sb-ss") == 0) {
     CHECK(argc > 1, "Option requires an argument");
     argv++;  argc--;
@@ -57,21 +61,30 @@ void RPStatBased::usage() {
 
 /* Add a c_k sample */
 void RPStatBased::addSample(double c_k) {
+  curr_iv_valid = false;
   q.push_back(c_k);
+  q_sorted.insert(c_k);
   if ((int) q.size() > sample_size) {
     double c_old = *(q.begin());
-    Logger::debugLog("# RPStatBased::addSample() - Removing sample %g\n", c_old);
+    Logger::debugLogC(Logger::LOG_PRED, 2, "# RPStatBased::addSample() - Removing sample %g\n", c_old);
     q.pop_front();
+    q_sorted.erase(c_old);
   }
-  Logger::debugLog("# RPStatBased::addSample() - After addition: sample_size=%d, q.size=%d\n", sample_size, q.size());
+  Logger::debugLogC(Logger::LOG_PRED, 2, "# RPStatBased::addSample() - After addition: sample_size=%d, q.size=%d\n", sample_size, (int) q.size());
 }
 
 /* Return range in which next sample would reside with high probability */
 Interval RPStatBased::getExpInterval() {
-  Logger::debugLog("Queue dump: ");
-  for (deque<double>::const_iterator it = q.begin(); it != q.end(); ++it)
-    Logger::debugLog("%g, ", *it);
-  Logger::debugLog("\n");
+  /* Selections are redone only after samples or params change */
+  if (curr_iv_valid)
+    return curr_iv;
+
+  if (Logger::isEnabled(Logger::LOG_PRED, 3)) {
+    Logger::debugLogC(Logger::LOG_PRED, 3, "Queue dump: ");
+    for (deque<double>::const_iterator it = q.begin(); it != q.end(); ++it)
+      Logger::debugLogC(Logger::LOG_PRED, 3, "%g, ", *it);
+    Logger::debugLogC(Logger::LOG_PRED, 3, "\n");
+  }
 
   if (q.size() == 0)
     return Interval();
@@ -87,29 +100,33 @@ Interval RPStatBased::getExpInterval() {
 //  double min = Stat::getMinPercentile(q, percentile, a, b);
 //  double max = Stat::getMaxPercentile(q, percentile, a, b);
 
-  std::vector<double> v(q.begin(), q.end());
-  std::sort(v.begin(), v.end());
+  /* Order statistics are selected from q_sorted in O(log n), with no copies */
+  int n = q_sorted.size();
 
-  Logger::debugLog("Ordered queue dump: ");
-  for (vector<double>::const_iterator it = v.begin(); it != v.end(); ++it)
-    Logger::debugLog("%g, ", *it);
-  Logger::debugLog("\n");
+  if (Logger::isEnabled(Logger::LOG_PRED, 3)) {
+    Logger::debugLogC(Logger::LOG_PRED, 3, "Ordered queue dump: ");
+    for (int i = 0; i < n; ++i)
+      Logger::debugLogC(Logger::LOG_PRED, 3, "%g, ", q_sorted.select(i));
+    Logger::debugLogC(Logger::LOG_PRED, 3, "\n");
+  }
 
   // If I didn't make mistakes, this way the interval is always chosen symmetrically w.r.t. extremes of v[]
-  int discarded = round((1.0 - percentile) * v.size());
-  discarded = std::min<int>((v.size()-1)/2, discarded);
+  int discarded = round((1.0 - percentile) * n);
+  discarded = std::min<int>((n-1)/2, discarded);
   int min_idx = discarded;
-  int max_idx = v.size() - 1 - discarded;
-  Logger::debugLog("min_idx=%d, max_idx=%d\n", min_idx, max_idx);
-  ASSERT(min_idx >= 0 && min_idx < (int) v.size(), "min_idx out of range");
-  ASSERT(max_idx >= 0 && max_idx < (int) v.size(), "max_idx out of range");
+  int max_idx = n - 1 - discarded;
+  Logger::debugLogC(Logger::LOG_PRED, 2, "min_idx=%d, max_idx=%d\n", min_idx, max_idx);
+  ASSERT(min_idx >= 0 && min_idx < n, "min_idx out of range");
+  ASSERT(max_idx >= 0 && max_idx < n, "max_idx out of range");
   ASSERT(min_idx <= max_idx, "min_idx > max_idx");
 
-  double min = v[min_idx];
-  double max = v[max_idx];
+  double min = q_sorted.select(min_idx);
+  double max = q_sorted.select(max_idx);
 
-  Logger::debugLog("Computed percentiles: [%g, %g]\n", min, max);
-  return Interval(min, max);
+  Logger::debugLogC(Logger::LOG_PRED, 2, "Computed percentiles: [%g, %g]\n", min, max);
+  curr_iv = Interval(min, max);
+  curr_iv_valid = true;
+  return curr_iv;
 }
 
 void RPStatBased::setSampleSize(int new_size) {
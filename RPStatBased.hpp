@@ -22,6 +22,7 @@
 #  define _RP_STAT_BASED_H_
 
 #include "TaskPredictor.hpp"
+#include "OrderStatTree.hpp"
 
 #include <deque>
 
@@ -32,8 +33,11 @@ class RPStatBased : public RangePredictor {
 protected:
 
   std::deque<double> q;
+  OrderStatTree q_sorted;       /**< Same samples as q, for order statistics      */
   int sample_size;              /**< For estimating moveable mean and dev of c(k) */
   double percentile;            /**< Percentile at which to compute range         */
+  Interval curr_iv;             /**< Last computed range, if curr_iv_valid        */
+  bool curr_iv_valid;           /**< Reset whenever samples or params change      */
 
 public:
 
@@ -0,0 +1,216 @@
+/*
+ * ARSim
+ * Copyright (c) 2000-2010 Tommaso Cucinotta
+ *
+ * This file is part of ARSim.
+ *
+ * ARSim is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * ARSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with ARSim. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <cstring>
+
+#include "ReplayHarness.hpp"
+#include "Controller.hpp"
+#include "Task.hpp"
+#include "util.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <thread>
+#include <atomic>
+
+ReplayHarness *ReplayHarness::p_rpl = new ReplayHarness();
+
+ReplayHarness::ReplayHarness() {
+  rec_fname = NULL;
+  out_fname = "replay.dat";
+  grant_full = false;
+  num_threads = std::thread::hardware_concurrency();
+  if (num_threads < 1)
+    num_threads = 1;
+  T = c_min = c_max = 0.0;
+  inv_e = inv_E = 0.0;
+  inv_set = false;
+}
+
+void ReplayHarness::usage() {
+  printf("  CONTROLLER REPLAY OPTIONS\n");
+  printf("           -rpl     file: replay the controller settings over a job record (see -rec), instead of simulating\n");
+  printf("           -rpl-c   '-s type opts': controller type and options of a setting to replay (may be repeated)\n");
+  printf("           -rpl-g   ratio/full: scale the bandwidth as granted in the record (default), or grant it in full\n");
+  printf("           -rpl-inv e,E: invariant for pinv (defaults to the -inv-e, -inv-E of the recorded task)\n");
+  printf("           -rpl-j   n: number of replay threads (defaults to the number of CPUs)\n");
+  printf("           -rpl-o   file: results file (defaults to replay.dat)\n");
+}
+
+bool ReplayHarness::parseArg(int& argc, char **& argv) {
+  if (strcmp(*argv, "-rpl") == 0) {
+    CHECK(argc > 1, "Option requires an argument");
+    argv++;  argc--;
+    rec_fname = *argv;
+  } else if (strcmp(*argv, "-rpl-c") == 0) {
+    CHECK(argc > 1, "Option requires an argument");
+    argv++;  argc--;
+    Setting s;
+    s.opts = *argv;
+    s.p_ctrl = NULL;
+    settings.push_back(s);
+  } else if (strcmp(*argv, "-rpl-g") == 0) {
+    CHECK(argc > 1, "Option requires an argument");
+    argv++;  argc--;
+    if (strcmp(*argv, "ratio") == 0)
+      grant_full = false;
+    else if (strcmp(*argv, "full") == 0)
+      grant_full = true;
+    else
+      CHECK(0, "Expecting ratio or full as argument to -rpl-g option");
+  } else if (strcmp(*argv, "-rpl-inv") == 0) {
+    CHECK(argc > 1, "Option requires an argument");
+    argv++;  argc--;
+    CHECK(sscanf(*argv, "%lg,%lg", &inv_e, &inv_E) == 2, "Expecting e,E as argument to -rpl-inv option");
+    inv_set = true;
+  } else if (strcmp(*argv, "-rpl-j") == 0) {
+    CHECK(argc > 1, "Option requires an argument");
+    argv++;  argc--;
+    CHECK(sscanf(*argv, "%d", &num_threads) == 1 && num_threads > 0, "Expecting positive integer as argument to -rpl-j option");
+  } else if (strcmp(*argv, "-rpl-o") == 0) {
+    CHECK(argc > 1, "Option requires an argument");
+    argv++;  argc--;
+    out_fname = *argv;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+void ReplayHarness::load() {
+  FILE *f = fopen(rec_fname, "r");
+  CHECK1(f != NULL, "Could not open job record file %s", rec_fname);
+  char line[1024];
+  bool header = false;
+  double rec_inv_e = 0.0, rec_inv_E = 0.0;
+  while (fgets(line, sizeof(line), f) != NULL) {
+    if (line[0] == '#') {
+      if (sscanf(line, "# arsim-record: T=%lg c_min=%lg c_max=%lg inv_e=%lg inv_E=%lg",
+                 &T, &c_min, &c_max, &rec_inv_e, &rec_inv_E) == 5)
+        header = true;
+      continue;
+    }
+    long job_id;
+    JobRecord r;
+    CHECK1(sscanf(line, "%ld %lg %lg %lg %lg %lg", &job_id, &r.c, &r.start_err,
+                  &r.bw_req, &r.bw_granted, &r.sched_err) == 6,
+           "Wrong format of job record file %s", rec_fname);
+    jobs.push_back(r);
+  }
+  fclose(f);
+  CHECK1(header, "Missing arsim-record header in job record file %s", rec_fname);
+  CHECK1(jobs.size() > 0, "No jobs in job record file %s", rec_fname);
+  if (! inv_set) {
+    inv_e = rec_inv_e;
+    inv_E = rec_inv_E;
+  }
+  fprintf(stderr, "# Loaded %lu job records (T=%g) from %s\n", (unsigned long) jobs.size(), T, rec_fname);
+}
+
+/** Build the controller of a setting, parsing its options as the ones
+ ** following -s on the command-line
+ **/
+void ReplayHarness::setup(Setting & s) {
+  std::vector<char *> args;
+  char *opts = strdup(s.opts.c_str());
+  CHECK(opts != NULL, "No memory");
+  for (char *tok = strtok(opts, " \t"); tok != NULL; tok = strtok(NULL, " \t"))
+    args.push_back(tok);
+  CHECK(args.size() >= 2 && strcmp(args[0], "-s") == 0, "Expecting -s type at start of -rpl-c option");
+  s.p_ctrl = Controller::getInstance(args[1]);
+  CHECK(s.p_ctrl != NULL, "Wrong scheduler type in -rpl-c option");
+  Task *p_task = new Task();
+  p_task->setParams(T, c_min, c_max);
+  s.p_ctrl->setTask(p_task);
+  int argc = args.size() - 2;
+  char **argv = &args[0] + 2;
+  while (argc > 0) {
+    CHECK(s.p_ctrl->parseArg(argc, argv), "Unknown option in -rpl-c option");
+    argv++;  argc--;
+  }
+  s.p_ctrl->calcParams();
+  CHECK(s.p_ctrl->checkParams(), "Replay not possible with provided and default parameters");
+}
+
+void ReplayHarness::replay(Setting & s) const {
+  Controller *p_ctrl = s.p_ctrl;
+  double e = 0.0, bw_sum = 0.0, bw_granted_sum = 0.0, se_sum = 0.0, se_max = 0.0;
+  long num_inv = 0;
+  for (std::vector<JobRecord>::const_iterator it = jobs.begin(); it != jobs.end(); ++it) {
+    double start_err = e > 0.0 ? e : 0.0;
+    p_ctrl->getTaskPredictor()->setPerfectPrediction(it->c);
+    double b = p_ctrl->calcBandwidth(e, start_err);
+    double g = b;
+    if (! grant_full && it->bw_req > 0.0)
+      g = b * it->bw_granted / it->bw_req;
+    ASSERT(g > 0.0, "Replayed controller computed a null bandwidth");
+    e = start_err + it->c / g - T;
+    p_ctrl->setLastJobExecTime(it->c);
+    bw_sum += b;
+    bw_granted_sum += g;
+    se_sum += e;
+    if (it == jobs.begin() || e > se_max)
+      se_max = e;
+    if (e >= -inv_e && e <= inv_E)
+      num_inv++;
+  }
+  s.bw_avg = bw_sum / jobs.size();
+  s.bw_granted_avg = bw_granted_sum / jobs.size();
+  s.se_avg = se_sum / jobs.size() / T;
+  s.se_max = se_max / T;
+  s.pinv = double(num_inv) / jobs.size();
+}
+
+void ReplayHarness::run() {
+  load();
+  CHECK(settings.size() > 0, "Need at least one -rpl-c option");
+  Controller::setPredFileEnabled(false);
+  for (std::vector<Setting>::iterator it = settings.begin(); it != settings.end(); ++it)
+    setup(*it);
+
+#ifdef WITH_PROFILER
+  /* Profiler counters are not thread-safe */
+  num_threads = 1;
+#endif
+  double t0 = getWallClock();
+  std::atomic<size_t> next(0);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads && i < (int) settings.size(); ++i)
+    threads.push_back(std::thread([this, &next]() {
+      size_t k;
+      while ((k = next++) < settings.size())
+        replay(settings[k]);
+    }));
+  for (std::vector<std::thread>::iterator it = threads.begin(); it != threads.end(); ++it)
+    it->join();
+  fprintf(stderr, "# Replayed %lu jobs with %lu settings in %g s\n",
+          (unsigned long) jobs.size(), (unsigned long) settings.size(), getWallClock() - t0);
+
+  FILE *f = fopen(out_fname, "w");
+  CHECK1(f != NULL, "Could not open replay results file %s", out_fname);
+  fprintf(f, "# %4s %11s %11s %11s %11s %11s  %s\n",
+          "set", "bw", "bw_granted", "se_avg", "se_max", "pinv", "options");
+  for (size_t k = 0; k < settings.size(); ++k) {
+    const Setting & s = settings[k];
+    fprintf(f, "%6lu %11.5g %11.5g %11.5g %11.5g %11.5g  %s\n", (unsigned long) k,
+            s.bw_avg, s.bw_granted_avg, s.se_avg, s.se_max, s.pinv, s.opts.c_str());
+  }
+  fclose(f);
+}
@@ -0,0 +1,98 @@
+/*
+ * ARSim
+ * Copyright (c) 2000-2010 Tommaso Cucinotta
+ *
+ * This file is part of ARSim.
+ *
+ * ARSim is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * ARSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with ARSim. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef __ARSIM_REPLAY_HARNESS_HPP__
+#  define __ARSIM_REPLAY_HARNESS_HPP__
+
+#include "Component.hpp"
+
+#include <vector>
+#include <string>
+
+class Controller;
+
+/** Replay of a single task controller over a per-job record.
+ **
+ ** A record, written by a task with -rec, holds for each job its c_k,
+ ** start error, required and granted bandwidth, and scheduling error.
+ ** Each controller setting (-rpl-c) builds a stand-alone Controller plus
+ ** TaskPredictor stack, which is driven over the recorded c_k sequence in
+ ** a tight loop, without event list, supervisor nor dumps. The scheduling
+ ** error evolves as in a reservation receiving the computed bandwidth,
+ ** scaled by the ratio the supervisor granted in the recorded run (or
+ ** unscaled with -rpl-g full):
+ **
+ **   start_k = max(0, e_{k-1}),  e_k = start_k + c_k / g_k - T
+ **
+ ** Settings are replayed in parallel, and the average required/granted
+ ** bandwidth, scheduling error statistics and pinv (probability of the
+ ** scheduling error being within [-inv_e, inv_E]) of each one are written
+ ** to the output file.
+ **/
+class ReplayHarness : public Component {
+  static ReplayHarness *p_rpl;
+  friend class SimContext;
+
+  typedef struct {
+    double c;
+    double start_err;
+    double bw_req;
+    double bw_granted;
+    double sched_err;
+  } JobRecord;
+
+  typedef struct {
+    std::string opts;
+    Controller *p_ctrl;
+    double bw_avg, bw_granted_avg;
+    double se_avg, se_max;
+    double pinv;
+  } Setting;
+
+  const char *rec_fname;
+  const char *out_fname;
+  bool grant_full;
+  int num_threads;
+  double T, c_min, c_max;
+  double inv_e, inv_E;
+  bool inv_set;
+  std::vector<JobRecord> jobs;
+  std::vector<Setting> settings;
+
+  void load();
+  void setup(Setting & s);
+  void replay(Setting & s) const;
+
+public:
+
+  ReplayHarness();
+
+  static inline ReplayHarness *getInstance() { return p_rpl; }
+
+  static void usage();
+  virtual bool parseArg(int& argc, char **& argv);
+
+  bool isEnabled() const { return rec_fname != NULL; }
+
+  /** Replay all settings and write the results, instead of simulating	*/
+  void run();
+};
+
+#endif
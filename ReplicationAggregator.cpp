@@ -0,0 +1,123 @@
+/*
+ * ARSim
+ * Copyright (c) 2000-2010 Tommaso Cucinotta
+ *
+ * This file is part of ARSim.
+ *
+ * ARSim is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * ARSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with ARSim. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include "ReplicationAggregator.hpp"
+#include "DumpedStat.hpp"
+#include "util.hpp"
+
+#include <dirent.h>
+#include <sys/stat.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+
+/** 97.5% quantiles of the Student t, for 1 to 30 degrees of freedom	*/
+static const double t_quantiles[] = {
+  12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+  2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+  2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+};
+
+double ReplicationAggregator::getTQuantile(int dof) {
+  if (dof < 1)
+    return NAN;
+  if (dof <= 30)
+    return t_quantiles[dof - 1];
+  if (dof <= 40)
+    return 2.021;
+  if (dof <= 60)
+    return 2.000;
+  if (dof <= 120)
+    return 1.980;
+  return 1.960;
+}
+
+void ReplicationAggregator::listStatFiles(const char *dir, std::vector<std::string> & fnames) {
+  DIR *d = opendir(dir);
+  CHECK1(d != NULL, "Could not open replication directory %s", dir);
+  struct dirent *e;
+  while ((e = readdir(d)) != NULL) {
+    int len = strlen(e->d_name);
+    if (strstr(e->d_name, "_stats") != NULL && len > 4 && strcmp(e->d_name + len - 4, ".dat") == 0)
+      fnames.push_back(e->d_name);
+  }
+  closedir(d);
+  std::sort(fnames.begin(), fnames.end());
+}
+
+int ReplicationAggregator::aggregate(const char *out_dir, int num_dirs, char **dirs) {
+  CHECK(num_dirs >= 1, "No replication directories to aggregate");
+  mkdir(out_dir, 0777);
+  std::vector<std::string> fnames;
+  listStatFiles(dirs[0], fnames);
+
+  std::string ci_fname = std::string(out_dir) + "/replications.dat";
+  FILE *ci_file = fopen(ci_fname.c_str(), "w");
+  CHECK1(ci_file != NULL, "Could not open %s", ci_fname.c_str());
+  fprintf(ci_file, "# Summary values across %d replications: mean and 95%% confidence interval half-width\n",
+          num_dirs);
+  fprintf(ci_file, "# %-20s %-14s %4s %13s %13s %13s %13s %13s\n",
+          "file", "field", "n", "mean", "ci95", "dev", "min", "max");
+
+  int num_files = 0;
+  for (unsigned int f = 0; f < fnames.size(); ++f) {
+    std::vector<DumpedStat> reps(num_dirs);
+    bool ok = true;
+    for (int r = 0; r < num_dirs && ok; ++r) {
+      std::string path = std::string(dirs[r]) + "/" + fnames[f];
+      ok = reps[r].load(path.c_str());
+    }
+    if (!ok) {
+      fprintf(stderr, "Warning: skipping %s, missing or unreadable in some replications\n",
+              fnames[f].c_str());
+      continue;
+    }
+
+    /* Confidence intervals of the values reported by each replication */
+    const std::vector< std::pair<std::string, double> > & fields = reps[0].getFields();
+    for (unsigned int i = 0; i < fields.size(); ++i) {
+      double sum = 0.0, sqr_sum = 0.0, v_min = MAXDOUBLE, v_max = -MAXDOUBLE;
+      int n = 0;
+      for (int r = 0; r < num_dirs; ++r) {
+        const std::vector< std::pair<std::string, double> > & rf = reps[r].getFields();
+        if (i >= rf.size() || rf[i].first != fields[i].first)
+          continue;
+        double v = rf[i].second;
+        sum += v;
+        sqr_sum += v * v;
+        v_min = std::min(v_min, v);
+        v_max = std::max(v_max, v);
+        n++;
+      }
+      double mean = sum / n;
+      double dev = n > 1 ? sqrt(std::max(0.0, (sqr_sum - n * mean * mean) / (n - 1))) : 0.0;
+      double ci95 = n > 1 ? getTQuantile(n - 1) * dev / sqrt(double(n)) : NAN;
+      fprintf(ci_file, "  %-20s %-14s %4d %13.6g %13.6g %13.6g %13.6g %13.6g\n",
+              fnames[f].c_str(), fields[i].first.c_str(), n, mean, ci95, dev, v_min, v_max);
+    }
+
+    for (int r = 1; r < num_dirs; ++r)
+      reps[0].merge(reps[r]);
+    reps[0].dump((std::string(out_dir) + "/" + fnames[f]).c_str());
+    num_files++;
+  }
+  fclose(ci_file);
+  return num_files;
+}
@@ -0,0 +1,51 @@
+/*
+ * ARSim
+ * Copyright (c) 2000-2010 Tommaso Cucinotta
+ *
+ * This file is part of ARSim.
+ *
+ * ARSim is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * ARSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with ARSim. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef __ARSIM_REPLICATION_AGGREGATOR_HPP__
+#  define __ARSIM_REPLICATION_AGGREGATOR_HPP__
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+/** Aggregation of the stats files of independent replications of the same
+ ** configuration (e.g., the run directories of a scenario file differing
+ ** only by the seed).
+ **
+ ** Each *_stats*.dat file found in the first directory, and in all the
+ ** other ones, is merged into a file with the same name in the output
+ ** directory (see DumpedStat). Then, for each summary value in the files
+ ** (min, max, mean, deviation, percentiles, ...), the mean across the
+ ** replications and its 95% confidence interval (Student t) are written
+ ** to replications.dat in the output directory.
+ **/
+class ReplicationAggregator {
+  static void listStatFiles(const char *dir, std::vector<std::string> & fnames);
+
+public:
+
+  /** Aggregate the stats files in the num_dirs directories dirs into
+   ** out_dir, returning the number of aggregated files		*/
+  static int aggregate(const char *out_dir, int num_dirs, char **dirs);
+  /** 97.5% quantile of the Student t with dof degrees of freedom	*/
+  static double getTQuantile(int dof);
+};
+
+#endif
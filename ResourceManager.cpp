@@ -24,6 +24,7 @@
 
 #include "FileUtil.hpp"
 #include "util.hpp"
+#include "Profiler.hpp"
 
 #include <sstream>
 
@@ -65,10 +66,7 @@ bool ResourceManager::parseArg(int& argc, char **& argv) {
     Controller *p_sched = Controller::getInstance(*argv);
     CHECK(p_sched != NULL, "Wrong scheduler type");
 
-    p_sched->setResourceId(getResourceId());
-    TaskScheduler *p_tsched = new TaskScheduler(p_sched, p_gsched);
-    tasks.push_back(p_tsched);
-    p_sched->setControllerId(getTaskSchedulerPos(p_tsched));
+    addTaskScheduler(p_sched);
     Logger::debugLog("# Controller: %s\n", *argv);
   } else if (strcmp(*argv, "-sup") == 0) {
     CHECK(argc > 1, "Option requires an argument");
@@ -80,15 +78,9 @@ bool ResourceManager::parseArg(int& argc, char **& argv) {
   } else if (strcmp(*argv, "-spd") == 0) {
     CHECK(argc > 1, "Option requires an argument");
     argv++;  argc--;
-    speeds.clear();
-    speeds.push_back(1.0);
-    parseList(*argv, speeds);
-    Logger::debugLog("Read speeds: ");
-    for (vector<double>::iterator it = speeds.begin(); it != speeds.end(); ++it)
-      Logger::debugLog("%g, ", *it);
-    Logger::debugLog("\n");
-    delete p_pow_mode_stats;
-    p_pow_mode_stats = new TimeStat(0.0, (double) speeds.size(), 1.0, EventList::getTime());
+    vector<double> add_speeds;
+    parseList(*argv, add_speeds);
+    setSpeeds(add_speeds);
   } else if (strcmp(*argv, "-rm") == 0) {
     CHECK(argc > 1, "Option requires an argument");
     argv++;  argc--;
@@ -107,13 +99,36 @@ bool ResourceManager::parseArg(int& argc, char **& argv) {
   return true;
 }
 
+/** Create a new task scheduler driven by the supplied controller, appending it to this resource */
+TaskScheduler *ResourceManager::addTaskScheduler(Controller *p_sched) {
+  p_sched->setResourceId(getResourceId());
+  TaskScheduler *p_tsched = new TaskScheduler(p_sched, this);
+  tasks.push_back(p_tsched);
+  p_sched->setControllerId(getTaskSchedulerPos(p_tsched));
+  return p_tsched;
+}
+
+/** Set the power mode speeds following the first one, which is always 1.0 */
+void ResourceManager::setSpeeds(const vector<double> & add_speeds) {
+  speeds.clear();
+  speeds.push_back(1.0);
+  speeds.insert(speeds.end(), add_speeds.begin(), add_speeds.end());
+  Logger::debugLog("Read speeds: ");
+  for (vector<double>::iterator it = speeds.begin(); it != speeds.end(); ++it)
+    Logger::debugLog("%g, ", *it);
+  Logger::debugLog("\n");
+  delete p_pow_mode_stats;
+  p_pow_mode_stats = new TimeStat(0.0, (double) speeds.size(), 1.0, EventList::getTime());
+}
+
 /** Destroy previously set supervisor, if any, and properly link new supervisor */
 void ResourceManager::setSupervisor(Supervisor *p_spv) {
   CHECK(p_spv != NULL, "Trying to set a NULL supervisor");
   if (this->p_spv != NULL)
     delete this->p_spv;
   this->p_spv = p_spv;
-  p_spv->setTasks(&this->tasks);
+  p_spv->setTasks(&this->tasks, &this->task_table);
+  p_spv->setResourceId(rs_id);
 }
 
 void ResourceManager::calcParamsAll() {
@@ -124,8 +139,12 @@ void ResourceManager::calcParamsAll() {
 
 void ResourceManager::calcParams() {
   vector<TaskScheduler*>::iterator it = tasks.begin();
-  for (; it != tasks.end(); ++it)
-    (*it)->getController()->calcParams();
+  for (; it != tasks.end(); ++it) {
+    /* The CRN stream of a task is keyed by its position, not by its id, which
+     * depends on how many Task objects the configuration happened to build */
+    (*it)->getTask()->setStreamId(((uint64_t) rs_id << 32) | (it - tasks.begin()));
+    (*it)->calcParams();
+  }
   p_pow_mode_stats->addSample(pow_mode, EventList::getTime());
 }
 
@@ -148,6 +167,7 @@ bool ResourceManager::checkParams() {
 }
 
 void ResourceManager::handleSimStart(const Event & ev) {
+  PROF_NAME(p_spv, "Supervisor " + getResourceName());
   vector<TaskScheduler*>::iterator it = tasks.begin();
   for (; it != tasks.end(); it++)
     (*it)->handleSimStart(ev);
@@ -164,6 +184,7 @@ void ResourceManager::handleSimStart(const Event & ev) {
 // }
 
 void ResourceManager::handleJobArrive(const Event & ev) {
+  PROF_SCOPE("handleJobArrive", ev.p_data);
   TaskScheduler *p_tsched = (TaskScheduler *) ev.p_data;
   ASSERT(p_tsched != 0, "No TaskScheduler defined for this event");
   p_tsched->handleJobArrive(ev);
@@ -172,13 +193,21 @@ void ResourceManager::handleJobArrive(const Event & ev) {
 }
 
 void ResourceManager::handleJobStart(const Event & ev) {
+  PROF_SCOPE("handleJobStart", ev.p_data);
   TaskScheduler *p_tsched = (TaskScheduler *) ev.p_data;
   p_tsched->handleJobStart(ev);
-  /* New job could have caused overload		*/
+  /* New job could have caused overload, unless its start has been
+   * deferred to the ControllerBank				*/
+  if (p_tsched->isRunning())
+    p_spv->checkGlobalConstraint(tasks);
+}
+
+void ResourceManager::checkGlobalConstraint(const Event & ev) {
   p_spv->checkGlobalConstraint(tasks);
 }
 
 void ResourceManager::handleJobEnd(const Event & ev) {
+  PROF_SCOPE("handleJobEnd", ev.p_data);
   TaskScheduler *p_tsched = (TaskScheduler *) ev.p_data;
   p_tsched->handleJobEnd(ev);
   /* Ended job could cause overload end		*/
@@ -186,6 +215,7 @@ void ResourceManager::handleJobEnd(const Event & ev) {
 }
 
 void ResourceManager::dump() {
+  PROF_SCOPE("dump", 0);
   vector<ResourceManager*>::iterator rs_it = rs_controllers.begin();
   for (; rs_it != rs_controllers.end(); ++rs_it) {
     vector<TaskScheduler*>::iterator it = (*rs_it)->tasks.begin();
@@ -195,6 +225,7 @@ void ResourceManager::dump() {
 }
 
 void ResourceManager::dumpStatistics() {
+  PROF_SCOPE("dumpStatistics", 0);
   vector<ResourceManager*>::iterator rs_it = rs_controllers.begin();
   for (int r = 0; rs_it != rs_controllers.end(); ++rs_it, ++r) {
     vector<TaskScheduler*>::iterator it = (*rs_it)->tasks.begin();
@@ -240,6 +271,10 @@ long ResourceManager::getLastFinishedJobID(unsigned int num_task) {
   return tasks[num_task]->getLastFinishedJobID();
 }
 ResourceManager::~ResourceManager() {
+  for (vector<TaskScheduler*>::iterator it = tasks.begin(); it != tasks.end(); ++it)
+    delete *it;
+  delete p_pow_mode_stats;
+  delete p_spv;
 }
 
 TaskScheduler *ResourceManager::getTaskSchedulerAt(unsigned int tsk) {
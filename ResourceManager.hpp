@@ -27,6 +27,7 @@
 #include "Events.hpp"
 #include "Supervisor.hpp"
 #include "LinearModel.hpp"
+#include "TaskTable.hpp"
 
 /** System includes			*/
 
@@ -40,8 +41,10 @@ class ResourceManager {
 protected:
 
   vector<TaskScheduler*> tasks;	/**< Tasks to be scheduled	*/
+  TaskTable task_table;		/**< SoA copy of tasks data, for p_spv */
   string rs_name;		/**< Resource name		*/
   static int next_rs_id;
+  friend class SimContext;
   int rs_id;
   Supervisor *p_spv;		/**< The supervisor		*/
   vector<double> speeds;        /**< Speed corresponding to each power mode */
@@ -59,6 +62,7 @@ public:
   virtual bool parseArg(int& argc, char **& argv);
 
   void setResourceName(const char *rs_name);
+  const string & getResourceName() const { return rs_name; }
   int getResourceId() const { return rs_id; }
 
   Supervisor *getSupervisor() const { return p_spv; }
@@ -108,6 +112,18 @@ public:
   /** Retrieve number of tasks in this resource		*/
   unsigned int getTaskSchedulerNum() const { return tasks.size(); }
 
+  /** Per-task data read by the supervisor, kept in sync by TaskScheduler	*/
+  TaskTable & getTaskTable() { return task_table; }
+
+  /** Add a task scheduler driven by the supplied controller	*/
+  TaskScheduler *addTaskScheduler(Controller *p_sched);
+
+  /** Set the additional power mode speeds (the first one is 1.0)	*/
+  void setSpeeds(const vector<double> & add_speeds);
+
+  /** Retrieve number of power modes (zero if -spd not given yet)	*/
+  unsigned int getSpeedsNum() const { return speeds.size(); }
+
   /** Set supervisor							*/
   void setSupervisor(Supervisor *p_spv);
 
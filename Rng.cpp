@@ -0,0 +1,47 @@
+/*
+ * ARSim
+ * Copyright (c) 2000-2010 Tommaso Cucinotta
+ *
+ * This file is part of ARSim.
+ *
+ * ARSim is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * ARSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with ARSim. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include "Rng.hpp"
+
+#include <math.h>
+
+void Rng::setSeed(uint64_t seed) {
+  for (int i = 0; i < 4; ++i)
+    s[i] = splitmix64(seed);
+  has_gauss = false;
+}
+
+/* Marsaglia polar method, caching the second sample */
+double Rng::nextGaussian() {
+  if (has_gauss) {
+    has_gauss = false;
+    return gauss;
+  }
+  double u, v, r;
+  do {
+    u = 2.0 * nextDouble() - 1.0;
+    v = 2.0 * nextDouble() - 1.0;
+    r = u * u + v * v;
+  } while (r >= 1.0 || r == 0.0);
+  double f = sqrt(-2.0 * log(r) / r);
+  gauss = v * f;
+  has_gauss = true;
+  return u * f;
+}
@@ -0,0 +1,72 @@
+/*
+ * ARSim
+ * Copyright (c) 2000-2010 Tommaso Cucinotta
+ *
+ * This file is part of ARSim.
+ *
+ * ARSim is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * ARSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with ARSim. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef __ARSIM_RNG_HPP__
+#  define __ARSIM_RNG_HPP__
+
+#include <stdint.h>
+
+/** Small and fast per-object random number generator (xoshiro256**),
+ ** seeded through splitmix64, so that each task may own an independent
+ ** stream not perturbing, nor perturbed by, the global random() one.
+ **/
+class Rng {
+  uint64_t s[4];
+  bool has_gauss;
+  double gauss;
+
+  static inline uint64_t rotl(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+  }
+
+public:
+
+  Rng(uint64_t seed = 0) { setSeed(seed); }
+
+  /** Reset the stream to the one identified by seed		*/
+  void setSeed(uint64_t seed);
+
+  /** splitmix64 step, also usable as a stateless 64-bit mixer	*/
+  static inline uint64_t splitmix64(uint64_t & x) {
+    uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+  }
+
+  uint64_t next() {
+    uint64_t result = rotl(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl(s[3], 45);
+    return result;
+  }
+
+  /** Uniform double in [0,1)					*/
+  double nextDouble() { return (next() >> 11) * (1.0 / 9007199254740992.0); }
+  /** Standard normal sample					*/
+  double nextGaussian();
+};
+
+#endif
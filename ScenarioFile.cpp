@@ -0,0 +1,403 @@
+/*
+ * ARSim
+ * Copyright (c) 2000-2010 Tommaso Cucinotta
+ *
+ * This file is part of ARSim.
+ *
+ * ARSim is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * ARSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with ARSim. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <cstring>
+
+#include "ScenarioFile.hpp"
+#include "Rng.hpp"
+#include "util.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <algorithm>
+
+ScenarioFile *ScenarioFile::p_scn = new ScenarioFile();
+
+ScenarioFile::ScenarioFile() {
+  fname = NULL;
+  err_line = 0;
+  mode = SCN_CARTESIAN;
+  num_lhs_runs = 0;
+  seed = 0;
+  run_dir_fmt = "run%04d";
+  max_jobs = sysconf(_SC_NPROCESSORS_ONLN);
+  if (max_jobs < 1)
+    max_jobs = 1;
+  dry_run = false;
+}
+
+void ScenarioFile::usage() {
+  printf("  SCENARIO FILE OPTIONS\n");
+  printf("           -scn      file: read the scenario from file, forking off one run per sweep point\n");
+  printf("           -scn-j    n: maximum number of concurrent runs (defaults to the number of CPUs)\n");
+  printf("           -scn-dir  fmt: printf() format of run directories, given the run index (defaults to run%%04d)\n");
+  printf("           -scn-list List the options of each run, without running them\n");
+  printf("                     (-scn-* options need to precede -scn)\n");
+}
+
+bool ScenarioFile::parseArg(int& argc, char **& argv) {
+  if (strcmp(*argv, "-scn-j") == 0) {
+    CHECK(argc > 1, "Option requires an argument");
+    argv++;  argc--;
+    CHECK(sscanf(*argv, "%d", &max_jobs) == 1 && max_jobs > 0, "Expecting positive integer as argument to -scn-j option");
+  } else if (strcmp(*argv, "-scn-dir") == 0) {
+    CHECK(argc > 1, "Option requires an argument");
+    argv++;  argc--;
+    run_dir_fmt = *argv;
+  } else if (strcmp(*argv, "-scn-list") == 0) {
+    dry_run = true;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+void ScenarioFile::check(bool cond, const char *msg) const {
+  if (! cond) {
+    char err[512];
+    snprintf(err, sizeof(err), "%s:%d: %s", fname, err_line, msg);
+    CHECK(false, err);
+  }
+}
+
+static std::string trim(const std::string & s) {
+  size_t beg = s.find_first_not_of(" \t\r\n");
+  if (beg == std::string::npos)
+    return "";
+  size_t end = s.find_last_not_of(" \t\r\n");
+  return s.substr(beg, end - beg + 1);
+}
+
+static void split(const std::string & s, const char *seps, std::vector<std::string> & toks) {
+  size_t beg = 0;
+  while ((beg = s.find_first_not_of(seps, beg)) != std::string::npos) {
+    size_t end = s.find_first_of(seps, beg);
+    if (end == std::string::npos)
+      end = s.size();
+    toks.push_back(s.substr(beg, end - beg));
+    beg = end;
+  }
+}
+
+void ScenarioFile::load(const char *fname) {
+  this->fname = fname;
+  FILE *f = fopen(fname, "r");
+  CHECK1(f != NULL, "Could not open scenario file %s", fname);
+  char buf[4096];
+  CHECK(getcwd(buf, sizeof(buf)) != NULL, "Could not get current directory");
+  cwd = buf;
+
+  std::string sect = "global", sect_arg;
+  int sect_line = 0, line_num = 0, num_res = 0;
+  std::vector< std::pair<std::string, std::string> > keys;
+  while (fgets(buf, sizeof(buf), f) != NULL) {
+    line_num++;
+    err_line = line_num;
+    std::string line = trim(buf);
+    if (line.size() == 0 || line[0] == '#')
+      continue;
+    if (line[0] == '[') {
+      check(line[line.size() - 1] == ']', "Expecting ']' at end of section header");
+      err_line = sect_line;
+      emitSection(sect, sect_arg, keys, num_res);
+      if (sect == "resource")
+        num_res++;
+      keys.clear();
+      std::vector<std::string> toks;
+      split(line.substr(1, line.size() - 2), " \t", toks);
+      err_line = sect_line = line_num;
+      check(toks.size() >= 1 && toks.size() <= 2, "Expecting [section] or [section arg]");
+      sect = toks[0];
+      sect_arg = toks.size() > 1 ? toks[1] : "";
+      continue;
+    }
+    size_t eq = line.find('=');
+    check(eq != std::string::npos && eq > 0, "Expecting key = value");
+    keys.push_back(make_pair(trim(line.substr(0, eq)), trim(line.substr(eq + 1))));
+  }
+  fclose(f);
+  err_line = sect_line;
+  emitSection(sect, sect_arg, keys, num_res);
+
+  if (mode == SCN_LHS)
+    expandLHS();
+  else
+    expandCartesian();
+  fprintf(stderr, "# Scenario %s: %lu options, %lu sweep axes, %lu runs\n",
+          fname, (unsigned long) tmpl.size(), (unsigned long) axes.size(), (unsigned long) runs.size());
+}
+
+void ScenarioFile::emitOption(const std::string & key, const std::string & value) {
+  if (key == "options") {
+    split(value, " \t", tmpl);
+    return;
+  }
+  tmpl.push_back("-" + key);
+  if (value.size() > 0)
+    tmpl.push_back(value);
+}
+
+/** Translate a section into the equivalent command-line options	*/
+void ScenarioFile::emitSection(const std::string & sect, const std::string & sect_arg,
+                               const std::vector< std::pair<std::string, std::string> > & keys, int num_res) {
+  std::vector< std::pair<std::string, std::string> >::const_iterator it;
+  if (sect == "global") {
+    for (it = keys.begin(); it != keys.end(); ++it)
+      emitOption(it->first, it->second);
+  } else if (sect == "optimizer") {
+    for (it = keys.begin(); it != keys.end(); ++it) {
+      if (it->first == "type")
+        emitOption("gc-type", it->second);
+      else if (it->first == "nums")
+        emitOption("gc-nums", it->second);
+      else if (it->first == "period")
+        emitOption("gc-p", it->second);
+      else
+        emitOption(it->first, it->second);
+    }
+  } else if (sect == "resource") {
+    /* The first resource is created by default */
+    if (num_res > 0)
+      tmpl.push_back("-r");
+    if (sect_arg.size() > 0)
+      emitOption("rn", sect_arg);
+    for (it = keys.begin(); it != keys.end(); ++it) {
+      if (it->first == "speeds")
+        emitOption("spd", it->second);
+      else if (it->first == "supervisor")
+        emitOption("sup", it->second);
+      else if (it->first == "name")
+        emitOption("rn", it->second);
+      else
+        emitOption(it->first, it->second);
+    }
+  } else if (sect == "task") {
+    /* Controller first, as it creates the task, then its type */
+    const char *first_keys[][2] = { { "controller", "s" }, { "type", "t" } };
+    for (int i = 0; i < 2; ++i) {
+      for (it = keys.begin(); it != keys.end(); ++it)
+        if (it->first == first_keys[i][0] || it->first == first_keys[i][1])
+          break;
+      check(i > 0 || it != keys.end(), "Missing controller in [task] section");
+      if (it != keys.end())
+        emitOption(first_keys[i][1], it->second);
+    }
+    for (it = keys.begin(); it != keys.end(); ++it) {
+      if (it->first == "controller" || it->first == "s" || it->first == "type" || it->first == "t")
+        continue;
+      else if (it->first == "period")
+        emitOption("T", it->second);
+      else
+        emitOption(it->first, it->second);
+    }
+  } else if (sect == "sweep") {
+    for (it = keys.begin(); it != keys.end(); ++it)
+      parseSweepKey(it->first, it->second);
+  } else {
+    check(false, "Unknown section (global/optimizer/resource/task/sweep)");
+  }
+}
+
+void ScenarioFile::parseSweepKey(const std::string & key, const std::string & value) {
+  if (key == "mode") {
+    if (value == "cartesian")
+      mode = SCN_CARTESIAN;
+    else if (value == "lhs")
+      mode = SCN_LHS;
+    else
+      check(false, "Expecting cartesian or lhs as sweep mode");
+  } else if (key == "runs") {
+    check(sscanf(value.c_str(), "%d", &num_lhs_runs) == 1 && num_lhs_runs > 0, "Expecting positive integer as number of runs");
+  } else if (key == "seed") {
+    unsigned long long s;
+    check(sscanf(value.c_str(), "%llu", &s) == 1, "Expecting natural as sweep seed");
+    seed = s;
+  } else {
+    check(key.find_first_not_of("abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_") == std::string::npos
+          && key != "run" && key != "cwd", "Invalid sweep axis name");
+    Axis axis;
+    axis.name = key;
+    axis.lo = axis.hi = 0.0;
+    axis.num_steps = 0;
+    if (value.find(':') != std::string::npos) {
+      int n = sscanf(value.c_str(), "%lg:%lg:%d", &axis.lo, &axis.hi, &axis.num_steps);
+      check(n >= 2 && (n == 2 || axis.num_steps > 0), "Expecting lo:hi[:n] as sweep range");
+    } else {
+      split(value, ",", axis.values);
+      check(axis.values.size() > 0, "Expecting comma-separated values as sweep axis");
+    }
+    axes.push_back(axis);
+  }
+}
+
+static std::string formatValue(double v) {
+  char buf[32];
+  snprintf(buf, sizeof(buf), "%.10g", v);
+  return buf;
+}
+
+void ScenarioFile::expandCartesian() {
+  long num_runs = 1;
+  for (std::vector<Axis>::iterator it = axes.begin(); it != axes.end(); ++it) {
+    if (it->values.size() == 0) {
+      CHECK1(it->num_steps > 0, "Sweep range %s needs a number of values (lo:hi:n) for a cartesian sweep", it->name.c_str());
+      for (int k = 0; k < it->num_steps; ++k)
+        it->values.push_back(formatValue(it->num_steps == 1 ? it->lo
+                                         : it->lo + k * (it->hi - it->lo) / (it->num_steps - 1)));
+    }
+    num_runs *= it->values.size();
+  }
+  runs.resize(num_runs);
+  /* Mixed-radix enumeration, with the last axis varying fastest */
+  for (long r = 0; r < num_runs; ++r) {
+    long idx = r;
+    for (int a = axes.size() - 1; a >= 0; --a) {
+      runs[r][axes[a].name] = axes[a].values[idx % axes[a].values.size()];
+      idx /= axes[a].values.size();
+    }
+  }
+}
+
+/** Latin hypercube: each axis is split into as many strata as runs, and
+ ** each stratum of each axis is used by exactly one run
+ **/
+void ScenarioFile::expandLHS() {
+  CHECK(num_lhs_runs > 0, "Latin-hypercube sweep requires runs = N in [sweep] section");
+  Rng rng(seed);
+  runs.resize(num_lhs_runs);
+  std::vector<int> perm(num_lhs_runs);
+  for (std::vector<Axis>::iterator it = axes.begin(); it != axes.end(); ++it) {
+    for (int i = 0; i < num_lhs_runs; ++i)
+      perm[i] = i;
+    for (int i = num_lhs_runs - 1; i > 0; --i)
+      std::swap(perm[i], perm[rng.next() % (i + 1)]);
+    for (int r = 0; r < num_lhs_runs; ++r) {
+      double x = (perm[r] + rng.nextDouble()) / num_lhs_runs;
+      if (it->values.size() > 0) {
+        size_t k = (size_t) (x * it->values.size());
+        runs[r][it->name] = it->values[MIN(k, it->values.size() - 1)];
+      } else
+        runs[r][it->name] = formatValue(it->lo + x * (it->hi - it->lo));
+    }
+  }
+}
+
+/** Replace ${name} references with the values of the run		*/
+std::string ScenarioFile::expand(const std::string & s, int run) const {
+  std::string out;
+  size_t pos = 0, beg;
+  while ((beg = s.find("${", pos)) != std::string::npos) {
+    size_t end = s.find('}', beg);
+    CHECK1(end != std::string::npos, "Unterminated variable reference in scenario option %s", s.c_str());
+    std::string name = s.substr(beg + 2, end - beg - 2);
+    out += s.substr(pos, beg - pos);
+    if (name == "run") {
+      char buf[16];
+      snprintf(buf, sizeof(buf), "%d", run);
+      out += buf;
+    } else if (name == "cwd") {
+      out += cwd;
+    } else {
+      std::map<std::string, std::string>::const_iterator it = runs[run].find(name);
+      CHECK1(it != runs[run].end(), "Unknown variable %s in scenario file", name.c_str());
+      out += it->second;
+    }
+    pos = end + 1;
+  }
+  return out + s.substr(pos);
+}
+
+void ScenarioFile::prepareRun(int run) {
+  run_args.clear();
+  for (std::vector<std::string>::iterator it = tmpl.begin(); it != tmpl.end(); ++it) {
+    char *s = strdup(expand(*it, run).c_str());
+    CHECK(s != NULL, "No memory");
+    run_args.push_back(s);
+  }
+}
+
+/** Wait for a run to terminate, returning 1 if it failed		*/
+static int waitRun() {
+  int status;
+  CHECK(wait(&status) > 0, "wait() failed");
+  return WIFEXITED(status) && WEXITSTATUS(status) == 0 ? 0 : 1;
+}
+
+void ScenarioFile::fanOut(int & argc, char **& argv) {
+  if (dry_run) {
+#ifdef ARSIM_EMBEDDED
+    checkFailed("Option %s is not available in the embedded simulator", "-scn-list");
+#endif
+    for (int r = 0; r < getNumRuns(); ++r) {
+      prepareRun(r);
+      printf("%d:", r);
+      for (std::vector<char *>::iterator it = run_args.begin(); it != run_args.end(); ++it)
+        printf(" %s", *it);
+      printf("\n");
+    }
+    exit(0);
+  }
+  if (getNumRuns() == 1) {
+    prepareRun(0);
+    argc = run_args.size();
+    argv = argc > 0 ? &run_args[0] : NULL;
+    return;
+  }
+  int running = 0, failed = 0;
+  for (int r = 0; r < getNumRuns(); ++r) {
+    if (running == max_jobs) {
+      failed += waitRun();
+      running--;
+    }
+    fflush(stdout);
+    fflush(stderr);
+    pid_t pid = fork();
+    CHECK(pid >= 0, "fork() failed");
+    if (pid == 0) {
+      char dir[256];
+      snprintf(dir, sizeof(dir), run_dir_fmt, r);
+      CHECK1(mkdir(dir, 0755) == 0 || errno == EEXIST, "Could not create run directory %s", dir);
+      CHECK1(chdir(dir) == 0, "Could not enter run directory %s", dir);
+      CHECK(freopen("stdout.txt", "w", stdout) != NULL, "Could not redirect stdout");
+      CHECK(freopen("stderr.txt", "w", stderr) != NULL, "Could not redirect stderr");
+      prepareRun(r);
+      FILE *f = fopen("args.txt", "w");
+      CHECK(f != NULL, "Could not open file args.txt");
+      for (std::vector<char *>::iterator it = run_args.begin(); it != run_args.end(); ++it)
+        fprintf(f, "%s\n", *it);
+      fclose(f);
+      argc = run_args.size();
+      argv = argc > 0 ? &run_args[0] : NULL;
+      return;
+    }
+    running++;
+  }
+  while (running > 0) {
+    failed += waitRun();
+    running--;
+  }
+  fprintf(stderr, "# Completed %d runs, %d failed\n", getNumRuns(), failed);
+  exit(failed > 0 ? -1 : 0);
+}
@@ -0,0 +1,120 @@
+/*
+ * ARSim
+ * Copyright (c) 2000-2010 Tommaso Cucinotta
+ *
+ * This file is part of ARSim.
+ *
+ * ARSim is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * ARSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with ARSim. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef __ARSIM_SCENARIO_FILE_HPP__
+#  define __ARSIM_SCENARIO_FILE_HPP__
+
+#include "Component.hpp"
+
+#include <stdint.h>
+#include <vector>
+#include <string>
+#include <map>
+
+/** Declarative scenario file, expanded into one or more runs.
+ **
+ ** The file is made of sections, each one holding "key = value" lines:
+ **
+ **   [global]            options not bound to a resource (e.g., xj, so)
+ **   [optimizer]         global optimizer (type, nums, period, or gc-*)
+ **   [resource <name>]   starts a new resource (speeds, supervisor, ...)
+ **   [task]              adds a task to the last resource (controller,
+ **                       type, period, plus any task/controller option)
+ **   [sweep]             sweep axes and expansion mode
+ **
+ ** Any key not among the aliases above stands for the command-line option
+ ** with the same name prefixed by '-', the value being its argument (an
+ ** empty value denotes a flag), while an "options" key is split on blanks
+ ** and passed as is. Values may refer to sweep axes as ${name}, as well as
+ ** to ${run} (run index) and ${cwd} (directory arsim was started from).
+ **
+ ** In the [sweep] section, "name = v1,v2,..." defines an axis with the
+ ** listed values and "name = lo:hi[:n]" an axis over a real range (with n
+ ** evenly spaced values when expanded as a cartesian product). With
+ ** "mode = cartesian" (default) all combinations are run, with "mode = lhs"
+ ** "runs = N" runs are drawn as a Latin hypercube (see also "seed").
+ **
+ ** The file is parsed and expanded once, then each run is forked off in
+ ** its own directory, parsing its options as if given on the command-line.
+ **/
+class ScenarioFile : public Component {
+  static ScenarioFile *p_scn;
+  friend class SimContext;
+
+  typedef enum { SCN_CARTESIAN, SCN_LHS } SweepMode;
+
+  typedef struct {
+    std::string name;
+    std::vector<std::string> values;	/**< Listed values, if not a range	*/
+    double lo, hi;
+    int num_steps;			/**< Values of a range in a cartesian sweep */
+  } Axis;
+
+  const char *fname;
+  int err_line;				/**< Line reported by check()		*/
+  std::string cwd;
+  /** Options of a run, with unexpanded ${name} references	*/
+  std::vector<std::string> tmpl;
+  std::vector<Axis> axes;
+  SweepMode mode;
+  int num_lhs_runs;
+  uint64_t seed;
+  /** Values of the axes for each run				*/
+  std::vector< std::map<std::string, std::string> > runs;
+
+  const char *run_dir_fmt;
+  int max_jobs;
+  bool dry_run;
+  /** Options of the run handled by this process, never freed	*/
+  std::vector<char *> run_args;
+
+  void check(bool cond, const char *msg) const;
+  void emitOption(const std::string & key, const std::string & value);
+  void emitSection(const std::string & sect, const std::string & sect_arg,
+                   const std::vector< std::pair<std::string, std::string> > & keys, int num_res);
+  void parseSweepKey(const std::string & key, const std::string & value);
+  void expandCartesian();
+  void expandLHS();
+  std::string expand(const std::string & s, int run) const;
+  void prepareRun(int run);
+
+public:
+
+  ScenarioFile();
+
+  static inline ScenarioFile *getInstance() { return p_scn; }
+
+  static void usage();
+  virtual bool parseArg(int& argc, char **& argv);
+
+  /** Parse the scenario file and expand its sweep axes into runs	*/
+  void load(const char *fname);
+
+  /** Number of runs the scenario expands into			*/
+  int getNumRuns() const { return runs.size(); }
+
+  /** Fork off all runs, waiting for their completion. Returns only in
+   ** the child process, within the run directory, or directly if there
+   ** is a single run, setting argc and argv to the options of the run.
+   **/
+  void fanOut(int & argc, char **& argv);
+};
+
+#endif
@@ -0,0 +1,267 @@
+/*
+ * ARSim
+ * Copyright (c) 2000-2010 Tommaso Cucinotta
+ *
+ * This file is part of ARSim.
+ *
+ * ARSim is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * ARSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with ARSim. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <cstring>
+
+#include "ScenarioGenerator.hpp"
+#include "ResourceManager.hpp"
+#include "GlobalOptimizer.hpp"
+#include "Controller.hpp"
+#include "TaskFactory.hpp"
+#include "FileUtil.hpp"
+#include "util.hpp"
+
+#include <math.h>
+
+ScenarioGenerator *ScenarioGenerator::p_gen = new ScenarioGenerator();
+
+ScenarioGenerator::ScenarioGenerator() {
+  num_rs = 1;
+  num_tasks = 0;
+  util = 0.5;
+  util_max = 1.0;
+  T_min = 20;
+  T_max = 200;
+  T_gran = 0;
+  T_dist = GEN_T_LOGUNI;
+  c_spread = 0.2;
+  pl_len = 1;
+  seed = 0;
+  add_speeds.push_back(1.0);
+  task_types.push_back("u");
+  ctrl_types.push_back("la");
+}
+
+void ScenarioGenerator::usage() {
+  printf("  SCENARIO GENERATOR OPTIONS\n");
+  printf("           -gen-n    n: generate n tasks on each resource (enables the generator)\n");
+  printf("           -gen-rs   r: number of resources to generate tasks on (defaults to 1)\n");
+  printf("           -gen-u    U: total utilization of each resource, split by UUniFast (defaults to 0.5)\n");
+  printf("           -gen-umax u: maximum utilization of a single task (defaults to 1.0)\n");
+  printf("           -gen-T    min,max: range of task periods (defaults to 20,200)\n");
+  printf("           -gen-Td   uni/log/harm: period distribution: uniform, log-uniform, or powers of 2 times min (defaults to log)\n");
+  printf("           -gen-Tg   g: round periods to multiples of g\n");
+  printf("           -gen-cv   s: execution times within u*T*(1-s) and u*T*(1+s) (defaults to 0.2)\n");
+  printf("           -gen-t    t1,t2,...: task types, assigned round-robin (defaults to u)\n");
+  printf("           -gen-s    s1,s2,...: controller types, assigned round-robin (defaults to la)\n");
+  printf("           -gen-a    'opts': task/controller options applied to each generated task\n");
+  printf("           -gen-pl   len: link consecutive tasks of each resource in pipelines of len tasks\n");
+  printf("           -gen-spd  s1,s2,...: additional speeds of generated resources without -spd (defaults to 1.0)\n");
+  printf("           -gen-seed n: seed the scenario is generated from (defaults to 0)\n");
+}
+
+/** Parse a comma-separated list of names */
+static void parseNames(const char *s, std::vector<std::string> & names) {
+  names.clear();
+  const char *p;
+  while ((p = strchr(s, ',')) != NULL) {
+    names.push_back(std::string(s, p - s));
+    s = p + 1;
+  }
+  names.push_back(std::string(s));
+}
+
+bool ScenarioGenerator::parseArg(int& argc, char **& argv) {
+  if (strcmp(*argv, "-gen-n") == 0) {
+    CHECK(argc > 1, "Option requires an argument");
+    argv++;  argc--;
+    CHECK(sscanf(*argv, "%d", &num_tasks) == 1 && num_tasks > 0, "Expecting positive integer as argument to -gen-n option");
+  } else if (strcmp(*argv, "-gen-rs") == 0) {
+    CHECK(argc > 1, "Option requires an argument");
+    argv++;  argc--;
+    CHECK(sscanf(*argv, "%d", &num_rs) == 1 && num_rs > 0, "Expecting positive integer as argument to -gen-rs option");
+  } else if (strcmp(*argv, "-gen-u") == 0) {
+    CHECK(argc > 1, "Option requires an argument");
+    argv++;  argc--;
+    CHECK(sscanf(*argv, "%lg", &util) == 1 && util > 0.0, "Expecting positive real as argument to -gen-u option");
+  } else if (strcmp(*argv, "-gen-umax") == 0) {
+    CHECK(argc > 1, "Option requires an argument");
+    argv++;  argc--;
+    CHECK(sscanf(*argv, "%lg", &util_max) == 1 && util_max > 0.0, "Expecting positive real as argument to -gen-umax option");
+  } else if (strcmp(*argv, "-gen-T") == 0) {
+    CHECK(argc > 1, "Option requires an argument");
+    argv++;  argc--;
+    CHECK(sscanf(*argv, "%lg,%lg", &T_min, &T_max) == 2 && T_min > 0.0 && T_max >= T_min,
+          "Expecting min,max with 0 < min <= max as argument to -gen-T option");
+  } else if (strcmp(*argv, "-gen-Td") == 0) {
+    CHECK(argc > 1, "Option requires an argument");
+    argv++;  argc--;
+    if (strcmp(*argv, "uni") == 0)
+      T_dist = GEN_T_UNI;
+    else if (strcmp(*argv, "log") == 0)
+      T_dist = GEN_T_LOGUNI;
+    else if (strcmp(*argv, "harm") == 0)
+      T_dist = GEN_T_HARM;
+    else
+      CHECK(0, "Expecting uni, log or harm as argument to -gen-Td option");
+  } else if (strcmp(*argv, "-gen-Tg") == 0) {
+    CHECK(argc > 1, "Option requires an argument");
+    argv++;  argc--;
+    CHECK(sscanf(*argv, "%lg", &T_gran) == 1 && T_gran >= 0.0, "Expecting non-negative real as argument to -gen-Tg option");
+  } else if (strcmp(*argv, "-gen-cv") == 0) {
+    CHECK(argc > 1, "Option requires an argument");
+    argv++;  argc--;
+    CHECK(sscanf(*argv, "%lg", &c_spread) == 1 && c_spread >= 0.0 && c_spread < 1.0,
+          "Expecting real in [0,1[ as argument to -gen-cv option");
+  } else if (strcmp(*argv, "-gen-t") == 0) {
+    CHECK(argc > 1, "Option requires an argument");
+    argv++;  argc--;
+    parseNames(*argv, task_types);
+  } else if (strcmp(*argv, "-gen-s") == 0) {
+    CHECK(argc > 1, "Option requires an argument");
+    argv++;  argc--;
+    parseNames(*argv, ctrl_types);
+  } else if (strcmp(*argv, "-gen-a") == 0) {
+    CHECK(argc > 1, "Option requires an argument");
+    argv++;  argc--;
+    char *s = strdup(*argv);
+    CHECK(s != NULL, "No memory");
+    for (char *tok = strtok(s, " \t"); tok != NULL; tok = strtok(NULL, " \t"))
+      task_args.push_back(tok);
+  } else if (strcmp(*argv, "-gen-pl") == 0) {
+    CHECK(argc > 1, "Option requires an argument");
+    argv++;  argc--;
+    CHECK(sscanf(*argv, "%d", &pl_len) == 1 && pl_len > 0, "Expecting positive integer as argument to -gen-pl option");
+  } else if (strcmp(*argv, "-gen-spd") == 0) {
+    CHECK(argc > 1, "Option requires an argument");
+    argv++;  argc--;
+    add_speeds.clear();
+    parseList(*argv, add_speeds);
+  } else if (strcmp(*argv, "-gen-seed") == 0) {
+    CHECK(argc > 1, "Option requires an argument");
+    argv++;  argc--;
+    unsigned long long s;
+    CHECK(sscanf(*argv, "%llu", &s) == 1, "Expecting natural as argument to -gen-seed option");
+    seed = s;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+/** UUniFast (Bini & Buttazzo), discarding sets with a task above util_max */
+void ScenarioGenerator::uuniFast(std::vector<double> & utils) {
+  int n = utils.size();
+  CHECK(util <= n * util_max, "Cannot reach -gen-u without exceeding -gen-umax");
+  bool ok;
+  do {
+    double sum_u = util;
+    ok = true;
+    for (int i = 1; i < n; ++i) {
+      double next_sum_u = sum_u * pow(rng.nextDouble(), 1.0 / (n - i));
+      utils[i - 1] = sum_u - next_sum_u;
+      sum_u = next_sum_u;
+    }
+    utils[n - 1] = sum_u;
+    for (int i = 0; i < n; ++i)
+      if (utils[i] > util_max)
+        ok = false;
+  } while (! ok);
+}
+
+double ScenarioGenerator::drawPeriod() {
+  double T;
+  switch (T_dist) {
+  case GEN_T_UNI:
+    T = T_min + rng.nextDouble() * (T_max - T_min);
+    break;
+  case GEN_T_LOGUNI:
+    T = exp(log(T_min) + rng.nextDouble() * (log(T_max) - log(T_min)));
+    break;
+  case GEN_T_HARM:
+  default:
+    T = T_min * pow(2.0, floor(rng.nextDouble() * (floor(log2(T_max / T_min)) + 1)));
+    break;
+  }
+  if (T_gran > 0.0) {
+    T = floor(T / T_gran + 0.5) * T_gran;
+    if (T < T_gran)
+      T = T_gran;
+  }
+  return T;
+}
+
+TaskScheduler *ScenarioGenerator::generateTask(ResourceManager *p_rm, int k, double T, double u) {
+  const char *ctrl_type = ctrl_types[k % ctrl_types.size()].c_str();
+  const char *task_type = task_types[k % task_types.size()].c_str();
+  Controller *p_sched = Controller::getInstance(ctrl_type);
+  CHECK(p_sched != NULL, "Wrong scheduler type in -gen-s option");
+  TaskScheduler *p_tsched = p_rm->addTaskScheduler(p_sched);
+  Task *p_task = TaskFactory::getInstance(task_type);
+  CHECK(p_task != 0, "Unknown task type in -gen-t option");
+  p_task->setParams(T, u * T * (1.0 - c_spread), u * T * (1.0 + c_spread));
+  p_sched->setTask(p_task);
+
+  int argc = task_args.size();
+  char **argv = argc > 0 ? &task_args[0] : NULL;
+  while (argc > 0) {
+    CHECK(p_tsched->parseArg(argc, argv), "Unknown option in -gen-a option");
+    argv++;  argc--;
+  }
+  Logger::debugLog("# Generated task %d,%d: %s/%s T=%g u=%g\n",
+		   k, p_rm->getResourceId(), task_type, ctrl_type, T, u);
+  return p_tsched;
+}
+
+void ScenarioGenerator::generate() {
+  if (! isEnabled())
+    return;
+  rng.setSeed(seed);
+  std::vector<double> utils(num_tasks);
+  for (int r = 0; r < num_rs; ++r) {
+    if (r >= (int) ResourceManager::rs_controllers.size())
+      new ResourceManager();
+    ResourceManager *p_rm = ResourceManager::rs_controllers[r];
+    if (p_rm->getSpeedsNum() == 0)
+      p_rm->setSpeeds(add_speeds);
+    p_gsched = p_rm;
+    uuniFast(utils);
+    int k0 = p_rm->getTaskSchedulerNum();
+    double T = 0.0;
+    TaskScheduler *p_prev = NULL;
+    for (int i = 0; i < num_tasks; ++i) {
+      bool head = (i % pl_len == 0);
+      if (head)
+        T = drawPeriod();
+      TaskScheduler *p_tsched = generateTask(p_rm, k0 + i, T, utils[i]);
+      if (! head) {
+        p_tsched->addPipelinePrev(p_prev);
+        p_prev->addPipelineNext(p_tsched);
+      }
+      p_prev = p_tsched;
+    }
+  }
+  fprintf(stderr, "# Generated %d tasks on %d resources (seed %llu)\n",
+          num_tasks * num_rs, num_rs, (unsigned long long) seed);
+
+  GlobalOptimizer *p_gc = GlobalOptimizer::getInstance();
+  if (! p_gc->hasNums()) {
+    unsigned int max_tasks = 0, min_speeds = 0;
+    std::vector<ResourceManager*>::iterator rs_it = ResourceManager::rs_controllers.begin();
+    for (; rs_it != ResourceManager::rs_controllers.end(); ++rs_it) {
+      if ((*rs_it)->getTaskSchedulerNum() > max_tasks)
+        max_tasks = (*rs_it)->getTaskSchedulerNum();
+      if (rs_it == ResourceManager::rs_controllers.begin() || (*rs_it)->getSpeedsNum() < min_speeds)
+        min_speeds = (*rs_it)->getSpeedsNum();
+    }
+    CHECK(min_speeds > 0, "Need to use -spd option");
+    p_gc->setNums(max_tasks, 1, ResourceManager::rs_controllers.size(), min_speeds);
+  }
+}
@@ -0,0 +1,98 @@
+/*
+ * ARSim
+ * Copyright (c) 2000-2010 Tommaso Cucinotta
+ *
+ * This file is part of ARSim.
+ *
+ * ARSim is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * ARSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with ARSim. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef __ARSIM_SCENARIO_GENERATOR_HPP__
+#  define __ARSIM_SCENARIO_GENERATOR_HPP__
+
+#include "Component.hpp"
+#include "Rng.hpp"
+
+#include <stdint.h>
+#include <vector>
+#include <string>
+
+class ResourceManager;
+class TaskScheduler;
+
+/** Built-in generator of large task sets, created directly in memory
+ ** rather than through long command-lines.
+ **
+ ** For each of the -gen-rs resources, -gen-n tasks are appended, whose
+ ** utilizations are drawn with UUniFast so that they sum up to -gen-u
+ ** (sets having a task above -gen-umax are discarded and redrawn).
+ ** Periods are drawn within -gen-T according to -gen-Td, and each
+ ** task execution times are spread around u*T by the -gen-cv ratio.
+ ** Task types and controllers are assigned round-robin out of the
+ ** -gen-t and -gen-s lists, and the options in -gen-a are then parsed
+ ** by each generated task, e.g., to tune controllers or task models.
+ ** With -gen-pl, consecutive tasks on a resource are linked in pipeline
+ ** chains sharing the period of their head. The whole scenario only
+ ** depends on -gen-seed.
+ **
+ ** Resources already defined on the command-line are filled first, and
+ ** further ones are created as needed. If -gc-nums is not given, the
+ ** optimization problem is sized after the generated scenario.
+ **/
+class ScenarioGenerator : public Component {
+  static ScenarioGenerator *p_gen;
+  friend class SimContext;
+
+public:
+
+  typedef enum { GEN_T_UNI, GEN_T_LOGUNI, GEN_T_HARM } PeriodDist;
+
+private:
+
+  int num_rs;
+  int num_tasks;
+  double util;
+  double util_max;
+  double T_min, T_max, T_gran;
+  PeriodDist T_dist;
+  double c_spread;
+  int pl_len;
+  uint64_t seed;
+  std::vector<std::string> task_types;
+  std::vector<std::string> ctrl_types;
+  std::vector<double> add_speeds;
+  /** Options parsed by each generated task (never freed, as they may be referenced) */
+  std::vector<char *> task_args;
+  Rng rng;
+
+  void uuniFast(std::vector<double> & utils);
+  double drawPeriod();
+  TaskScheduler *generateTask(ResourceManager *p_rm, int k, double T, double u);
+
+public:
+
+  ScenarioGenerator();
+
+  static inline ScenarioGenerator *getInstance() { return p_gen; }
+
+  static void usage();
+  virtual bool parseArg(int& argc, char **& argv);
+
+  bool isEnabled() const { return num_tasks > 0; }
+
+  /** Build the scenario, before parameters of all resources are computed */
+  void generate();
+};
+
+#endif
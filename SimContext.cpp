@@ -0,0 +1,135 @@
+/*
+ * ARSim
+ * Copyright (c) 2000-2010 Tommaso Cucinotta
+ *
+ * This file is part of ARSim.
+ *
+ * ARSim is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * ARSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with ARSim. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include "SimContext.hpp"
+#include "Events.hpp"
+#include "ResourceManager.hpp"
+#include "Task.hpp"
+#include "GlobalOptimizer.hpp"
+#include "TimelineExporter.hpp"
+#include "LiveMetrics.hpp"
+#include "StatSnapshot.hpp"
+#include "ScenarioGenerator.hpp"
+#include "ScenarioFile.hpp"
+#include "ReplayHarness.hpp"
+#include "ControllerBank.hpp"
+#include "util.hpp"
+
+#include <stdlib.h>
+#include <algorithm>
+
+SimContext::SimContext(unsigned int seed) {
+  p_events = new EventList();
+  next_rs_id = 0;
+  next_task_id = 0;
+  crn_enabled = false;
+  crn_seed = 0;
+
+  p_gc = new GlobalOptimizer();
+  p_tl = new TimelineExporter();
+  p_lm = new LiveMetrics();
+  p_ss = new StatSnapshot();
+  p_gen = new ScenarioGenerator();
+  p_scn = new ScenarioFile();
+  p_rpl = new ReplayHarness();
+  p_cb = new ControllerBank();
+
+  exit_cond = XC_JOB;
+  x_time = 1000000;
+  x_job = 10000;
+  x_tsk = 0;
+  x_rs = 0;
+  stat_only = false;
+  p_gsched = 0;
+
+  setstate(initstate(seed, rnd_state, sizeof(rnd_state)));
+  p_prev_rnd_state = 0;
+  entered = false;
+}
+
+void SimContext::swap() {
+  std::swap(p_events, EventList::p_events);
+  std::swap(rs_controllers, ResourceManager::rs_controllers);
+  std::swap(next_rs_id, ResourceManager::next_rs_id);
+  std::swap(next_task_id, Task::next_task_id);
+  std::swap(crn_enabled, Task::crn_enabled);
+  std::swap(crn_seed, Task::crn_seed);
+
+  std::swap(p_gc, GlobalOptimizer::p_gc);
+  std::swap(p_tl, TimelineExporter::p_tl);
+  std::swap(p_lm, LiveMetrics::p_lm);
+  std::swap(p_ss, StatSnapshot::p_ss);
+  std::swap(p_gen, ScenarioGenerator::p_gen);
+  std::swap(p_scn, ScenarioFile::p_scn);
+  std::swap(p_rpl, ReplayHarness::p_rpl);
+  std::swap(p_cb, ControllerBank::p_cb);
+
+  std::swap(exit_cond, ::exit_cond);
+  std::swap(x_time, ::x_time);
+  std::swap(x_job, ::x_job);
+  std::swap(x_tsk, ::x_tsk);
+  std::swap(x_rs, ::x_rs);
+  std::swap(stat_only, ::stat_only);
+  std::swap(p_gsched, ::p_gsched);
+}
+
+void SimContext::enter() {
+  ASSERT(! entered, "SimContext entered twice");
+  swap();
+  p_prev_rnd_state = setstate(rnd_state);
+  entered = true;
+}
+
+void SimContext::leave() {
+  ASSERT(entered, "SimContext left without being entered");
+  setstate(p_prev_rnd_state);
+  swap();
+  entered = false;
+}
+
+SimContext::~SimContext() {
+  if (! entered)
+    enter();
+  StatSnapshot::p_ss->close();
+  delete GlobalOptimizer::p_gc;
+  delete TimelineExporter::p_tl;
+  delete LiveMetrics::p_lm;
+  delete StatSnapshot::p_ss;
+  delete ScenarioGenerator::p_gen;
+  delete ScenarioFile::p_scn;
+  delete ReplayHarness::p_rpl;
+  delete ControllerBank::p_cb;
+  GlobalOptimizer::p_gc = 0;
+  TimelineExporter::p_tl = 0;
+  LiveMetrics::p_lm = 0;
+  StatSnapshot::p_ss = 0;
+  ScenarioGenerator::p_gen = 0;
+  ScenarioFile::p_scn = 0;
+  ReplayHarness::p_rpl = 0;
+  ControllerBank::p_cb = 0;
+
+  vector<ResourceManager*>::iterator it = ResourceManager::rs_controllers.begin();
+  for (; it != ResourceManager::rs_controllers.end(); ++it)
+    delete *it;
+  ResourceManager::rs_controllers.clear();
+  delete EventList::p_events;
+  EventList::p_events = 0;
+  leave();
+}
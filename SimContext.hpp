@@ -0,0 +1,100 @@
+/*
+ * ARSim
+ * Copyright (c) 2000-2010 Tommaso Cucinotta
+ *
+ * This file is part of ARSim.
+ *
+ * ARSim is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * ARSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with ARSim. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef __ARSIM_SIM_CONTEXT_HPP__
+#  define __ARSIM_SIM_CONTEXT_HPP__
+
+#include "globals.hpp"
+
+#include <vector>
+#include <stdint.h>
+
+using namespace std;
+
+class EventList;
+class GlobalOptimizer;
+class TimelineExporter;
+class LiveMetrics;
+class StatSnapshot;
+class ScenarioGenerator;
+class ScenarioFile;
+class ReplayHarness;
+class ControllerBank;
+
+/** The whole global state of a simulation: event list, resources,
+ ** id counters, CRN mode, singleton components, exit condition and
+ ** random() state.
+ **
+ ** The simulator keeps this state in static variables, so a context
+ ** allows several simulations to live within the same process, by
+ ** swapping its own state in with enter() and out with leave(). Only
+ ** one context may be entered at a time: callers are responsible for
+ ** serializing them (see arsim.h). The Logger, Profiler and TraceStore
+ ** remain shared by all contexts.
+ **/
+class SimContext {
+  EventList *p_events;
+  vector<ResourceManager*> rs_controllers;
+  int next_rs_id;
+  int next_task_id;
+  bool crn_enabled;
+  uint64_t crn_seed;
+
+  GlobalOptimizer *p_gc;
+  TimelineExporter *p_tl;
+  LiveMetrics *p_lm;
+  StatSnapshot *p_ss;
+  ScenarioGenerator *p_gen;
+  ScenarioFile *p_scn;
+  ReplayHarness *p_rpl;
+  ControllerBank *p_cb;
+
+  ExitCond exit_cond;
+  double x_time;
+  long int x_job;
+  int x_tsk;
+  int x_rs;
+  bool stat_only;
+  ResourceManager *p_gsched;
+
+  char rnd_state[256];          /**< State of random() for this context   */
+  char *p_prev_rnd_state;       /**< State of random() to restore on leave */
+  bool entered;
+
+  /** Exchange the context fields with the global state	*/
+  void swap();
+
+public:
+
+  /** Build a context with a fresh state, as at program start, seeding
+   ** random() with seed. The state is swapped in by enter().	*/
+  SimContext(unsigned int seed);
+
+  /** Swap this context state in	*/
+  void enter();
+  /** Swap this context state out, restoring the previous one	*/
+  void leave();
+  bool isEntered() const { return entered; }
+
+  /** Delete all the objects of the simulation			*/
+  ~SimContext();
+};
+
+#endif
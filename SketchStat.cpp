@@ -0,0 +1,152 @@
+/*
+ * ARSim
+ * Copyright (c) 2000-2010 Tommaso Cucinotta
+ *
+ * This file is part of ARSim.
+ *
+ * ARSim is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * ARSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with ARSim. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include "SketchStat.hpp"
+#include "util.hpp"
+
+#include <math.h>
+
+SketchStat::SketchStat(double compression, bool time_weighted, double now, long pmf_size)
+  : QuantileStat(time_weighted, now, pmf_size) {
+  CHECK(compression >= 10.0, "Sketch compression must be at least 10");
+  this->compression = compression;
+  buffer_size = (unsigned long) ceil(5 * compression);
+  buffer.reserve(buffer_size);
+}
+
+void SketchStat::clear(double now) {
+  parent::clear(now);
+  centroids.clear();
+  buffer.clear();
+}
+
+void SketchStat::addWeighted(double x, double w) {
+  buffer.push_back(Centroid(x, w));
+  if (buffer.size() >= buffer_size)
+    compress();
+}
+
+/** Scale function k2 of the t-digest: k(q) = delta/Z(n) log(q/(1-q)),
+ ** a centroid starting at q may grow until k increases by 1.
+ **/
+double SketchStat::getQLimit(double q) const {
+  if (q <= 0.0)
+    return 0.0;
+  if (q >= 1.0)
+    return 1.0;
+  /* As in the reference implementation, merge at twice the compression */
+  double delta = 2 * compression;
+  double n = std::max(double(num_samples), delta);
+  double z = 4 * log(n / delta) + 24;
+  double k = delta / z * log(q / (1 - q)) + 1.0;
+  return 1.0 / (1.0 + exp(-k * z / delta));
+}
+
+void SketchStat::compress() const {
+  if (buffer.empty())
+    return;
+  buffer.insert(buffer.end(), centroids.begin(), centroids.end());
+  std::sort(buffer.begin(), buffer.end());
+  centroids.clear();
+  Centroid cur = buffer[0];
+  double w_so_far = 0.0;
+  double w_limit = w_sum * getQLimit(0.0);
+  for (unsigned long i = 1; i < buffer.size(); ++i) {
+    const Centroid & c = buffer[i];
+    if (w_so_far + cur.weight + c.weight <= w_limit) {
+      cur.point = cur.point && c.point && c.mean == cur.mean;
+      cur.weight += c.weight;
+      cur.mean += (c.mean - cur.mean) * c.weight / cur.weight;
+    } else {
+      w_so_far += cur.weight;
+      centroids.push_back(cur);
+      w_limit = w_sum * getQLimit(w_so_far / w_sum);
+      cur = c;
+    }
+  }
+  centroids.push_back(cur);
+  buffer.clear();
+}
+
+/* The cumulated weight grows linearly over the half weights between
+ * consecutive centroid means (and between min, max and the extreme ones),
+ * and steps by the point weight at each centroid mean.
+ */
+double SketchStat::getQuantile(double p) const {
+  compress();
+  if (centroids.empty())
+    return getMax();
+  double idx = p * w_sum;
+  double w_so_far = 0.0;
+  double x_prev = getMin();
+  double dw = getHalfWeight(centroids[0]);
+  for (unsigned long i = 0; i < centroids.size(); ++i) {
+    const Centroid & c = centroids[i];
+    if (dw > 0.0 && w_so_far + dw >= idx)
+      return x_prev + (c.mean - x_prev) * (idx - w_so_far) / dw;
+    w_so_far += dw;
+    if (w_so_far + getPointWeight(c) >= idx)
+      return c.mean;
+    w_so_far += getPointWeight(c);
+    x_prev = c.mean;
+    dw = getHalfWeight(c) + (i + 1 < centroids.size() ? getHalfWeight(centroids[i + 1]) : 0.0);
+  }
+  if (dw > 0.0 && w_so_far + dw > idx)
+    return x_prev + (getMax() - x_prev) * (idx - w_so_far) / dw;
+  return getMax();
+}
+
+double SketchStat::getCDF(double x) const {
+  compress();
+  if (centroids.empty() || x < getMin())
+    return 0.0;
+  if (x >= getMax())
+    return 1.0;
+  double w_so_far = 0.0;
+  double x_prev = getMin();
+  double dw = getHalfWeight(centroids[0]);
+  for (unsigned long i = 0; i < centroids.size(); ++i) {
+    const Centroid & c = centroids[i];
+    if (x < c.mean)
+      return (w_so_far + dw * (x - x_prev) / (c.mean - x_prev)) / w_sum;
+    w_so_far += dw + getPointWeight(c);
+    x_prev = c.mean;
+    dw = getHalfWeight(c) + (i + 1 < centroids.size() ? getHalfWeight(centroids[i + 1]) : 0.0);
+  }
+  return (w_so_far + dw * (x - x_prev) / (getMax() - x_prev)) / w_sum;
+}
+
+double SketchStat::calcPMFMean() const {
+  compress();
+  double sum = 0.0;
+  for (unsigned long i = 0; i < centroids.size(); ++i)
+    sum += centroids[i].mean * centroids[i].weight;
+  return sum / w_sum;
+}
+
+void SketchStat::merge(const BaseStat & s) {
+  const SketchStat *p_s = dynamic_cast<const SketchStat *>(&s);
+  CHECK(p_s != 0, "Merging statistics of different types");
+  p_s->compress();
+  mergeMoments(*p_s);
+  for (unsigned long i = 0; i < p_s->centroids.size(); ++i)
+    buffer.push_back(p_s->centroids[i]);
+  compress();
+}
@@ -0,0 +1,92 @@
+/*
+ * ARSim
+ * Copyright (c) 2000-2010 Tommaso Cucinotta
+ *
+ * This file is part of ARSim.
+ *
+ * ARSim is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * ARSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with ARSim. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef __ARSIM_SKETCH_STAT_HPP__
+#define   __ARSIM_SKETCH_STAT_HPP__
+
+#include "QuantileStat.hpp"
+
+#include <vector>
+
+/** Streaming quantile sketch (merging t-digest) for statistics whose
+ ** range is not known in advance, or whose extreme percentiles matter.
+ **
+ ** Samples are clustered into centroids, whose maximum weight shrinks
+ ** towards both tails, so that memory is bounded by O(compression)
+ ** and the relative accuracy of the percentiles is best close to 0
+ ** and 1. Mean, deviation and min/max are still computed exactly.
+ ** The weight of a centroid is spread half to the left and half to the
+ ** right of its mean, unless all of its samples are equal: then it is
+ ** kept as a point mass, which matters for long time-weighted samples.
+ **/
+class SketchStat : public QuantileStat {
+  struct Centroid {
+    double mean;
+    double weight;
+    bool point;		// All the merged samples are equal to mean
+    Centroid(double m, double w) : mean(m), weight(w), point(true) { }
+    bool operator<(const Centroid & c) const { return mean < c.mean; }
+  };
+
+  double compression;	// Bound on the number of centroids (t-digest delta)
+  mutable std::vector<Centroid> centroids; // Merged centroids, sorted by mean
+  mutable std::vector<Centroid> buffer;    // Samples not merged yet
+  unsigned long buffer_size;
+
+  /** Merge the buffered samples into the centroids		*/
+  void compress() const;
+  /** Max cumulated weight fraction of a centroid starting at q	*/
+  double getQLimit(double q) const;
+  /** Weight of centroid c spread on each side of its mean		*/
+  static double getHalfWeight(const Centroid & c) { return c.point ? 0.0 : c.weight / 2; }
+  /** Weight of centroid c concentrated on its mean		*/
+  static double getPointWeight(const Centroid & c) { return c.point ? c.weight : 0.0; }
+
+ protected:
+
+  void addWeighted(double x, double w);
+
+ public:
+
+  typedef QuantileStat parent;
+
+  /** Build a SketchStat keeping about compression centroids	*/
+  SketchStat(double compression = DEF_SKETCH_COMPRESSION, bool time_weighted = false,
+             double now = 0.0, long pmf_size = DEF_QUANTILE_PMF_SIZE);
+
+  /** Calculate mean from the centroids				*/
+  double calcPMFMean() const;
+  /** Return the estimated fraction of samples not greater than x	*/
+  double getCDF(double x) const;
+  /** Return the estimated p-quantile, with p in [0,1], directly
+   ** interpolated from the centroids.				*/
+  double getQuantile(double p) const;
+  /** Return the number of centroids currently in use		*/
+  long getNumCentroids() const { compress(); return centroids.size(); }
+
+  /** Add the samples of s, a SketchStat, by merging its centroids	*/
+  virtual void merge(const BaseStat & s);
+
+  /** Clear all accumulated statistics.				*/
+  using QuantileStat::clear;
+  virtual void clear(double now);
+};
+
+#endif
@@ -0,0 +1,219 @@
+/*
+ * ARSim
+ * Copyright (c) 2000-2010 Tommaso Cucinotta
+ *
+ * This file is part of ARSim.
+ *
+ * ARSim is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * ARSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with ARSim. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include "SparseStat.hpp"
+#include "util.hpp"
+
+#include <math.h>
+#include <algorithm>
+
+SparseStat::SparseStat(double x_min, double x_max, double dx, bool time_weighted, double now) {
+  this->x_min = x_min;
+  this->x_max = x_max;
+  this->dx = dx;
+  this->x_pmf_size = long(ceil((x_max - x_min) / dx));
+  this->time_weighted = time_weighted;
+  clear(now);
+}
+
+void SparseStat::clear(double now) {
+  parent::clear();
+  bins.clear();
+  last_pos = 0;
+  num_samples = 0;
+  x_sum = 0;
+  x_sqr_sum = 0;
+  x_abs_sum = 0;
+  x_sum_pos = 0;
+  w_sum_pos = 0;
+  x_sum_neg_zero = 0;
+  w_sum_neg_zero = 0;
+  prev_x = 0.0;
+  prev_t = now;
+  orig_t = now;
+}
+
+static bool lessBin(const std::pair<long, double> & b, long n) {
+  return b.first < n;
+}
+
+void SparseStat::addToBin(long n, double w) {
+  /* Consecutive samples often fall within the same interval		*/
+  if (last_pos < (long) bins.size() && bins[last_pos].first == n) {
+    bins[last_pos].second += w;
+    return;
+  }
+  std::vector< std::pair<long, double> >::iterator it =
+    std::lower_bound(bins.begin(), bins.end(), n, lessBin);
+  if (it == bins.end() || it->first != n)
+    it = bins.insert(it, std::make_pair(n, 0.0));
+  it->second += w;
+  last_pos = it - bins.begin();
+}
+
+double SparseStat::getBin(long n) const {
+  std::vector< std::pair<long, double> >::const_iterator it =
+    std::lower_bound(bins.begin(), bins.end(), n, lessBin);
+  if (it == bins.end() || it->first != n)
+    return 0.0;
+  return it->second;
+}
+
+void SparseStat::addSample(double x) {
+  ASSERT(!time_weighted, "Time-weighted statistics need the sample time");
+  BaseStat::addSample(x);
+  long n_sample = long(floor((x - x_min) / dx));
+  if ((n_sample >= 0) && (n_sample < x_pmf_size))
+    addToBin(n_sample, 1.0);
+  num_samples++;
+  x_sum += x;
+  x_sqr_sum += x*x;
+  x_abs_sum += fabs(x);
+  if (x > 0.0) {
+    w_sum_pos += 1.0;
+    x_sum_pos += x;
+  } else {
+    w_sum_neg_zero += 1.0;
+    x_sum_neg_zero += x;
+  }
+}
+
+void SparseStat::addSample(double x, double t) {
+  if (!time_weighted) {
+    addSample(x);
+    return;
+  }
+  BaseStat::addSample(x);
+  /* Use previous sample, that was kept for a time equal to t-prev_t	*/
+  long n_sample = long(floor((prev_x - x_min) / dx));
+  double w = t - prev_t;
+
+  if (n_sample < 0)
+    n_sample = 0;
+  else if (n_sample >= x_pmf_size)
+    n_sample = x_pmf_size - 1;
+
+  if (w != 0.0)
+    addToBin(n_sample, w);
+  num_samples++;
+  x_sum += prev_x * w;
+  x_sqr_sum += prev_x * prev_x * w;
+  x_abs_sum += fabs(prev_x) * w;
+  if (prev_x > 0.0) {
+    x_sum_pos += prev_x * w;
+    w_sum_pos += w;
+  } else {
+    x_sum_neg_zero += prev_x * w;
+    w_sum_neg_zero += w;
+  }
+  prev_x = x;
+  prev_t = t;
+}
+
+double SparseStat::getWeight() const {
+  return time_weighted ? prev_t - orig_t : double(num_samples);
+}
+
+double SparseStat::getNorm() const {
+  return getWeight();
+}
+
+void SparseStat::merge(const BaseStat & s) {
+  const SparseStat *p_s = dynamic_cast<const SparseStat *>(&s);
+  CHECK(p_s != 0, "Merging statistics of different types");
+  CHECK(p_s->x_min == x_min && p_s->dx == dx && p_s->x_pmf_size == x_pmf_size
+        && p_s->time_weighted == time_weighted,
+        "Merging SparseStat objects with different intervals");
+  mergeMinMax(s);
+  for (unsigned int i = 0; i < p_s->bins.size(); ++i)
+    addToBin(p_s->bins[i].first, p_s->bins[i].second);
+  num_samples += p_s->num_samples;
+  x_sum += p_s->x_sum;
+  x_sqr_sum += p_s->x_sqr_sum;
+  x_abs_sum += p_s->x_abs_sum;
+  x_sum_pos += p_s->x_sum_pos;
+  w_sum_pos += p_s->w_sum_pos;
+  x_sum_neg_zero += p_s->x_sum_neg_zero;
+  w_sum_neg_zero += p_s->w_sum_neg_zero;
+  /* Extend the observed duration by the one of s		*/
+  orig_t -= p_s->prev_t - p_s->orig_t;
+}
+
+double SparseStat::calcPMFMean() const {
+  double sum = 0.0;
+  for (unsigned int i = 0; i < bins.size(); ++i)
+    sum += bins[i].second / getNorm() * (x_min + dx * double(bins[i].first));
+  return sum;
+}
+
+double SparseStat::getMean() const {
+  if (time_weighted && prev_t - orig_t == 0.0)
+    return prev_x;
+  return x_sum / getNorm();
+}
+
+double SparseStat::getMeanPos() const {
+  if (time_weighted && w_sum_pos == 0.0 && prev_x >= 0.0)
+    return prev_x;
+  return x_sum_pos / w_sum_pos;
+}
+
+double SparseStat::getMeanNegZero() const {
+  if (time_weighted && w_sum_pos == 0.0 && prev_x <= 0.0)
+    return prev_x;
+  return x_sum_neg_zero / w_sum_neg_zero;
+}
+
+double SparseStat::getDev() const {
+  if (time_weighted && prev_t - orig_t == 0.0)
+    return 0;
+  double exp_x2 = x_sqr_sum / getNorm();
+  double mean = getMean();
+  return sqrt(exp_x2 - mean*mean);
+}
+
+double SparseStat::getMeanAbs() const {
+  if (time_weighted && prev_t - orig_t == 0.0)
+    return fabs(prev_x);
+  return x_abs_sum / getNorm();
+}
+
+double SparseStat::getPDFValue(double x) const {
+  long n_sample = long((x - x_min) / dx);
+  ASSERT1((n_sample >= 0) && (n_sample < x_pmf_size), "SparseStat::getPDFValue(): x out of range: %g", x);
+  return getBin(n_sample) / (dx * getNorm());
+}
+
+double SparseStat::getPMFValue(long n_sample) const {
+  ASSERT1((n_sample >= 0) && (n_sample < x_pmf_size), "getPMFValue(): n_sample out of range: %ld", n_sample);
+  return getBin(n_sample) / getNorm();
+}
+
+double SparseStat::getXValue(long n_sample) const {
+  ASSERT1((n_sample >= 0) && (n_sample < x_pmf_size), "getXValue(): n_sample out of range: %ld", n_sample);
+  return (x_min + (dx * double(n_sample)));
+}
+
+double SparseStat::sumPMFValues() const {
+  double sum = 0.0;
+  for (unsigned int i = 0; i < bins.size(); ++i)
+    sum += bins[i].second;
+  return sum / getNorm();
+}
@@ -0,0 +1,99 @@
+/*
+ * ARSim
+ * Copyright (c) 2000-2010 Tommaso Cucinotta
+ *
+ * This file is part of ARSim.
+ *
+ * ARSim is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * ARSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with ARSim. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef __ARSIM_SPARSE_STAT_HPP__
+#define   __ARSIM_SPARSE_STAT_HPP__
+
+#include "BaseStat.hpp"
+
+#include <vector>
+#include <utility>
+
+/** Histogram over the same [x_min, x_max] intervals of width dx as Stat
+ ** (or TimeStat, if time-weighted), which only stores the intervals that
+ ** have been hit, as a vector sorted by interval index. This is meant for
+ ** statistics that touch a few intervals of a wide range, such as the
+ ** scheduling error of a well-controlled task, or the bandwidth of a task
+ ** with few application modes.
+ **
+ ** Means, out of range samples and degenerate cases are accounted for as
+ ** in Stat and TimeStat, so that the dumped files are the same.
+ **/
+class SparseStat : public BaseStat {
+  double x_min, x_max;
+  double dx;
+  long x_pmf_size;	// Number of (virtual) pmf samples: (max-min)/dx
+  bool time_weighted;
+  std::vector< std::pair<long, double> > bins; // (interval, weight), sorted by interval
+  long last_pos;	// Position in bins of the last updated interval
+  long num_samples;	// Number of x samples
+  double x_sum;		// Weighted sum of samples
+  double x_sqr_sum;	// Weighted sum of square samples
+  double x_abs_sum;	// Weighted sum of absolute samples
+  double x_sum_pos;	// Weighted sum of positive samples
+  double w_sum_pos;	// Sum of weights of positive samples
+  double x_sum_neg_zero; // Weighted sum of negative or zero samples
+  double w_sum_neg_zero; // Sum of weights of negative or zero samples
+  double prev_x;	// Last sample (time-weighted mode)
+  double prev_t;	// Time of insertion of last sample (time-weighted mode)
+  double orig_t;	// Time of start of statistics accumulation (time-weighted mode)
+
+  /** Add w to the n-th interval				*/
+  void addToBin(long n, double w);
+  /** Return the weight of the n-th interval			*/
+  double getBin(long n) const;
+  /** Normalization of weights into probabilities		*/
+  double getNorm() const;
+
+ public:
+
+  typedef BaseStat parent;
+
+  SparseStat(double x_min, double x_max, double dx, bool time_weighted, double now = 0.0);
+
+  /** Feed with next sample					*/
+  void addSample(double x);
+  /** Feed with next sample at time t (time-weighted mode)	*/
+  void addSample(double x, double t);
+  virtual long getNumSamples() const { return num_samples; }
+  virtual double getWeight() const;
+  virtual double getWeightPos() const { return w_sum_pos; }
+  /** Add the samples of s, a SparseStat with the same intervals	*/
+  virtual void merge(const BaseStat & s);
+  double calcPMFMean() const;
+  double getMean() const;
+  double getMeanPos() const;
+  double getMeanNegZero() const;
+  double getDev() const;
+  double getMeanAbs() const;
+  double getPDFValue(double x) const;
+  double getPMFValue(long n_sample) const;
+  double sumPMFValues() const;
+  long getPMFSize() const { return x_pmf_size; }
+  double getXValue(long n_sample) const;
+  /** Return the number of intervals actually stored		*/
+  long getNumBins() const { return bins.size(); }
+
+  virtual void clear() { clear(0.0); }
+  /** Clear all accumulated statistics, restarting at time now	*/
+  void clear(double now);
+};
+
+#endif
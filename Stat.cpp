@@ -28,10 +28,7 @@ Stat::Stat(double x_min, double x_max, long x_pmf_size) {
   this->x_max = x_max;
   this->dx = (x_max - x_min) / double(x_pmf_size);
   this->x_pmf_size = x_pmf_size;
-  x_pmf = new long[x_pmf_size];
-  ASSERT(x_pmf != 0, "No memory");
-  for (long n = 0; n < x_pmf_size; n++)
-    x_pmf[n] = 0;
+  x_pmf = 0;		// See allocPMF()
   num_samples = 0;
   x_sum = 0;
   x_sqr_sum = 0;
@@ -48,10 +45,7 @@ Stat::Stat(double x_min, double x_max, double dx) {
   this->x_max = x_max;
   this->dx = dx;
   this->x_pmf_size = long(ceil((x_max - x_min) / dx));
-  x_pmf = new long[x_pmf_size];
-  ASSERT(x_pmf != 0, "No memory");
-  for (long n = 0; n < x_pmf_size; n++)
-    x_pmf[n] = 0;
+  x_pmf = 0;		// See allocPMF()
   num_samples = 0;
   x_sum = 0;
   x_sqr_sum = 0;
@@ -63,11 +57,19 @@ Stat::Stat(double x_min, double x_max, double dx) {
   Logger::debugLog("pmf size: %ld\n", x_pmf_size);
 }
 
+void Stat::allocPMF() {
+  x_pmf = new long[x_pmf_size];
+  ASSERT(x_pmf != 0, "No memory");
+  for (long n = 0; n < x_pmf_size; n++)
+    x_pmf[n] = 0;
+}
+
 void Stat::clear() {
   parent::clear();
   num_samples = 0;
-  for (long n = 0; n < x_pmf_size; n++)
-    x_pmf[n] = 0;
+  if (x_pmf != 0)
+    for (long n = 0; n < x_pmf_size; n++)
+      x_pmf[n] = 0;
   x_sum = 0;
   x_sqr_sum = 0;
   x_abs_sum = 0;
@@ -84,7 +86,7 @@ Stat::~Stat() {
 double Stat::calcPMFMean() const {
   double sum = 0.0;
   for (long n = 0; n < x_pmf_size; n++)
-    sum += double(x_pmf[n])/double(num_samples) * (x_min + dx * double(n));
+    sum += double(getBin(n))/double(num_samples) * (x_min + dx * double(n));
   return sum;
 }
 
@@ -117,12 +119,12 @@ double Stat::getPDFValue(double x) const {
 	   x_min, x_max, dx, x_pmf_size);
     ASSERT1((n_sample >= 0) && (n_sample < x_pmf_size), "Stat::getDistrAt(): x out of range: %g", x);
   }
-  return double(x_pmf[n_sample])/(dx*double(num_samples));
+  return double(getBin(n_sample))/(dx*double(num_samples));
 }
 
 double Stat::getPMFValue(long n_sample) const {
   ASSERT1((n_sample >= 0) && (n_sample < x_pmf_size), "getPMFValue(): n_sample out of range: %ld", n_sample);
-  return double(x_pmf[n_sample])/double(num_samples);
+  return double(getBin(n_sample))/double(num_samples);
 }
 
 double Stat::getXValue(long n_sample) const {
@@ -133,6 +135,28 @@ double Stat::getXValue(long n_sample) const {
 double Stat::sumPMFValues() const {
   long sum = 0;
   for (long n = 0; n < x_pmf_size; n++)
-    sum += x_pmf[n];
+    sum += getBin(n);
   return double(sum)/double(num_samples);
 }
+
+void Stat::merge(const BaseStat & s) {
+  const Stat *p_s = dynamic_cast<const Stat *>(&s);
+  CHECK(p_s != 0, "Merging statistics of different types");
+  CHECK(p_s->x_min == x_min && p_s->dx == dx && p_s->x_pmf_size == x_pmf_size,
+        "Merging Stat objects with different intervals");
+  mergeMinMax(s);
+  if (p_s->x_pmf != 0) {
+    if (x_pmf == 0)
+      allocPMF();
+    for (long n = 0; n < x_pmf_size; n++)
+      x_pmf[n] += p_s->x_pmf[n];
+  }
+  num_samples += p_s->num_samples;
+  x_sum += p_s->x_sum;
+  x_sqr_sum += p_s->x_sqr_sum;
+  x_abs_sum += p_s->x_abs_sum;
+  num_pos += p_s->num_pos;
+  x_pos_sum += p_s->x_pos_sum;
+  num_neg_zero += p_s->num_neg_zero;
+  x_neg_zero_sum += p_s->x_neg_zero_sum;
+}
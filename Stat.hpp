@@ -30,7 +30,7 @@ using namespace std;
 class Stat : public BaseStat {
   double x_min, x_max;
   double dx;
-  long *x_pmf;		// Number of occurrences in each dx-sized interval
+  long *x_pmf;		// Number of occurrences in each dx-sized interval, 0 until first needed
   long x_pmf_size;	// Number of pmf samples: (max-min)/dx
   long num_samples;	// Number of x samples
   double x_sum;		// Exact sum of samples
@@ -41,6 +41,11 @@ class Stat : public BaseStat {
   long num_neg_zero;	// Number of negative or zero samples
   double x_neg_zero_sum; // Exact sum of negative or zero samples
 
+  /** Allocate the intervals at the first sample falling within them, so
+   ** that statistics which are never fed cost no more than their sums */
+  void allocPMF();
+  long getBin(long n) const { return x_pmf != 0 ? x_pmf[n] : 0; }
+
  public:
 
   typedef BaseStat parent;
@@ -55,6 +60,10 @@ class Stat : public BaseStat {
   void addSample(double x);
   /** Get number of samples   */
   virtual long getNumSamples() const { return num_samples; }
+  virtual double getWeight() const { return num_samples; }
+  virtual double getWeightPos() const { return num_pos; }
+  /** Add the samples of s, a Stat with the same intervals	*/
+  virtual void merge(const BaseStat & s);
   /** Calculate mean from calculated PMF				*/
   double calcPMFMean() const;
   /** Return mean of provided samples				*/
@@ -77,6 +86,9 @@ class Stat : public BaseStat {
   double sumPMFValues() const;
   /** Return the PMF size					*/
   long getPMFSize() const { return x_pmf_size; }
+  /** Return the raw PMF array: number of occurrences in each interval (divide by getNumSamples()),
+   ** or 0 if no sample fell within [x_min, x_max] yet		*/
+  const long *getPMFData() const { return x_pmf; }
   /** Return x value getPMFValue(n_sample) refers to		*/
   double getXValue(long n_sample) const;
 
@@ -102,8 +114,11 @@ class Stat : public BaseStat {
 inline void Stat::addSample(double x) {
   BaseStat::addSample(x);
   long n_sample = long(floor((x - x_min) / dx));
-  if ((n_sample >= 0) && (n_sample < x_pmf_size))
+  if ((n_sample >= 0) && (n_sample < x_pmf_size)) {
+    if (x_pmf == 0)
+      allocPMF();
     x_pmf[n_sample]++;
+  }
   num_samples++;
   x_sum += x;
   x_sqr_sum += x*x;
@@ -0,0 +1,143 @@
+/*
+ * ARSim
+ * Copyright (c) 2000-2010 Tommaso Cucinotta
+ *
+ * This file is part of ARSim.
+ *
+ * ARSim is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * ARSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with ARSim. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <cstring>
+#include <stdio.h>
+#include <math.h>
+
+#include "StatFactory.hpp"
+#include "Stat.hpp"
+#include "TimeStat.hpp"
+#include "SketchStat.hpp"
+#include "HdrStat.hpp"
+#include "SparseStat.hpp"
+#include "NullStat.hpp"
+#include "DecayTimeStat.hpp"
+#include "WindowTimeStat.hpp"
+#include "defaults.hpp"
+
+/** Split spec into type name and optional numeric parameter (0 if absent) */
+static bool parseSpec(const char *spec, char *type, int type_len, double & param) {
+  const char *colon = strchr(spec, ':');
+  int len = colon != 0 ? colon - spec : strlen(spec);
+  if (len == 0 || len >= type_len)
+    return false;
+  memcpy(type, spec, len);
+  type[len] = '\0';
+  param = 0.0;
+  if (colon != 0 && (sscanf(colon + 1, "%lg", &param) != 1 || param <= 0.0))
+    return false;
+  return true;
+}
+
+BaseStat * StatFactory::getInstance(const char *spec, double x_min, double x_max, double dx,
+                                    bool time_weighted, double now) {
+  char type[16];
+  double param;
+  if (!parseSpec(spec, type, sizeof(type), param))
+    return 0;
+  if (strcmp(type, "hist") == 0) {
+    if (param > 0.0)
+      dx = param;
+    if (time_weighted)
+      return new TimeStat(x_min, x_max, dx, now);
+    return new Stat(x_min, x_max, dx);
+  } else if (strcmp(type, "sparse") == 0) {
+    return new SparseStat(x_min, x_max, param > 0.0 ? param : dx, time_weighted, now);
+  } else if (strcmp(type, "off") == 0) {
+    return new NullStat();
+  } else if (strcmp(type, "sketch") == 0) {
+    return new SketchStat(param > 0.0 ? param : DEF_SKETCH_COMPRESSION, time_weighted, now);
+  } else if (strcmp(type, "hdr") == 0) {
+    return new HdrStat(dx / DEF_HDR_UNITS_PER_DX, param > 0.0 ? int(param) : DEF_HDR_DIGITS,
+                       time_weighted, now);
+  }
+  return 0;
+}
+
+bool StatFactory::isValid(const char *spec) {
+  char type[16];
+  double param;
+  if (!parseSpec(spec, type, sizeof(type), param))
+    return false;
+  if (strcmp(type, "sketch") == 0)
+    return param == 0.0 || param >= 10.0;
+  if (strcmp(type, "hdr") == 0)
+    return param == 0.0 || (param == floor(param) && param <= 5.0);
+  if (strcmp(type, "off") == 0)
+    return param == 0.0;
+  return strcmp(type, "hist") == 0 || strcmp(type, "sparse") == 0;
+}
+
+/** Parse type[:length[,buckets]] (0 if absent) */
+static bool parseMovingSpec(const char *spec, char *type, int type_len, double & length, int & num_buckets) {
+  const char *colon = strchr(spec, ':');
+  int len = colon != 0 ? colon - spec : strlen(spec);
+  if (len == 0 || len >= type_len)
+    return false;
+  memcpy(type, spec, len);
+  type[len] = '\0';
+  length = 0.0;
+  num_buckets = 0;
+  if (colon == 0)
+    return true;
+  int n = sscanf(colon + 1, "%lg,%d", &length, &num_buckets);
+  if (n < 1 || length <= 0.0 || (n == 2 && num_buckets <= 0))
+    return false;
+  return n == 2 || strchr(colon + 1, ',') == 0;
+}
+
+MovingTimeStat * StatFactory::getMovingInstance(const char *spec, double horizon, double now) {
+  char type[16];
+  double length;
+  int num_buckets;
+  if (!parseMovingSpec(spec, type, sizeof(type), length, num_buckets))
+    return 0;
+  if (length == 0.0)
+    length = horizon;
+  if (strcmp(type, "decay") == 0 && num_buckets == 0)
+    return new DecayTimeStat(length, now);
+  else if (strcmp(type, "window") == 0)
+    return new WindowTimeStat(length, num_buckets > 0 ? num_buckets : DEF_WINDOW_BUCKETS, now);
+  return 0;
+}
+
+bool StatFactory::isValidMoving(const char *spec) {
+  char type[16];
+  double length;
+  int num_buckets;
+  if (!parseMovingSpec(spec, type, sizeof(type), length, num_buckets))
+    return false;
+  if (strcmp(type, "decay") == 0)
+    return num_buckets == 0;
+  return strcmp(type, "window") == 0;
+}
+
+void StatFactory::usage() {
+  printf("           -stat   name=type[:param] Select the implementation of statistic name\n");
+  printf("                     (bw/rbw/dbw/se/ck/rs/pi/pii, and pe/pr/ri/rw/ra of the controller):\n");
+  printf("                     hist[:dx]  fixed-range histogram, with optional interval width (default)\n");
+  printf("                     sparse[:dx] same as hist, only storing the intervals that are hit\n");
+  printf("                     sketch[:c] t-digest quantile sketch, keeping about c centroids (default %g)\n",
+         DEF_SKETCH_COMPRESSION);
+  printf("                     hdr[:d]    log-linear buckets with d significant digits (default %d),\n", DEF_HDR_DIGITS);
+  printf("                                and a resolution of 1/%d of the default interval\n", DEF_HDR_UNITS_PER_DX);
+  printf("                     off        disable the statistic, which is not dumped\n");
+}
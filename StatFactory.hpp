@@ -0,0 +1,60 @@
+/*
+ * ARSim
+ * Copyright (c) 2000-2010 Tommaso Cucinotta
+ *
+ * This file is part of ARSim.
+ *
+ * ARSim is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * ARSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with ARSim. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef __ARSIM_STAT_FACTORY_HPP__
+#define   __ARSIM_STAT_FACTORY_HPP__
+
+#include "BaseStat.hpp"
+#include "MovingTimeStat.hpp"
+
+/** Build the statistics object selected by a type specification of the
+ ** form type[:param], so that each statistic may use a different
+ ** implementation:
+ ** - hist[:dx]: fixed-range histogram (Stat, or TimeStat if time-weighted)
+ ** - sparse[:dx]: same as hist, storing only the intervals hit (SparseStat)
+ ** - sketch[:compression]: t-digest quantile sketch (SketchStat)
+ ** - hdr[:digits]: log-linear bucketed histogram (HdrStat)
+ ** - off: disabled statistic, neither accumulated nor dumped (NullStat)
+ **
+ ** and the moving-horizon time statistics, of the form type[:params]:
+ ** - decay[:half_life]: exponentially decayed statistic (DecayTimeStat)
+ ** - window[:length[,buckets]]: sliding window statistic (WindowTimeStat)
+ **/
+class StatFactory {
+public:
+  /** Return 0 if spec is not a known type specification. The range and
+   ** interval width are the default ones for the statistic, and are used
+   ** only by the types needing them.
+   **/
+  static BaseStat * getInstance(const char *spec, double x_min, double x_max, double dx,
+                                bool time_weighted, double now = 0.0);
+  /** Check whether spec is a well formed type specification	*/
+  static bool isValid(const char *spec);
+  static void usage();
+
+  /** Return 0 if spec is not a known moving-horizon type specification.
+   ** The half-life or window length defaults to horizon.
+   **/
+  static MovingTimeStat * getMovingInstance(const char *spec, double horizon, double now = 0.0);
+  /** Check whether spec is a well formed moving-horizon type specification */
+  static bool isValidMoving(const char *spec);
+};
+
+#endif
@@ -0,0 +1,148 @@
+/*
+ * ARSim
+ * Copyright (c) 2000-2010 Tommaso Cucinotta
+ *
+ * This file is part of ARSim.
+ *
+ * ARSim is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * ARSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with ARSim. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <cstring>
+#include <math.h>
+#include <algorithm>
+
+#include "StatSnapshot.hpp"
+#include "ResourceManager.hpp"
+#include "TaskScheduler.hpp"
+#include "util.hpp"
+
+StatSnapshot *StatSnapshot::p_ss = new StatSnapshot();
+
+StatSnapshot::StatSnapshot() {
+  ss_fname = "snap.dat";
+  ss_file = NULL;
+  period = 0;
+  p_ss_ev = 0;
+  percentiles.push_back(0.50);
+  percentiles.push_back(0.90);
+  percentiles.push_back(0.99);
+}
+
+void StatSnapshot::usage() {
+  printf("  STATISTICS SNAPSHOT OPTIONS\n");
+  printf("           -ss-p   t: append a snapshot of all task statistics every t time units\n");
+  printf("           -ss-f   file: file the snapshots are appended to (defaults to snap.dat)\n");
+  printf("           -ss-pct p1,p2,...: percentiles within [0,1] to include in snapshots (defaults to 0.5,0.9,0.99)\n");
+}
+
+bool StatSnapshot::parseArg(int& argc, char **& argv) {
+  if (strcmp(*argv, "-ss-p") == 0) {
+    CHECK(argc > 1, "Option requires an argument");
+    argv++;  argc--;
+    CHECK(p_ss_ev == 0, "Snapshot period already specified");
+    CHECK(sscanf(*argv, "%lg", &period) == 1 && period > 0, "Expecting positive real as argument to -ss-p option");
+    p_ss_ev = makeEvent(period, this, &StatSnapshot::handleSnapshotEvent);
+    EventList::events().insert(p_ss_ev);
+  } else if (strcmp(*argv, "-ss-f") == 0) {
+    CHECK(argc > 1, "Option requires an argument");
+    argv++;  argc--;
+    ss_fname = *argv;
+  } else if (strcmp(*argv, "-ss-pct") == 0) {
+    CHECK(argc > 1, "Option requires an argument");
+    argv++;  argc--;
+    percentiles.clear();
+    char *s = *argv;
+    double p;
+    int n;
+    while (sscanf(s, "%lg%n", &p, &n) == 1) {
+      CHECK(p >= 0.0 && p <= 1.0, "Percentiles in -ss-pct option must be within [0,1]");
+      percentiles.push_back(p);
+      s += n;
+      if (*s != ',')
+	break;
+      s++;
+    }
+    CHECK(*s == '\0' && percentiles.size() > 0, "Expecting comma-separated reals as argument to -ss-pct option");
+  } else {
+    return false;
+  }
+  return true;
+}
+
+void StatSnapshot::writeStat(int tsk, int rs, const char *name, const BaseStat *p_stat) {
+  if (p_stat == 0)
+    return;
+  Totals & last = last_totals[p_stat];
+  Totals curr;
+  curr.num = p_stat->getNumSamples();
+  if (curr.num == last.num)
+    return;
+  double mean = p_stat->getMean();
+  double dev = p_stat->getDev();
+  curr.weight = p_stat->getWeight();
+  curr.sum = mean * curr.weight;
+  curr.sqr_sum = (dev * dev + mean * mean) * curr.weight;
+  /* Mean and deviation over the interval since the last snapshot */
+  double dw = curr.weight - last.weight;
+  if (dw > 0.0) {
+    mean = (curr.sum - last.sum) / dw;
+    dev = sqrt(std::max((curr.sqr_sum - last.sqr_sum) / dw - mean * mean, 0.0));
+  }
+  fprintf(ss_file, "%11.4f %4d %3d %-6s %8ld %11g %11g", EventList::getTime(), tsk, rs, name,
+	  curr.num - last.num, mean, dev);
+  for (unsigned int i = 0; i < percentiles.size(); ++i)
+    fprintf(ss_file, " %11g", p_stat->getPMFPercentile(percentiles[i]));
+  fprintf(ss_file, "\n");
+  last = curr;
+}
+
+void StatSnapshot::snapshot() {
+  if (ss_file == NULL) {
+    ss_file = fopen(ss_fname, "w");
+    CHECK(ss_file != NULL, "Could not open statistics snapshot file");
+    fprintf(ss_file, "# Statistics snapshots every %g time units: unchanged stats are omitted, dn, mean"
+	    " and dev refer to the new samples, percentiles to all of them\n", period);
+    fprintf(ss_file, "# %9s %4s %3s %-6s %8s %11s %11s", "time", "tsk", "rs", "stat", "dn", "mean", "dev");
+    for (unsigned int i = 0; i < percentiles.size(); ++i) {
+      char col[16];
+      snprintf(col, sizeof(col), "p%g", percentiles[i] * 100.0);
+      fprintf(ss_file, " %11s", col);
+    }
+    fprintf(ss_file, "\n");
+  }
+  vector<ResourceManager*>::iterator rs_it = ResourceManager::rs_controllers.begin();
+  for (int r = 0; rs_it != ResourceManager::rs_controllers.end(); ++rs_it, ++r) {
+    for (unsigned int t = 0; t < (*rs_it)->getTaskSchedulerNum(); ++t) {
+      vector< pair<const char *, const BaseStat *> > stats;
+      (*rs_it)->getTaskSchedulerAt(t)->getStats(stats);
+      for (unsigned int i = 0; i < stats.size(); ++i)
+	writeStat(t, r, stats[i].first, stats[i].second);
+    }
+  }
+  fflush(ss_file);
+}
+
+void StatSnapshot::handleSnapshotEvent(const Event & ev) {
+  snapshot();
+  p_ss_ev = makeEvent(period, this, &StatSnapshot::handleSnapshotEvent);
+  EventList::events().insert(p_ss_ev);
+}
+
+void StatSnapshot::close() {
+  if (p_ss_ev == 0)
+    return;
+  snapshot();
+  fclose(ss_file);
+  ss_file = NULL;
+}
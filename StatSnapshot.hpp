@@ -0,0 +1,81 @@
+/*
+ * ARSim
+ * Copyright (c) 2000-2010 Tommaso Cucinotta
+ *
+ * This file is part of ARSim.
+ *
+ * ARSim is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * ARSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with ARSim. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef __ARSIM_STAT_SNAPSHOT_HPP__
+#  define __ARSIM_STAT_SNAPSHOT_HPP__
+
+#include "Component.hpp"
+#include "Events.hpp"
+#include "BaseStat.hpp"
+
+#include <stdio.h>
+#include <map>
+#include <vector>
+
+/** Periodic snapshots of the per-task statistics, as a time series.
+ **
+ ** Every -ss-p simulated time units, a summary record (number of new
+ ** samples, mean, standard deviation and the selected percentiles) of
+ ** each statistic of each task is appended to the snapshot file, one
+ ** line per statistic. The number of samples, mean and deviation refer
+ ** to the last interval only: they are obtained from the differences of
+ ** the weight, sum and sum of squares (as derived from the cumulative
+ ** mean and deviation) since the previous snapshot. Percentiles are
+ ** still cumulative over the whole run, as the statistics do not keep
+ ** per-interval data. Statistics which got no new samples are omitted,
+ ** so that the file stays small even for long runs. Full PMFs are still
+ ** only written at the end, by the usual statistics dump.
+ **/
+class StatSnapshot : public Component {
+  static StatSnapshot *p_ss;
+  friend class SimContext;
+
+  const char *ss_fname;
+  FILE *ss_file;
+  Time period;
+  Event *p_ss_ev;
+  std::vector<double> percentiles;
+  /** Totals of a statistic at the last snapshot	*/
+  struct Totals {
+    long num;
+    double weight, sum, sqr_sum;
+    Totals() : num(0), weight(0.0), sum(0.0), sqr_sum(0.0) { }
+  };
+  std::map<const BaseStat *, Totals> last_totals;
+
+  void writeStat(int tsk, int rs, const char *name, const BaseStat *p_stat);
+
+public:
+
+  StatSnapshot();
+
+  static inline StatSnapshot *getInstance() { return p_ss; }
+
+  static void usage();
+  virtual bool parseArg(int& argc, char **& argv);
+
+  /** Append a snapshot of all statistics to the file */
+  void snapshot();
+  void handleSnapshotEvent(const Event & ev);
+  /** Write a last snapshot and close the file */
+  void close();
+};
+
+#endif
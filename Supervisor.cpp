@@ -27,6 +27,9 @@
 Supervisor::Supervisor() {
   speed = 1.0;
   p_tasks = NULL;
+  p_table = NULL;
+  rs_id = 0;
+  num_checks = num_overloads = 0;
 }
 
 void Supervisor::usage() {
@@ -22,6 +22,7 @@
 #define SUPERVISOR_HPP_
 
 #include "TaskScheduler.hpp"
+#include "TaskTable.hpp"
 
 /**
  * Supervisor base class.
@@ -36,6 +37,17 @@
 class Supervisor : public Component {
   double speed;                 /**< Resource current speed     */
   vector<TaskScheduler*> *p_tasks;
+  TaskTable *p_table;           /**< Same tasks, as struct-of-arrays */
+  int rs_id;                    /**< ID of the supervised resource */
+  unsigned long num_checks;     /**< Number of global constraint checks */
+  unsigned long num_overloads;  /**< Number of checks finding an overload */
+protected:
+  /** Account for a global constraint check, for statistics purposes */
+  void countCheck(bool overload) {
+    num_checks++;
+    if (overload)
+      num_overloads++;
+  }
 public:
   Supervisor();
   virtual void checkGlobalConstraint(vector<TaskScheduler*>& tasks) = 0;
@@ -46,10 +58,23 @@ public:
   virtual void dumpStats() { }
   virtual ~Supervisor() { }
 
-  void setTasks(vector<TaskScheduler*> *p_tasks) {
+  void setTasks(vector<TaskScheduler*> *p_tasks, TaskTable *p_table) {
     this->p_tasks = p_tasks;
+    this->p_table = p_table;
   }
 
+  /** Running flags, bandwidths and weights of the supervised tasks,
+   ** in the same order as the tasks vector */
+  const TaskTable & getTaskTable() const { return *p_table; }
+
+  /** Fraction of global constraint checks that found an overload */
+  double getOverloadFraction() const {
+    return num_checks == 0 ? 0.0 : double(num_overloads) / num_checks;
+  }
+
+  void setResourceId(int rs_id) { this->rs_id = rs_id; }
+  int getResourceId() const { return rs_id; }
+
   /** Get Resource Speed (power management) */
   double getSpeed() const { return speed; }
 
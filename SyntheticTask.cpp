@@ -0,0 +1,267 @@
+/*
+ * ARSim
+ * Copyright (c) 2000-2010 Tommaso Cucinotta
+ *
+ * This file is part of ARSim.
+ *
+ * ARSim is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * ARSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with ARSim. If not, see <http://www.gnu.org/licenses/>
+ */
+
+/* Interface includes */
+
+#include "SyntheticTask.hpp"
+#include "TraceStore.hpp"
+#include "defaults.hpp"
+#include "util.hpp"
+
+/* Implementation includes */
+
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+#include <stdio.h>
+#include <algorithm>
+
+#define SYN_MODEL_VERSION 1
+
+SyntheticTask::SyntheticTask()
+  : DoubleLimitedTask() {
+  fit_col = 1;
+  fit_disc = 0;
+  fit_mul = 1.0;
+  num_quantiles = 1024;
+  phi = 0.0;
+  /* Private stream, not drawing from random(), keyed by the task id until
+   * setStreamId() keys it by the task position */
+  uint64_t x = crn_seed;
+  x = Rng::splitmix64(x) ^ task_id;
+  rng.setSeed(Rng::splitmix64(x));
+  rng_seeded = false;
+  z = rng.nextGaussian();
+}
+
+void SyntheticTask::usage() {
+  printf("(-t syn)   -syn-m  file: Load the synthetic workload model from file\n");
+  printf("(-t syn)   -syn-fit file: Fit the model to the specified trace file\n");
+  printf("(-t syn)   -syn-tc  Column of the trace file to fit (defaults to 1)\n");
+  printf("(-t syn)   -syn-mul Multiply factor of the trace samples (defaults to 1.0)\n");
+  printf("(-t syn)   -syn-disc Lines to discard at head of trace file (defaults to 0)\n");
+  printf("(-t syn)   -syn-q   Number of quantiles of the fitted model (defaults to 1024)\n");
+  printf("(-t syn)   -syn-save file: Save the fitted model to file\n");
+  printf("(-t syn)   -syn-seed n: Seed of the random stream of the task\n");
+}
+
+bool SyntheticTask::parseArg(int& argc, char **& argv) {
+  if (strcmp(*argv, "-syn-m") == 0) {
+    CHECK(argc > 1, "Option requires an argument");
+    argv++;  argc--;
+    model_fname = *argv;
+  } else if (strcmp(*argv, "-syn-fit") == 0) {
+    CHECK(argc > 1, "Option requires an argument");
+    argv++;  argc--;
+    fit_fname = *argv;
+  } else if (strcmp(*argv, "-syn-tc") == 0) {
+    CHECK(argc > 1, "Option requires an argument");
+    argv++;  argc--;
+    CHECK((sscanf(*argv, "%d", &fit_col) == 1) && (fit_col >= 1), "Expecting integer >= 1 as argument to -syn-tc option");
+  } else if (strcmp(*argv, "-syn-mul") == 0) {
+    CHECK(argc > 1, "Option requires an argument");
+    argv++;  argc--;
+    CHECK((sscanf(*argv, "%lg", &fit_mul) == 1) && (fit_mul > 0.0), "Expecting positive real as argument to -syn-mul option");
+  } else if (strcmp(*argv, "-syn-disc") == 0) {
+    CHECK(argc > 1, "Option requires an argument");
+    argv++;  argc--;
+    CHECK((sscanf(*argv, "%d", &fit_disc) == 1) && (fit_disc >= 0), "Expecting non-negative integer as argument to -syn-disc option");
+  } else if (strcmp(*argv, "-syn-q") == 0) {
+    CHECK(argc > 1, "Option requires an argument");
+    argv++;  argc--;
+    CHECK((sscanf(*argv, "%d", &num_quantiles) == 1) && (num_quantiles >= 2), "Expecting integer >= 2 as argument to -syn-q option");
+  } else if (strcmp(*argv, "-syn-save") == 0) {
+    CHECK(argc > 1, "Option requires an argument");
+    argv++;  argc--;
+    save_fname = *argv;
+  } else if (strcmp(*argv, "-syn-seed") == 0) {
+    CHECK(argc > 1, "Option requires an argument");
+    argv++;  argc--;
+    unsigned long long seed;
+    CHECK(sscanf(*argv, "%llu", &seed) == 1, "Expecting non-negative integer as argument to -syn-seed option");
+    rng.setSeed(seed);
+    rng_seeded = true;
+    z = rng.nextGaussian();
+  } else
+    return parent::parseArg(argc, argv);
+  return true;
+}
+
+bool SyntheticTask::checkParams() {
+  if (! parent::checkParams())
+    return false;
+  BCHECK(quantiles.size() >= 2, "Synthetic task without a model: use -syn-m or -syn-fit");
+  BCHECK(phi > -1.0 && phi < 1.0, "Bad autocorrelation in synthetic workload model");
+  BCHECK(c_min <= c_max, "Bad min/max values");
+  return true;
+}
+
+void SyntheticTask::calcParams() {
+  parent::calcParams();
+  if (quantiles.size() == 0) {
+    CHECK(fit_fname.size() > 0 || model_fname.size() > 0, "Synthetic task needs either -syn-m or -syn-fit");
+    if (fit_fname.size() > 0)
+      fitModel();
+    else
+      loadModel(model_fname.c_str());
+    if (save_fname.size() > 0)
+      saveModel(save_fname.c_str());
+    if (c_min == UNASSIGNED)
+      c_min = quantiles.front();
+    if (c_max == UNASSIGNED)
+      c_max = quantiles.back();
+    calcIInterval();
+    fprintf(stderr, "# Synthetic workload model: phi= %g, %lu quantiles, min= %g max= %g\n",
+	    phi, (unsigned long) quantiles.size(), c_min/period, c_max/period);
+  }
+}
+
+/* Acklam's rational approximation, refined by one Halley step */
+double SyntheticTask::invPhi(double p) {
+  static const double a[] = { -3.969683028665376e+01, 2.209460984245205e+02, -2.759285104469687e+02,
+			      1.383577518672690e+02, -3.066479806614716e+01, 2.506628277459239e+00 };
+  static const double b[] = { -5.447609879822406e+01, 1.615858368580409e+02, -1.556989798598866e+02,
+			      6.680131188771972e+01, -1.328068155288572e+01 };
+  static const double c[] = { -7.784894002430293e-03, -3.223964580411365e-01, -2.400758277161838e+00,
+			      -2.549732539343734e+00, 4.374664141464968e+00, 2.938163982698783e+00 };
+  static const double d[] = { 7.784695709041462e-03, 3.224671290700398e-01, 2.445134137142996e+00,
+			      3.754408661907416e+00 };
+  double x;
+  if (p <= 0.0)
+    return -HUGE_VAL;
+  if (p >= 1.0)
+    return HUGE_VAL;
+  if (p < 0.02425) {
+    double q = sqrt(-2 * log(p));
+    x = (((((c[0]*q + c[1])*q + c[2])*q + c[3])*q + c[4])*q + c[5]) / ((((d[0]*q + d[1])*q + d[2])*q + d[3])*q + 1);
+  } else if (p > 1 - 0.02425) {
+    double q = sqrt(-2 * log(1 - p));
+    x = -(((((c[0]*q + c[1])*q + c[2])*q + c[3])*q + c[4])*q + c[5]) / ((((d[0]*q + d[1])*q + d[2])*q + d[3])*q + 1);
+  } else {
+    double q = p - 0.5;
+    double r = q * q;
+    x = (((((a[0]*r + a[1])*r + a[2])*r + a[3])*r + a[4])*r + a[5])*q / (((((b[0]*r + b[1])*r + b[2])*r + b[3])*r + b[4])*r + 1);
+  }
+  double e = 0.5 * erfc(-x / M_SQRT2) - p;
+  double u = e * sqrt(2 * M_PI) * exp(x * x / 2);
+  return x - u / (1 + x * u / 2);
+}
+
+void SyntheticTask::fitModel() {
+  TraceCacheKey key;
+  key.fname = fit_fname;
+  key.col_number = fit_col;
+  key.disc_lines = fit_disc;
+  key.mul_factor = fit_mul;
+  key.sat_p_min = 0.0;
+  key.sat_p_max = 1.0;
+  TraceStore::Entry *p_trace = TraceStore::acquire(key, true);
+  const double *x = p_trace->p_samples;
+  size_t n = p_trace->num_samples;
+  CHECK(n >= 3, "Too short trace for fitting a synthetic workload model");
+
+  vector<double> sorted(x, x + n);
+  sort(sorted.begin(), sorted.end());
+  quantiles.resize(num_quantiles);
+  for (int i = 0; i < num_quantiles; ++i) {
+    double pos = double(i) * (n - 1) / (num_quantiles - 1);
+    size_t j = (size_t) pos;
+    double frac = pos - j;
+    quantiles[i] = (j + 1 < n) ? sorted[j] + frac * (sorted[j + 1] - sorted[j]) : sorted[j];
+  }
+
+  /* Normal scores from mid-ranks (ties share the same score) */
+  double sum_zz = 0.0, sum_zz1 = 0.0, z_prev = 0.0;
+  for (size_t k = 0; k < n; ++k) {
+    vector<double>::iterator lo = lower_bound(sorted.begin(), sorted.end(), x[k]);
+    vector<double>::iterator hi = upper_bound(lo, sorted.end(), x[k]);
+    double rank = ((lo - sorted.begin()) + (hi - sorted.begin()) + 1) / 2.0;
+    double zk = invPhi(rank / (n + 1));
+    sum_zz += zk * zk;
+    if (k > 0)
+      sum_zz1 += zk * z_prev;
+    z_prev = zk;
+  }
+  phi = sum_zz1 / sum_zz;
+  phi = max(-0.999, min(0.999, phi));
+  TraceStore::release(p_trace);
+  fprintf(stderr, "# Fitted synthetic workload model on %lu samples of %s\n", (unsigned long) n, fit_fname.c_str());
+}
+
+void SyntheticTask::loadModel(const char *fname) {
+  FILE *f = fopen(fname, "r");
+  CHECK(f != NULL, "Could not open synthetic workload model file");
+  char line[256];
+  int version = 0;
+  long num_q = -1;
+  while (fgets(line, sizeof(line), f) != NULL) {
+    if (line[0] == '#')
+      continue;
+    if (sscanf(line, "version %d", &version) == 1)
+      continue;
+    if (sscanf(line, "phi %lg", &phi) == 1)
+      continue;
+    if (sscanf(line, "quantiles %ld", &num_q) == 1)
+      break;
+  }
+  CHECK(version == SYN_MODEL_VERSION, "Unsupported synthetic workload model version");
+  CHECK(num_q >= 2, "Missing quantiles in synthetic workload model");
+  quantiles.resize(num_q);
+  for (long i = 0; i < num_q; ++i)
+    CHECK(fscanf(f, "%lg", &quantiles[i]) == 1, "Truncated synthetic workload model");
+  fclose(f);
+}
+
+void SyntheticTask::saveModel(const char *fname) const {
+  FILE *f = fopen(fname, "w");
+  CHECK(f != NULL, "Could not open synthetic workload model file for writing");
+  fprintf(f, "# ARSim synthetic workload model: Gaussian copula AR(1) with empirical marginal\n");
+  if (fit_fname.size() > 0)
+    fprintf(f, "# Fitted on column %d of %s (scaled by %g)\n", fit_col, fit_fname.c_str(), fit_mul);
+  fprintf(f, "version %d\n", SYN_MODEL_VERSION);
+  fprintf(f, "phi %.17g\n", phi);
+  fprintf(f, "quantiles %lu\n", (unsigned long) quantiles.size());
+  for (unsigned int i = 0; i < quantiles.size(); ++i)
+    fprintf(f, "%.17g\n", quantiles[i]);
+  fclose(f);
+}
+
+void SyntheticTask::setStreamId(uint64_t id) {
+  parent::setStreamId(id);
+  if (! rng_seeded) {
+    /* Keyed by the -crn seed (0 if not given) and the stream id. The AR(1)
+     * model draws a fixed number of samples per job, so in CRN mode the
+     * stream is already common to all configurations */
+    uint64_t x = crn_seed;
+    x = Rng::splitmix64(x) ^ id;
+    rng.setSeed(Rng::splitmix64(x));
+    z = rng.nextGaussian();
+  }
+}
+
+double SyntheticTask::generateInstance() {
+  z = phi * z + sqrt(1.0 - phi * phi) * rng.nextGaussian();
+  double u = 0.5 * erfc(-z / M_SQRT2);
+  double pos = u * (quantiles.size() - 1);
+  size_t i = (size_t) pos;
+  if (i >= quantiles.size() - 1)
+    return quantiles.back();
+  return quantiles[i] + (pos - i) * (quantiles[i + 1] - quantiles[i]);
+}
@@ -0,0 +1,98 @@
+/*
+ * ARSim
+ * Copyright (c) 2000-2010 Tommaso Cucinotta
+ *
+ * This file is part of ARSim.
+ *
+ * ARSim is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * ARSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with ARSim. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef __ARSIM_SYNTHETIC_TASK_HPP__
+#  define __ARSIM_SYNTHETIC_TASK_HPP__
+
+#include "DoubleLimitedTask.hpp"
+#include "Rng.hpp"
+
+#include <vector>
+#include <string>
+
+using namespace std;
+
+/** Task generating an unlimited synthetic workload from a compact
+ ** stochastic model fitted to a trace.
+ **
+ ** The model is a Gaussian copula with AR(1) dynamics: the trace
+ ** samples are mapped to normal scores through their empirical
+ ** distribution, whose lag-1 autocorrelation phi is estimated, then
+ ** new samples are generated as
+ **
+ **   z(k) = phi * z(k-1) + sqrt(1 - phi^2) * e(k),  e(k) ~ N(0,1)
+ **   c(k) = Q(Phi(z(k)))
+ **
+ ** where Q is the empirical quantile function of the trace, stored as
+ ** a table of evenly spaced quantiles. The model can be saved to, and
+ ** loaded from, a small text file, and each task draws from its own
+ ** random stream.
+ **/
+class SyntheticTask : public DoubleLimitedTask {
+
+ private:
+
+  typedef DoubleLimitedTask parent;
+
+  /* Fitting options */
+  string fit_fname;
+  int fit_col;
+  int fit_disc;
+  double fit_mul;
+  int num_quantiles;
+
+  string model_fname;	//< Model to load
+  string save_fname;	//< Where to save the fitted model
+
+  /* Model */
+  double phi;
+  vector<double> quantiles;
+
+  Rng rng;
+  bool rng_seeded;	//< Seed set with -syn-seed
+  double z;
+
+  void fitModel();
+  void loadModel(const char *fname);
+  void saveModel(const char *fname) const;
+
+ public:
+
+  SyntheticTask();
+
+  /** Return next task instance time c(k) */
+  double generateInstance();
+  /** In CRN mode, also reseed the task stream from the stream id */
+  virtual void setStreamId(uint64_t id);
+  bool parseArg(int& argc, char **& argv);
+
+  static void usage();
+
+  virtual bool checkParams();
+  virtual void calcParams();
+
+  double getPhi() const { return phi; }
+  const vector<double> & getQuantiles() const { return quantiles; }
+
+  /** Inverse of the standard normal CDF */
+  static double invPhi(double p);
+};
+
+#endif
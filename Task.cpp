@@ -25,6 +25,7 @@
 #include "util.hpp"
 #include "FileUtil.hpp"
 #include "Task.hpp"
+#include "Rng.hpp"
 
 /* Implementation includes */
 
@@ -33,11 +34,18 @@
 #include <string.h>
 
 int Task::next_task_id = 0;
+bool Task::crn_enabled = false;
+uint64_t Task::crn_seed = 0;
 
 Task::Task() {
+#ifndef ARSIM_EMBEDDED
   srandom(time(NULL));
+#endif
   setParams(DEF_T, DEF_h, DEF_H);
   task_id = Task::next_task_id++;
+  stream_id = task_id;
+  stream_job = 0;
+  stream_draw = 0;
   c_min = UNASSIGNED;
   c_max = UNASSIGNED;
   app_mode = 0;
@@ -63,10 +71,20 @@ double Task::generateInstance() {
 }
 
 double Task::generateWorkingTime() {
+  stream_draw = 0;
   double wt = generateInstance();
+  stream_job++;
   return app_mode_models[app_mode]->estimate(wt);
 }
 
+double Task::getStreamRandom() {
+  uint64_t x = crn_seed;
+  x = Rng::splitmix64(x) ^ stream_id;
+  x = Rng::splitmix64(x) ^ (uint64_t) stream_job;
+  x = Rng::splitmix64(x) ^ stream_draw++;
+  return (Rng::splitmix64(x) >> 11) * (1.0 / 9007199254740992.0);
+}
+
 void Task::usage() {
   printf("    TASK OPTIONS\n");
   printf("(-t any)   -T      Period (default %g)\n", DEF_T);
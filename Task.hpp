@@ -28,6 +28,7 @@
 
 #include <stdlib.h>
 #include <vector>
+#include <stdint.h>
 
 class Task : public Component {
 
@@ -36,12 +37,31 @@ class Task : public Component {
   double period;
   double c_min, c_max;
 
-  static double getRandom() { return double(random())/double(RAND_MAX); }
+  /** Uniform random number for the current job: drawn from the global
+   ** random() sequence, or from the task stream in CRN mode	*/
+  double getRandom() {
+    if (! crn_enabled)
+      return double(random())/double(RAND_MAX);
+    return getStreamRandom();
+  }
 
   static int next_task_id;
+  static bool crn_enabled;	/**< Common random numbers mode	*/
+  static uint64_t crn_seed;
+  friend class SimContext;
 
   int task_id;
 
+  /** CRN stream of the task: key, index of the next job and of the next
+   ** draw within it					*/
+  uint64_t stream_id;
+  long stream_job;
+  unsigned int stream_draw;
+
+  /** Counter-based draw, a function of (crn_seed, stream_id, stream_job,
+   ** stream_draw) only					*/
+  double getStreamRandom();
+
   /** Current application mode (0 is the most powerful) **/
   unsigned int app_mode;
   unsigned int prev_app_mode;
@@ -65,6 +85,14 @@ class Task : public Component {
   virtual void setParams(double T, double min_c, double max_c);
   /** Return next task instance time c(k) corresponding to the current application mode */
   virtual double generateWorkingTime();
+
+  /** Enable common random numbers: each task draws from its own stream,
+   ** keyed by stream id and job index, and independent of the other tasks */
+  static void setCRN(uint64_t seed) { crn_enabled = true;  crn_seed = seed; }
+  static bool isCRN() { return crn_enabled; }
+  /** Set the identity of the task stream, which must not depend on the
+   ** compared configurations (e.g., resource and position of the task) */
+  virtual void setStreamId(uint64_t id) { stream_id = id; }
   /** Return task period				*/
   double getPeriod() const { return period; }
   /** Return min task instance execution time	*/
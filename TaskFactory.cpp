@@ -5,6 +5,7 @@
 #include "SpikeTask.hpp"
 #include "TriSpikeTask.hpp"
 #include "TraceTask.hpp"
+#include "SyntheticTask.hpp"
 #include "CmdlineTask.hpp"
 #include "MultiModeTask.hpp"
 #include "TPMoveableMean.hpp"
@@ -25,6 +26,8 @@ Task * TaskFactory::getInstance(const char * s) {
     return new TriSpikeTask();
   else if (strcmp(s, "tr") == 0)
     return new TraceTask();
+  else if (strcmp(s, "syn") == 0)
+    return new SyntheticTask();
   else if (strcmp(s, "cl") == 0)
     return new CmdlineTask();
   else if (strcmp(s, "mmt") == 0)
@@ -40,5 +43,6 @@ void TaskFactory::usage() {
   SpikeTask::usage();
   TriangleTask::usage();
   TraceTask::usage();
+  SyntheticTask::usage();
   CmdlineTask::usage();
 }
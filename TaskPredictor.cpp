@@ -19,7 +19,13 @@
  */
 
 #include "TaskPredictor.hpp"
+#include "TaskPredictorT.hpp"
 #include "DoubleRangePredictor.hpp"
+#include "TPMoveableMean.hpp"
+#include "TPMultiMoveableMean.hpp"
+#include "TPStaticValue.hpp"
+#include "RPStatBased.hpp"
+#include "RPStaticRange.hpp"
 
 #include <string.h>
 #include <math.h>
@@ -27,6 +33,7 @@
 TaskPredictor::TaskPredictor() {
   p_vpred = ValuePredictor::getInstance("mm");
   p_rpred = RangePredictor::getInstance("sb");
+  p_drpred = dynamic_cast<DoubleRangePredictor*>(p_rpred);
   p_curr_rpred = p_rpred;
   p_rpred_i = 0;
   sample_size = 8;
@@ -35,9 +42,13 @@ TaskPredictor::TaskPredictor() {
   perfect_pred = false;
   perfect_pred_alpha = UNASSIGNED;
   perfect_pred_sample = 0.0;
+  dyn_dispatch = false;
+  version = 1;
+  exp_value_ver = exp_iv_ver = exp_iv_i_ver = 0;
 }
 
 void TaskPredictor::clearHistory() {
+  version++;
   q.clear();
   sum = 0.0;
   sum_sqr = 0.0;
@@ -53,11 +64,13 @@ void TaskPredictor::usage() {
   printf("          -srp     Stack range predictor after value predictor\n");
   printf("           -pp     Enable perfect prediction\n");
   printf("           -pp-a   Enable perfect prediction specified range alpha\n");
+  printf("           -pdyn   Always call predictors through virtual methods\n");
   ValuePredictor::usage();
   RangePredictor::usage();
 }
 
 bool TaskPredictor::parseArg(int& argc, char **& argv) {
+  version++;
   if (strcmp(*argv, "-vp") == 0) {
     CHECK(argc > 1, "Option requires an argument");
     argv++;  argc--;
@@ -72,6 +85,7 @@ bool TaskPredictor::parseArg(int& argc, char **& argv) {
       delete p_rpred;
     p_rpred = RangePredictor::getInstance(*argv);
     CHECK(p_rpred != 0, "Unknown range predictor type !");
+    p_drpred = dynamic_cast<DoubleRangePredictor*>(p_rpred);
     p_curr_rpred = p_rpred;
   } else if (strcmp(*argv, "-irp") == 0) {
     CHECK(argc > 1, "Option requires an argument");
@@ -83,6 +97,8 @@ bool TaskPredictor::parseArg(int& argc, char **& argv) {
     p_curr_rpred = p_rpred_i;
   } else if (strcmp(*argv, "-srp") == 0) {
     this->stack_rp = true;
+  } else if (strcmp(*argv, "-pdyn") == 0) {
+    this->dyn_dispatch = true;
   } else if (strcmp(*argv, "-pp") == 0) {
     this->perfect_pred = true;
   } else if (strcmp(*argv, "-pp-a") == 0) {
@@ -101,24 +117,27 @@ bool TaskPredictor::parseArg(int& argc, char **& argv) {
 }
 
 void TaskPredictor::calcParams() {
+  version++;
   ASSERT(p_vpred != 0, "No value predictor instantiated for task predictor");
   p_vpred->calcParams();
   ASSERT(p_rpred != 0, "No range predictor instantiated for task predictor");
   p_rpred->calcParams();
 }
 
-/** Add a c_k sample */
-void TaskPredictor::addSample(double sample) {
+/** Add a c_k sample, calling the predictors as specified by C */
+template <class C>
+void TaskPredictor::addSampleT(double sample) {
+  version++;
   if (! stack_rp) {
-    p_vpred->addSample(sample);
-    p_rpred->addSample(sample);
+    C::addValueSample(p_vpred, sample);
+    C::addRangeSample(p_rpred, sample);
     if (p_rpred_i != 0)
       p_rpred_i->addSample(sample);
   } else {
-    double old_pred = p_vpred->getExpValue();
-    p_vpred->addSample(sample);
+    double old_pred = C::expValue(p_vpred);
+    C::addValueSample(p_vpred, sample);
     if (old_pred != 0 && old_pred != -1) {
-      p_rpred->addSample(sample - old_pred);
+      C::addRangeSample(p_rpred, sample - old_pred);
       if (p_rpred_i != 0)
         p_rpred_i->addSample(sample - old_pred);
     }
@@ -136,10 +155,39 @@ void TaskPredictor::addSample(double sample) {
   }
 }
 
-/** Return expected next value */
+void TaskPredictor::addSample(double sample) {
+  addSampleT<VirtualCalls>(sample);
+}
+
+/** Return expected next value, computing it at most once per version */
 double TaskPredictor::getExpValue() const {
+  if (exp_value_ver != version) {
+    exp_value = calcExpValue();
+    exp_value_ver = version;
+  }
+  return exp_value;
+}
+
+Interval TaskPredictor::getExpInterval() const {
+  if (exp_iv_ver != version) {
+    exp_iv = calcExpInterval();
+    exp_iv_ver = version;
+  }
+  return exp_iv;
+}
+
+Interval TaskPredictor::getExpIntervalI() const {
+  if (exp_iv_i_ver != version) {
+    exp_iv_i = calcExpIntervalI();
+    exp_iv_i_ver = version;
+  }
+  return exp_iv_i;
+}
+
+template <class C>
+double TaskPredictor::calcExpValueT() const {
   if (! perfect_pred) {
-    return p_vpred->getExpValue();
+    return C::expValue(p_vpred);
   } else {
     Logger::debugLog("Returning perfectly predicted sample: %g\n", perfect_pred_sample);
     return perfect_pred_sample;
@@ -147,9 +195,10 @@ double TaskPredictor::getExpValue() const {
 }
 
 /** Return range in which next sample would reside with high probability */
-Interval TaskPredictor::getExpInterval() const {
+template <class C>
+Interval TaskPredictor::calcExpIntervalT() const {
   if (! stack_rp) {
-    Interval rpred_iv = p_rpred->getExpInterval();
+    Interval rpred_iv = C::expInterval(p_rpred);
     if (! perfect_pred)
       return rpred_iv;
     else {
@@ -169,7 +218,7 @@ Interval TaskPredictor::getExpInterval() const {
   } else {
     double exp_value = getExpValue();
     Logger::debugLog("Evaluating expected pred error interval\n");
-    Interval rpred_iv = p_rpred->getExpInterval();
+    Interval rpred_iv = C::expInterval(p_rpred);
     Logger::debugLog("range pred iv: [%g,%g] (to be shifted by exp_value=%g)\n", rpred_iv.getMin(), rpred_iv.getMax(), exp_value);
     if (exp_value == -1 || rpred_iv.isEmpty())
       return Interval();
@@ -192,18 +241,14 @@ Interval TaskPredictor::getExpInterval() const {
   }
 }
 
-/** Return range in which next sample would reside with high probability */
-Interval TaskPredictor::getExpIntervalI() const {
+/** Return smaller range in which next sample would reside with lower probability */
+template <class C>
+Interval TaskPredictor::calcExpIntervalIT() const {
   Interval iv;
-  if (p_rpred_i != 0) {
+  if (p_rpred_i != 0)
     iv = p_rpred_i->getExpInterval();
-  } else {
-    DoubleRangePredictor *p_drpred = dynamic_cast<DoubleRangePredictor*>(p_rpred);
-    if (p_drpred != 0)
-      iv = p_drpred->getExpIntervalI();
-    else
-      iv = p_rpred->getExpInterval();
-  }
+  else
+    iv = C::expIntervalI(p_rpred, p_drpred);
   if (iv.isEmpty())
     return Interval();
   if (! stack_rp) {
@@ -215,6 +260,50 @@ Interval TaskPredictor::getExpIntervalI() const {
   }
 }
 
+double TaskPredictor::calcExpValue() const {
+  return calcExpValueT<VirtualCalls>();
+}
+
+Interval TaskPredictor::calcExpInterval() const {
+  return calcExpIntervalT<VirtualCalls>();
+}
+
+Interval TaskPredictor::calcExpIntervalI() const {
+  return calcExpIntervalIT<VirtualCalls>();
+}
+
+/* The value x range predictor combinations bound at compile-time: every
+ * other one is served through the virtual methods of the plain TaskPredictor
+ */
+TaskPredictor *TaskPredictor::compose(TaskPredictor *p_tpred) {
+  if (typeid(*p_tpred) != typeid(TaskPredictor)) {
+    if (p_tpred->isBound() && ! p_tpred->dyn_dispatch)
+      return p_tpred;
+    /* Predictor types changed after the composition: start over from a
+     * plain TaskPredictor, taking over the predictors */
+    TaskPredictor *p_plain = new TaskPredictor(*p_tpred);
+    delete p_tpred;
+    p_tpred = p_plain;
+  }
+  if (p_tpred->dyn_dispatch)
+    return p_tpred;
+  TaskPredictor *p_new = TaskPredictorT<TPMoveableMean, RPStatBased>::create(*p_tpred);
+  if (p_new == 0)
+    p_new = TaskPredictorT<TPMoveableMean, RPStaticRange>::create(*p_tpred);
+  if (p_new == 0)
+    p_new = TaskPredictorT<TPMultiMoveableMean, RPStatBased>::create(*p_tpred);
+  if (p_new == 0)
+    p_new = TaskPredictorT<TPStaticValue, RPStatBased>::create(*p_tpred);
+  if (p_new == 0)
+    p_new = TaskPredictorT<TPStaticValue, RPStaticRange>::create(*p_tpred);
+  if (p_new == 0)
+    return p_tpred;
+  Logger::debugLog("Composed task predictor bound at compile-time\n");
+  /* The new instance took over the value and range predictors */
+  delete p_tpred;
+  return p_new;
+}
+
 /** Return standard deviation (unbiased estimation) **/
 double TaskPredictor::getDevValue() const {
   if (q.size() < 2)
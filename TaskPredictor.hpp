@@ -30,6 +30,8 @@
 
 using namespace std;
 
+class DoubleRangePredictor;
+
 /** This class represents a generic predictor for a task working times.
  **
  ** The static getInstance() method allows for instantiation of any
@@ -42,6 +44,7 @@ class TaskPredictor : public Component {
   ValuePredictor *p_vpred; //*< Task computation time value predictor
   RangePredictor *p_rpred; //*< Task computation time range predictor
   RangePredictor *p_rpred_i; //*< Task computation time internal range predictor
+  DoubleRangePredictor *p_drpred; //*< p_rpred, if it is a DoubleRangePredictor
   bool stack_rp;           //*< RangePredictor stacked after ValuePredictor
 
   deque<double> q;
@@ -57,6 +60,28 @@ class TaskPredictor : public Component {
   double perfect_pred_alpha;
   /** Perfectly predicted (i.e. next) sample    */
   double perfect_pred_sample;
+  /** Disable the compile-time composition of compose()	*/
+  bool dyn_dispatch;
+
+  /** Bumped whenever the outputs of the predictor may change, i.e., on
+   ** new samples, history clears, perfect predictions and options	*/
+  unsigned long version;
+  /** Last computed outputs, valid while their version matches version */
+  mutable double exp_value;
+  mutable Interval exp_iv, exp_iv_i;
+  mutable unsigned long exp_value_ver, exp_iv_ver, exp_iv_i_ver;
+
+  /** Compute the outputs that the get*() methods cache	*/
+  virtual double calcExpValue() const;
+  virtual Interval calcExpInterval() const;
+  virtual Interval calcExpIntervalI() const;
+
+  /** Implementations of the above and of addSample(), calling the
+   ** value and range predictors through the C policy of TaskPredictorT.hpp */
+  template <class C> void addSampleT(double sample);
+  template <class C> double calcExpValueT() const;
+  template <class C> Interval calcExpIntervalT() const;
+  template <class C> Interval calcExpIntervalIT() const;
 
  public:
 
@@ -66,6 +91,20 @@ class TaskPredictor : public Component {
   virtual bool parseArg(int& argc, char **& argv);
   void calcParams();
 
+  /** Replace p_tpred with a TaskPredictorT instance bound at compile-time
+   ** to its value and range predictors, if their combination is among the
+   ** instantiated ones, returning the predictor to be used from now on.
+   ** To be called after options have been parsed, also again: an instance
+   ** no longer matching its predictors (or with -pdyn) is re-composed.
+   **/
+  static TaskPredictor *compose(TaskPredictor *p_tpred);
+
+  /** True if bound by compose() to the types of its current predictors */
+  virtual bool isBound() const { return false; }
+
+  ValuePredictor *getValuePredictor() const { return p_vpred; }
+  RangePredictor *getRangePredictor() const { return p_rpred; }
+
   /** Add a c_k sample */
   virtual void addSample(double sample);
   /** Return range in which next sample would reside with high probability */
@@ -91,8 +130,13 @@ class TaskPredictor : public Component {
    **/
   void setPerfectPrediction(double sample) {
     perfect_pred_sample = sample;
+    if (perfect_pred)
+      version++;
   }
 
+  /** Version of the predictor state, changing along with its outputs */
+  unsigned long getVersion() const { return version; }
+
   virtual void clearHistory();
 };
 
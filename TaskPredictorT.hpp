@@ -0,0 +1,132 @@
+/*
+ * ARSim
+ * Copyright (c) 2000-2010 Tommaso Cucinotta
+ *
+ * This file is part of ARSim.
+ *
+ * ARSim is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * ARSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with ARSim. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef __ARSIM_TASK_PREDICTOR_T_HPP__
+#  define __ARSIM_TASK_PREDICTOR_T_HPP__
+
+#include "TaskPredictor.hpp"
+#include "DoubleRangePredictor.hpp"
+
+#include <typeinfo>
+
+/** Policy for the TaskPredictor::*T() methods, calling the value and range
+ ** predictors through their virtual methods, whatever their actual type.
+ **/
+struct VirtualCalls {
+  static double expValue(ValuePredictor *p) { return p->getExpValue(); }
+  static void addValueSample(ValuePredictor *p, double x) { p->addSample(x); }
+  static Interval expInterval(RangePredictor *p) { return p->getExpInterval(); }
+  static void addRangeSample(RangePredictor *p, double x) { p->addSample(x); }
+  static Interval expIntervalI(RangePredictor *p, DoubleRangePredictor *p_d) {
+    return p_d != 0 ? p_d->getExpIntervalI() : p->getExpInterval();
+  }
+};
+
+/** Internal range of a DoubleRangePredictor, or plain range otherwise,
+ ** selected by overload resolution on the static type RP.
+ **/
+template <class RP>
+inline Interval staticExpIntervalI(RP *p, DoubleRangePredictor *) { return p->RP::getExpIntervalI(); }
+template <class RP>
+inline Interval staticExpIntervalI(RP *p, RangePredictor *) { return p->RP::getExpInterval(); }
+
+/** Policy for the TaskPredictor::*T() methods, for predictors known to be
+ ** exactly of types VP and RP: qualified calls bypass the virtual tables,
+ ** and RP::getExpIntervalI() needs no dynamic_cast.
+ **/
+template <class VP, class RP>
+struct StaticCalls {
+  static double expValue(ValuePredictor *p) { return static_cast<VP*>(p)->VP::getExpValue(); }
+  static void addValueSample(ValuePredictor *p, double x) { static_cast<VP*>(p)->VP::addSample(x); }
+  static Interval expInterval(RangePredictor *p) { return static_cast<RP*>(p)->RP::getExpInterval(); }
+  static void addRangeSample(RangePredictor *p, double x) { static_cast<RP*>(p)->RP::addSample(x); }
+  static Interval expIntervalI(RangePredictor *p, DoubleRangePredictor *) {
+    RP *p_rp = static_cast<RP*>(p);
+    return staticExpIntervalI(p_rp, p_rp);
+  }
+};
+
+/** TaskPredictor composed at compile-time with a VP value predictor and
+ ** a RP range predictor. Instances are only built by TaskPredictor::compose(),
+ ** once the predictor types selected on the command-line are known, so
+ ** that the per-job path from the controller to the predictors crosses a
+ ** single virtual call. The combinations available are instantiated in
+ ** TaskPredictor.cpp; any other one keeps using the plain TaskPredictor.
+ **
+ ** Options parsed later (e.g., through arsim_set_options()) may replace the
+ ** value or range predictor: the instance then falls back to virtual calls,
+ ** until compose() replaces it with a plain TaskPredictor.
+ **/
+template <class VP, class RP>
+class TaskPredictorT : public TaskPredictor {
+
+ protected:
+
+  typedef StaticCalls<VP, RP> Calls;
+
+  /** Whether p_vpred and p_rpred are still exactly VP and RP */
+  bool bound;
+
+  static bool matches(const TaskPredictor & tp) {
+    return tp.getValuePredictor() != 0 && tp.getRangePredictor() != 0
+      && typeid(*tp.getValuePredictor()) == typeid(VP)
+      && typeid(*tp.getRangePredictor()) == typeid(RP);
+  }
+
+  TaskPredictorT(const TaskPredictor & tp) : TaskPredictor(tp), bound(true) { }
+
+  virtual double calcExpValue() const {
+    return bound ? calcExpValueT<Calls>() : calcExpValueT<VirtualCalls>();
+  }
+  virtual Interval calcExpInterval() const {
+    return bound ? calcExpIntervalT<Calls>() : calcExpIntervalT<VirtualCalls>();
+  }
+  virtual Interval calcExpIntervalI() const {
+    return bound ? calcExpIntervalIT<Calls>() : calcExpIntervalIT<VirtualCalls>();
+  }
+
+ public:
+
+  /** Copy tp, taking over its predictors, if they are exactly VP and RP */
+  static TaskPredictor *create(const TaskPredictor & tp) {
+    if (! matches(tp))
+      return 0;
+    return new TaskPredictorT(tp);
+  }
+
+  virtual bool parseArg(int& argc, char **& argv) {
+    /* Unbound while predictors may be replaced, also if parsing fails */
+    bound = false;
+    bool parsed = TaskPredictor::parseArg(argc, argv);
+    bound = matches(*this);
+    return parsed;
+  }
+
+  virtual bool isBound() const { return bound; }
+
+  virtual void addSample(double sample) {
+    if (bound)
+      addSampleT<Calls>(sample);
+    else
+      addSampleT<VirtualCalls>(sample);
+  }
+};
+
+#endif
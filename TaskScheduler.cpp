@@ -26,22 +26,28 @@
 #include "defaults.hpp"
 #include "TaskPredictor.hpp"
 #include "GlobalOptimizer.hpp"
+#include "TimelineExporter.hpp"
+#include "ControllerBank.hpp"
+#include "Profiler.hpp"
+#include "StatFactory.hpp"
 
 #include <sstream>
 
 TaskScheduler::TaskScheduler(Controller *p_s, ResourceManager *p_gs)
-: bw_time_stat(0.0, 1.0, 0.01),
-rbw_time_stat(0.0, 1.0, 0.01),
-rbw_avg_time_stat(0.0, 1.0, 0.01),
-dbw_time_stat(0.0, 1.0, 0.01),
-rsteps_stat(0.0, 10.0, 1.0),
-pinv_stat(0.0, 2.0, 1.0),
-pinvi_stat(0.0, 2.0, 1.0),
-pinv_stat_temp(0.0, 2.0, 1.0)
+: rbw_avg_time_stat(0.0, 1.0, 1.0),
+se_stat_spec("hist"),
+ck_stat_spec("hist")
 {
   p_sched = p_s;
   p_gsched = p_gs;
 
+  bw_time_stat = StatFactory::getInstance("hist", 0.0, 1.0, 0.01, true, EventList::getTime());
+  rbw_time_stat = StatFactory::getInstance("hist", 0.0, 1.0, 0.01, true, EventList::getTime());
+  dbw_time_stat = StatFactory::getInstance("hist", 0.0, 1.0, 0.01, true, EventList::getTime());
+  rsteps_stat = StatFactory::getInstance("hist", 0.0, 10.0, 1.0, false);
+  pinv_stat = StatFactory::getInstance("hist", 0.0, 2.0, 1.0, false);
+  pinvi_stat = StatFactory::getInstance("hist", 0.0, 2.0, 1.0, false);
+
   p_job_arrive = p_job_end = p_job_start = 0;
   c_current_left = 0.0;
   curr_job_id = 0;
@@ -58,6 +64,10 @@ pinv_stat_temp(0.0, 2.0, 1.0)
   int num_rs = getResourceManager()->getResourceId();
   // New TaskScheduler not registered yet into the ResourceManager
   int num_task = getResourceManager()->getTaskSchedulerNum();
+  task_pos = num_task;
+  p_table = &getResourceManager()->getTaskTable();
+  p_table->addTask();
+  bank_slot = -1;
 
   fname = strdup("task0,0.dat");
   fname[4] = '0' + num_task;
@@ -71,6 +81,7 @@ pinv_stat_temp(0.0, 2.0, 1.0)
   pl_blocked = false;
 
   se_stat = 0; /**< Allow for command line sched err statistics customization	*/
+  rbw_load_stat = 0;
   ck_stat = 0; /**< Allow for command line c_k statistics customization	*/
 
   pl_next_str = pl_prev_str = 0;
@@ -80,6 +91,11 @@ pinv_stat_temp(0.0, 2.0, 1.0)
 
   se_trace_file = 0;
 
+  rec_file = 0;
+  rec_header = false;
+  rec_t_start = rec_start_err = 0.0;
+  rec_bw_req = 0.0;
+
   weight = 1.0;
 }
 
@@ -92,7 +108,9 @@ void TaskScheduler::usage() {
   printf("           -inv-ei Set virtual 2nd invariant for statistics\n");
   printf("           -inv-Ei Set virtual 2nd invariant for statistics\n");
   printf("           -w      Set weight for bandwidth distribution\n");
-  printf("           -t      Set task type: u/s/t/p/tp/tr/cl\n");
+  StatFactory::usage();
+  printf("           -rec    Record per-job c_k, errors and bandwidths to the specified file, for -rpl\n");
+  printf("           -t      Set task type: u/s/t/p/tp/tr/syn/cl\n");
   Task::usage();
   TaskFactory::usage();
   Controller::usage();
@@ -155,6 +173,44 @@ bool TaskScheduler::parseArg(int & argc, char ** & argv) {
     argc--;
     CHECK(sscanf(*argv, "%lg", &weight) == 1, "Expecting double as argument to -w option");
     CHECK(weight> 0.0, "Expecting strictly positive real as argument to -w option");
+    p_table->setWeight(task_pos, weight);
+  } else if (strcmp(*argv, "-stat") == 0) {
+    CHECK(argc > 1, "Option requires an argument");
+    argv++;  argc--;
+    char *spec = strchr(*argv, '=');
+    CHECK(spec != 0, "Expecting name=type[:param] as argument to -stat option");
+    string name(*argv, spec - *argv);
+    spec++;
+    CHECK1(StatFactory::isValid(spec), "Unknown statistics type specification: %s", spec);
+    if (name == "se") {
+      se_stat_spec = spec;
+    } else if (name == "ck") {
+      ck_stat_spec = spec;
+    } else if (name == "rs" || name == "pi" || name == "pii") {
+      BaseStat **pp_stat = name == "rs" ? &rsteps_stat : (name == "pi" ? &pinv_stat : &pinvi_stat);
+      delete *pp_stat;
+      *pp_stat = StatFactory::getInstance(spec, 0.0, name == "rs" ? 10.0 : 2.0, 1.0, false);
+    } else if (name == "bw" || name == "rbw" || name == "dbw") {
+      /* Time-weighted bandwidth stats are replaced right away, before any change */
+      BaseStat **pp_stat = 0;
+      if (name == "bw")
+        pp_stat = &bw_time_stat;
+      else if (name == "rbw")
+        pp_stat = &rbw_time_stat;
+      else
+        pp_stat = &dbw_time_stat;
+      double x = name == "rbw" ? bw_required : (name == "bw" ? bw_current : bw_required - bw_current);
+      delete *pp_stat;
+      *pp_stat = StatFactory::getInstance(spec, 0.0, 1.0, 0.01, true, EventList::getTime());
+      (*pp_stat)->addSample(x, EventList::getTime());
+    } else
+      CHECK1(p_sched->setStat(name, spec), "Unknown statistic name for -stat option: %s", name.c_str());
+  } else if (strcmp(*argv, "-rec") == 0) {
+    CHECK(argc > 1, "Option requires an argument");
+    argv++;  argc--;
+    CHECK(rec_file == 0, "Job record file already specified for this task");
+    rec_file = fopen(*argv, "w");
+    CHECK1(rec_file != 0, "Could not open job record file %s", *argv);
   } else if (strcmp(*argv, "-t") == 0) {
     CHECK(argc > 1, "Option requires an argument");
     argv++;  argc--;
@@ -204,6 +260,7 @@ void TaskScheduler::addEventJobEnd(Time c, double b) {
       = makeEvent(delta_t, p_gsched, &ResourceManager::handleJobEnd, this);
   ASSERT(p_job_end != 0, "No more memory");
   EventList::events().insert(p_job_end);
+  p_table->setRunning(task_pos, true);
 }
 
 /** Add eps stats customization through command line options */
@@ -212,7 +269,7 @@ void TaskScheduler::handleSimStart(const Event & ev) {
   Logger::debugLog("# T=%g: handling sim start\n", EventList::getTime());
 
   if (!ceil_model) {
-    se_stat = new Stat(DEF_EPS_MIN, DEF_EPS_MAX, DEF_EPS_DX);
+    se_stat = StatFactory::getInstance(se_stat_spec.c_str(), DEF_EPS_MIN, DEF_EPS_MAX, DEF_EPS_DX, false);
   } else {
     /** Ceil model: account eps values as multiples of the server period */
     double T = getTask()->getPeriod();
@@ -220,14 +277,36 @@ void TaskScheduler::handleSimStart(const Event & ev) {
     double se_min = ((long) ((DEF_EPS_MIN - dx / 2) / dx)) * dx;
     double se_max = ((long) ((DEF_EPS_MAX + dx / 2) / dx)) * dx;
     Logger::debugLog("Creating Stat with: [%g:%g:%g]", se_min, dx, se_max);
-    se_stat = new Stat(se_min, se_max, dx);
+    se_stat = StatFactory::getInstance(se_stat_spec.c_str(), se_min, se_max, dx, false);
   }
   ASSERT(se_stat != 0, "Could not allocate Stat object !");
 
-  ck_stat = new Stat(0.0, getTask()->getMaxExecutionTime() / getTask()->getPeriod(), 0.001);
+  ck_stat = StatFactory::getInstance(ck_stat_spec.c_str(), 0.0,
+                                     getTask()->getMaxExecutionTime() / getTask()->getPeriod(), 0.001, false);
   ASSERT(ck_stat != 0, "Could not allocate Stat object !");
   fprintf(stderr, "# ck_stat size = %ld (max c_k=%g)\n", ck_stat->getPMFSize(), getTask()->getMaxExecutionTime());
 
+  if (ControllerBank::getInstance()->isEnabled())
+    bank_slot = ControllerBank::getInstance()->addController(p_sched);
+
+  const char *bw_avg_type = GlobalOptimizer::getInstance()->getBwAvgType();
+  if (strcmp(bw_avg_type, "epoch") != 0) {
+    /* Without -gc-p, the horizon defaults to the task period */
+    double horizon = GlobalOptimizer::getInstance()->getOptPeriod();
+    if (horizon == 0.0)
+      horizon = getTask()->getPeriod();
+    rbw_load_stat = StatFactory::getMovingInstance(bw_avg_type, horizon, EventList::getTime());
+    ASSERT(rbw_load_stat != 0, "Could not allocate MovingTimeStat object !");
+  }
+
+#ifdef WITH_PROFILER
+  ostringstream os;
+  os << task_pos << "," << p_gsched->getResourceId();
+  PROF_NAME(this, "TaskScheduler " + os.str());
+  PROF_NAME(p_sched, "Controller " + os.str());
+  PROF_NAME(p_sched->getTaskPredictor(), "TaskPredictor " + os.str());
+#endif
+
   if (pl_prev.size() == 0)
     addEventJobArrive(0);
   else
@@ -238,6 +317,8 @@ void TaskScheduler::handleJobArrive(const Event & ev) {
   ASSERT(getTask() != 0, "Null task");
   Logger::debugLog("# T=%g: handling job arrive\n", EventList::getTime());
   num_jobs++;
+  if (TimelineExporter::getInstance()->isEnabled())
+    TimelineExporter::getInstance()->jobArrive(this, curr_job_id + num_jobs);
   if (num_jobs == 1) {
     /* Previous job already finished. Check previous jobs in pipeline	*/
     if (checkPipelinePrevJobs(curr_job_id+1)) {
@@ -273,13 +354,18 @@ void TaskScheduler::handleJobArrive(const Event & ev) {
 
 void TaskScheduler::updateRequiredBandwidthAvg() {
   double est_H_k;
-  if ( ck_perc_est_temp.getExpInterval().isEmpty() )
+  Interval ck_iv = ck_perc_est_temp.getExpInterval();
+  if ( ck_iv.isEmpty() )
     est_H_k = getTask()->getMaxExecutionTime();
   else
-    est_H_k = ck_perc_est_temp.getExpInterval().getMax();
+    est_H_k = ck_iv.getMax();
   // double rbw_iot = p_sched->getBandwidthIfOnTime();
   double rbw_iot = est_H_k / getTask()->getPeriod();
   rbw_avg_time_stat.addSample(rbw_iot, EventList::getTime());
+  /* The moving estimate keeps holding its last value while the percentile
+   * estimator is empty after a clearHistory(), instead of jumping to C_max */
+  if (rbw_load_stat != 0 && (!ck_iv.isEmpty() || !rbw_load_stat->hasSamples()))
+    rbw_load_stat->addSample(rbw_iot, EventList::getTime());
   Logger::debugLog("Required bw (if on time [est_H_k/T=%g]): %g, Avg: %g, Max: %g (app_mode: %d, res_mode: %d)\n",
 		   est_H_k / getTask()->getPeriod(), rbw_iot,
 		   rbw_avg_time_stat.getMean(), rbw_avg_time_stat.getMax(),
@@ -310,12 +396,31 @@ void TaskScheduler::handleJobStart(const Event & ev) {
   /* Compute next task instance					*/
   c_current_left = getTask()->generateWorkingTime();
   c_current_total = c_current_left;
+  if (TimelineExporter::getInstance()->isEnabled())
+    TimelineExporter::getInstance()->jobStart(this, curr_job_id);
   ck_stat->addSample(c_current_total / getTask()->getPeriod());
   ck_perc_est_temp.addSample(c_current_total);
   /* Supply sample to predictor in order to allow perfect prediction (if enabled for the predictor) */
   p_sched->getTaskPredictor()->setPerfectPrediction(c_current_total);
+  /* Banked controllers compute all the bandwidths at this time at once */
+  if (bank_slot >= 0) {
+    ControllerBank::getInstance()->enqueue(bank_slot, this, sched_err, start_err);
+    return;
+  }
+  double bw;
+  {
+    PROF_SCOPE("Controller::calcBandwidth", p_sched);
+    bw = p_sched->calcBandwidth(sched_err, start_err);
+  }
+  completeJobStart(bw, start_err);
+}
+
+void TaskScheduler::completeJobStart(double bw, Time start_err) {
   /* Set required bandwidth (no delta update)			*/
-  setRequiredBandwidth(p_sched->calcBandwidth(sched_err, start_err));
+  setRequiredBandwidth(bw);
+  rec_t_start = t_start;
+  rec_start_err = start_err;
+  rec_bw_req = bw_required;
   updateRequiredBandwidthAvg();
   /* Assume no compression occurs: this will be checked by
    * ResourceManager each time					*/
@@ -340,6 +445,21 @@ void TaskScheduler::logSchedErrTrace(double err) {
   fprintf(se_trace_file, "%g\n", err);
 }
 
+void TaskScheduler::logJobRecord() {
+  if (! rec_header) {
+    fprintf(rec_file, "# arsim-record: T=%.17g c_min=%.17g c_max=%.17g inv_e=%.17g inv_E=%.17g\n",
+            getTask()->getPeriod(), getTask()->getMinExecutionTime(), getTask()->getMaxExecutionTime(),
+            inv_e, inv_E);
+    fprintf(rec_file, "# %9s %11s %11s %11s %11s %11s\n",
+            "job", "c_k", "start_err", "bw_req", "bw_granted", "sched_err");
+    rec_header = true;
+  }
+  /* Average bandwidth actually granted throughout the job */
+  double bw_granted = c_current_total / (EventList::getTime() - rec_t_start);
+  fprintf(rec_file, "%11ld %.17g %.17g %.17g %.17g %.17g\n",
+          curr_job_id, c_current_total, rec_start_err, rec_bw_req, bw_granted, sched_err);
+}
+
 void TaskScheduler::handleJobEnd(const Event & ev) {
   ASSERT(num_jobs> 0, "handleJobEnd() with no jobs");
   ASSERT(p_job_end != 0, "handleJobEnd() with no p_job_end");
@@ -361,30 +481,35 @@ void TaskScheduler::handleJobEnd(const Event & ev) {
   }
 
   if (sched_err <= 0) {
-    rsteps_stat.addSample(rsteps); // Avoid imprecisions in accounting
+    rsteps_stat->addSample(rsteps); // Avoid imprecisions in accounting
     rsteps = 0;
   } else
     rsteps++;
 
   if ((sched_err >= -inv_e) && (sched_err <= inv_E)) {
-    pinv_stat.addSample(1.0);
+    pinv_stat->addSample(1.0);
     pinv_stat_temp.addSample(1.0);
   } else {
-    pinv_stat.addSample(0.0);
+    pinv_stat->addSample(0.0);
     pinv_stat_temp.addSample(0.0);
   }
 
   if ((sched_err >= -inv_ei) && (sched_err <= inv_Ei))
-    pinvi_stat.addSample(1.0);
+    pinvi_stat->addSample(1.0);
   else
-    pinvi_stat.addSample(0.0);
+    pinvi_stat->addSample(0.0);
 
   logSchedErrTrace(sched_err);
+  if (rec_file != 0)
+    logJobRecord();
+  if (TimelineExporter::getInstance()->isEnabled())
+    TimelineExporter::getInstance()->jobEnd(this, curr_job_id, sched_err);
 
   Logger::debugLog("# T=%g: handling job %02d end with eps=%g\n",
       EventList::getTime(), curr_job_id, sched_err);
   num_jobs--;
   p_job_end = 0;
+  p_table->setRunning(task_pos, false);
   c_current_left = 0;
   last_job_id = curr_job_id;
   if (num_jobs > 0) {
@@ -431,23 +556,34 @@ void TaskScheduler::handleJobEnd(const Event & ev) {
 
 void TaskScheduler::setCurrentBandwidthDelta(double b) {
   setCurrentBandwidth(b);
-  dbw_time_stat.addSample(bw_required - bw_current, EventList::getTime());
+  dbw_time_stat->addSample(bw_required - bw_current, EventList::getTime());
 }
 
 void TaskScheduler::setCurrentBandwidth(double b) {
   bw_current = b;
+  p_table->setCurrentBandwidth(task_pos, b);
   Logger::debugLog("Current bw:%g (required bw: %g)\n", bw_current, bw_required);
-  bw_time_stat.addSample(bw_current, EventList::getTime());
+  bw_time_stat->addSample(bw_current, EventList::getTime());
+  if (TimelineExporter::getInstance()->isEnabled())
+    TimelineExporter::getInstance()->bandwidth(this, bw_current, bw_required);
 }
 
 void TaskScheduler::setRequiredBandwidthDelta(double b) {
   setRequiredBandwidth(b);
-  dbw_time_stat.addSample(bw_required - bw_current, EventList::getTime());
+  dbw_time_stat->addSample(bw_required - bw_current, EventList::getTime());
 }
 
 void TaskScheduler::setRequiredBandwidth(double b) {
   bw_required = b;
-  rbw_time_stat.addSample(bw_required, EventList::getTime());
+  p_table->setRequiredBandwidth(task_pos, b);
+  rbw_time_stat->addSample(bw_required, EventList::getTime());
+  if (TimelineExporter::getInstance()->isEnabled())
+    TimelineExporter::getInstance()->bandwidth(this, bw_current, bw_required);
+}
+
+void TaskScheduler::setMinBandwidth(double bw) {
+  p_sched->setMinBandwidth(bw);
+  p_table->setMinBandwidth(task_pos, bw);
 }
 
 void TaskScheduler::clearRequiredBandwidthAvg() {
@@ -459,6 +595,8 @@ void TaskScheduler::clearRequiredBandwidthAvg() {
 
 double TaskScheduler::getRequiredBandwidthAvg() {
   updateRequiredBandwidthAvg();
+  if (rbw_load_stat != 0)
+    return rbw_load_stat->getMean(EventList::getTime());
   return rbw_avg_time_stat.getMean();
     //ck_perc_est_temp.getExpInterval().getMax() / getTask()->getPeriod();
 
@@ -565,6 +703,17 @@ void TaskScheduler::dump() {
       bw_current, bw_required, bw_min, sched_err, pl_next_str, pl_prev_str);
 }
 
+void TaskScheduler::getStats(vector< pair<const char *, const BaseStat *> > & stats) const {
+  stats.push_back(make_pair("bw", (const BaseStat *) bw_time_stat));
+  stats.push_back(make_pair("rbw", (const BaseStat *) rbw_time_stat));
+  stats.push_back(make_pair("dbw", (const BaseStat *) dbw_time_stat));
+  stats.push_back(make_pair("se", (const BaseStat *) se_stat));
+  stats.push_back(make_pair("ck", (const BaseStat *) ck_stat));
+  stats.push_back(make_pair("rs", (const BaseStat *) rsteps_stat));
+  stats.push_back(make_pair("pi", (const BaseStat *) pinv_stat));
+  stats.push_back(make_pair("pii", (const BaseStat *) pinvi_stat));
+}
+
 void TaskScheduler::dumpStatistics() {
   int num_rs = getResourceManager()->getResourceId();
   int num_task = getResourceManager()->getTaskSchedulerPos(this);
@@ -574,21 +723,21 @@ void TaskScheduler::dumpStatistics() {
   bw_fname = strdup("bw_stats0,0.dat");
   bw_fname[8] = '0' + num_task;
   bw_fname[10] = '0' + num_rs;
-  bw_time_stat.dumpStat(bw_fname, "bw", false, "Granted bandwidth");
+  bw_time_stat->dumpStat(bw_fname, "bw", false, "Granted bandwidth");
 
   /** File where to dump req bandwidth stats to	*/
   char *rbw_fname;
   rbw_fname = strdup("rbw_stats0,0.dat");
   rbw_fname[9] = '0' + num_task;
   rbw_fname[11] = '0' + num_rs;
-  rbw_time_stat.dumpStat(rbw_fname, "rbw", false, "Required bandwidth");
+  rbw_time_stat->dumpStat(rbw_fname, "rbw", false, "Required bandwidth");
 
   /** File where to dump delta bandwid stats to	*/
   char *dbw_fname;
   dbw_fname = strdup("dbw_stats0,0.dat");
   dbw_fname[9] = '0' + num_task;
   dbw_fname[11] = '0' + num_rs;
-  dbw_time_stat.dumpStat(dbw_fname, "dbw", false, "Delta bandwidth");
+  dbw_time_stat->dumpStat(dbw_fname, "dbw", false, "Delta bandwidth");
 
   /** File where to dump sched err stats to	*/
   char *se_fname;
@@ -609,26 +758,26 @@ void TaskScheduler::dumpStatistics() {
   rsteps_fname = strdup("rs_stats0,0.dat");
   rsteps_fname[8] = '0' + num_task;
   rsteps_fname[10] = '0' + num_rs;
-  rsteps_stat.dumpStat(rsteps_fname, "rs", false, "Return steps to negative");
+  rsteps_stat->dumpStat(rsteps_fname, "rs", false, "Return steps to negative");
 
   /** Prob of Invariant */
   char *pi_fname;
   pi_fname = strdup("pi_stats0,0.dat");
   pi_fname[8] = '0' + num_task;
   pi_fname[10] = '0' + num_rs;
-  pinv_stat.dumpStat(pi_fname, "rs", false, "Prob{se in [-e,E]}");
+  pinv_stat->dumpStat(pi_fname, "rs", false, "Prob{se in [-e,E]}");
 
   /** Prob of Invariant */
   char *pii_fname;
   pii_fname = strdup("pii_stats0,0.dat");
   pii_fname[9] = '0' + num_task;
   pii_fname[11] = '0' + num_rs;
-  pinvi_stat.dumpStat(pii_fname, "rs", false, "Prob{se in [-ei,Ei]}");
+  pinvi_stat->dumpStat(pii_fname, "rs", false, "Prob{se in [-ei,Ei]}");
 
   fprintf(stderr, "# pinv(%d,%d) = %g ([-e,E]=[%g,%g])\n",
-  num_task, num_rs, pinv_stat.getMean(), -inv_e, inv_E);
+  num_task, num_rs, pinv_stat->getMean(), -inv_e, inv_E);
   fprintf(stderr, "# pinvi(%d,%d) = %g ([-ei,Ei]=[%g,%g])\n",
-  num_task, num_rs, pinvi_stat.getMean(), -inv_ei, inv_Ei);
+  num_task, num_rs, pinvi_stat->getMean(), -inv_ei, inv_Ei);
 
   p_sched->dumpStats();
 }
@@ -638,7 +787,22 @@ bool TaskScheduler::isRunning() {
 }
 
 TaskScheduler::~TaskScheduler() {
-  fclose(out_file);
+  if (out_file_opened)
+    fclose(out_file);
+  if (se_trace_file != 0)
+    fclose(se_trace_file);
+  if (rec_file != 0)
+    fclose(rec_file);
+  delete bw_time_stat;
+  delete rbw_time_stat;
+  delete dbw_time_stat;
+  delete se_stat;
+  delete ck_stat;
+  delete rsteps_stat;
+  delete pinv_stat;
+  delete pinvi_stat;
+  delete rbw_load_stat;
+  delete p_sched;
 }
 
 void TaskScheduler::addPipelineNext(TaskScheduler *p_tsched) {
@@ -694,6 +858,15 @@ bool TaskScheduler::checkParams() {
   return p_sched->checkParams();
 }
 
+void TaskScheduler::calcParams() {
+  p_sched->calcParams();
+  /* The controller -b option is parsed after the table slot is created,
+   * and may be passed again during the simulation */
+  p_table->setMinBandwidth(task_pos, p_sched->getMinBandwidth());
+  if (bank_slot >= 0)
+    ControllerBank::getInstance()->refresh(bank_slot);
+}
+
 void TaskScheduler::clearHistory() {
   p_sched->clearHistory();
   ck_perc_est_temp.clearHistory();
@@ -25,6 +25,9 @@
 #include "Controller.hpp"
 #include "Events.hpp"
 #include "TimeStat.hpp"
+#include "MovingTimeStat.hpp"
+#include "MeanStat.hpp"
+#include "TaskTable.hpp"
 #include "RPStatBased.hpp"
 
 #include <queue>
@@ -86,6 +89,16 @@ private:
   /** Count the number of class instances	*/
   static int num_tasks;
 
+  /** Position of this task within its ResourceManager	*/
+  int task_pos;
+
+  /** Supervisor view of the ResourceManager tasks, where this task
+   ** keeps its running flag, bandwidths and weight at task_pos		*/
+  TaskTable *p_table;
+
+  /** Slot in the ControllerBank, or -1 if the controller is not banked */
+  int bank_slot;
+
   /** File Name for All events trace */
   char *fname;
   /** File for All events trace */
@@ -96,37 +109,45 @@ private:
   FILE *se_trace_file;
 
   /** The temporal statistics for the bandwidth	*/
-  TimeStat bw_time_stat;	// Current
-  TimeStat rbw_time_stat;	// Required
+  BaseStat *bw_time_stat;	// Current
+  BaseStat *rbw_time_stat;	// Required
 
-  /** Statistics on required bandwidth since rbw_avg_time                 */
+  /** Statistics on required bandwidth since rbw_avg_time: only its mean
+   ** and max are used, so it has a single interval			 */
   TimeStat rbw_avg_time_stat;
   /** Last time at which the rbw_avg_time_stat statistics have been reset */
   Time rbw_avg_time;
+  /** Moving-horizon estimate of the required bandwidth, never reset,
+   ** used instead of rbw_avg_time_stat if selected with -gc-bw-avg	*/
+  MovingTimeStat *rbw_load_stat;
 
   /** Time statistics for required-assigned bw	*/
-  TimeStat dbw_time_stat;
+  BaseStat *dbw_time_stat;
 
   /** The event-based statistics for sched err	*/
-  Stat *se_stat;
+  BaseStat *se_stat;
 
   /** The statistics for c_k			*/
-  Stat *ck_stat;
+  BaseStat *ck_stat;
+
+  /** Type specifications (see StatFactory) for se_stat and ck_stat,
+   ** which are built at simulation start				*/
+  string se_stat_spec, ck_stat_spec;
 
   /** The percentile estimator for c_k, reset at each optimization period */
   RPStatBased ck_perc_est_temp;
 
   /** event-based statistics for number of consecutive jobs for which the sched err remains positive */
-  Stat rsteps_stat;
+  BaseStat *rsteps_stat;
 
   /** Partial number of consecutive jobs for which the sched err remains positive */
   int rsteps;
 
   double inv_e, inv_E;	//< Probability of s.e. inside this set always computed by emulator */
   double inv_ei, inv_Ei;//< Probability of s.e. inside this set always computed by emulator */
-  Stat pinv_stat;	//< Statistics of invariant respected */
-  Stat pinvi_stat;      //< Statistics of invariant respected */
-  Stat pinv_stat_temp;  //< Statistics of invariant respected (temporary, resets at each optimization period) */
+  BaseStat *pinv_stat;	//< Statistics of invariant respected */
+  BaseStat *pinvi_stat;	//< Statistics of invariant respected */
+  MeanStat pinv_stat_temp;  //< Statistics of invariant respected (temporary, resets at each optimization period) */
 
   /** Also updates statistics consistently	*/
   void setCurrentBandwidth(double b);
@@ -153,6 +174,17 @@ private:
   /** Log Scheduling Error to File */
   void logSchedErrTrace(double err);
 
+  /** Per-job record (c_k, start error, required and granted bandwidth,
+   ** scheduling error), for replaying controllers (see ReplayHarness) */
+  FILE *rec_file;
+  bool rec_header;
+  Time rec_t_start;
+  Time rec_start_err;
+  double rec_bw_req;
+
+  /** Append the record of the job just finished */
+  void logJobRecord();
+
   /** Weight used for weighted fair bandwidth distribution algorithms */
   double weight;
 
@@ -172,6 +204,8 @@ public:
   virtual void handleJobArrive(const Event & ev);
   /** Handle event: start of a job		*/
   void handleJobStart(const Event & ev);
+  /** Complete a job start, once the required bandwidth is known	*/
+  void completeJobStart(double bw, Time start_err);
   /** Handle event: end of a job		*/
   virtual void handleJobEnd(const Event & ev);
   /** Handle event: actually apply a bw change	*/
@@ -188,17 +222,24 @@ public:
   double getRequiredBandwidth() const { return bw_required; }
   double getCurrentBandwidth() const { return bw_current; }
   double getWeight() const { return weight; }
+  /** Change the controller minimum guaranteed bandwidth	*/
+  void setMinBandwidth(double bw);
+  int getTaskPos() const { return task_pos; }
 
+  /** Required bandwidth estimate for the GlobalOptimizer: the average
+   ** since the last clear, or the moving one selected with -gc-bw-avg */
   double getRequiredBandwidthAvg();
+  /** Restart the average since the last clear (moving estimates go on) */
   void clearRequiredBandwidthAvg();
   /** Forget historical workload data */
   void clearHistory();
 
-  double getMeanBandwidth() const { return bw_time_stat.getMean(); }
-  double getMeanRequiredBandwidth() const { return rbw_time_stat.getMean(); }
-  double getMeanDeltaBandwidth() const { return dbw_time_stat.getMean(); }
+  double getMeanBandwidth() const { return bw_time_stat->getMean(); }
+  double getMeanRequiredBandwidth() const { return rbw_time_stat->getMean(); }
+  double getMeanDeltaBandwidth() const { return dbw_time_stat->getMean(); }
   double getMeanSchedError() const { return se_stat->getMean(); }
-  Stat & getTempPDNVStat() { return pinv_stat_temp; }
+  double getPinv() const { return pinv_stat->getMean(); }
+  MeanStat & getTempPDNVStat() { return pinv_stat_temp; }
 
   /** This also manages job end and bw change events	*/
   void changeCurrentBandwidth(double b);
@@ -217,6 +258,8 @@ public:
   void dump();
   /** Dump statistics to proper files		*/
   void dumpStatistics();
+  /** Append the (name, statistic) pairs of this task to stats	*/
+  void getStats(vector< pair<const char *, const BaseStat *> > & stats) const;
 
   static void dumpStat(const BaseStat & time_stat,
 		       const char *fname, const char *var_name,
@@ -254,6 +297,10 @@ public:
   Time getStartTime() const;
 
   virtual bool checkParams();
+
+  /** Recompute the controller parameters, after its options changed
+   ** during the simulation, and refresh the copies kept elsewhere */
+  void calcParams();
 };
 
 #endif
@@ -0,0 +1,51 @@
+/*
+ * ARSim
+ * Copyright (c) 2000-2010 Tommaso Cucinotta
+ *
+ * This file is part of ARSim.
+ *
+ * ARSim is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * ARSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with ARSim. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include "TaskTable.hpp"
+
+unsigned int TaskTable::addTask() {
+  running.push_back(0.0);
+  bw_req.push_back(0.0);
+  bw_min.push_back(0.0);
+  weight.push_back(1.0);
+  bw_cur.push_back(0.0);
+  return running.size() - 1;
+}
+
+/* Accumulation is kept in task order, so that results do not depend on
+ * whether the compiler is allowed to reassociate the sum.
+ */
+double TaskTable::sumRunningRequired() const {
+  const double *run = getRunning(), *req = getRequiredBandwidth();
+  unsigned int n = size();
+  double sum = 0.0;
+  for (unsigned int i = 0; i < n; ++i)
+    sum += run[i] * req[i];
+  return sum;
+}
+
+double TaskTable::sumMin() const {
+  const double *min = getMinBandwidth();
+  unsigned int n = size();
+  double sum = 0.0;
+  for (unsigned int i = 0; i < n; ++i)
+    sum += min[i];
+  return sum;
+}
@@ -0,0 +1,73 @@
+/*
+ * ARSim
+ * Copyright (c) 2000-2010 Tommaso Cucinotta
+ *
+ * This file is part of ARSim.
+ *
+ * ARSim is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * ARSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with ARSim. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef __ARSIM_TASK_TABLE_HPP__
+#  define __ARSIM_TASK_TABLE_HPP__
+
+#include <vector>
+
+using namespace std;
+
+/** Per-resource struct-of-arrays copy of the task parameters read by the
+ ** supervisor on each global constraint check. Position i holds the data
+ ** of the i-th TaskScheduler of the resource, which keeps it up to date,
+ ** so that supervisors may scan contiguous arrays instead of chasing the
+ ** TaskScheduler and Controller objects.
+ **
+ ** The running flag is stored as a 0.0/1.0 double, so that reductions
+ ** over running tasks need no branches and no type conversions.
+ **/
+class TaskTable {
+  vector<double> running;	/**< 1.0 if a job is in progress	*/
+  vector<double> bw_req;	/**< Required bandwidth			*/
+  vector<double> bw_min;	/**< Minimum guaranteed bandwidth	*/
+  vector<double> weight;	/**< Weight for fair distribution	*/
+  vector<double> bw_cur;	/**< Current (granted) bandwidth	*/
+
+ public:
+
+  /** Append a new slot, returning its position	*/
+  unsigned int addTask();
+
+  unsigned int size() const { return running.size(); }
+
+  void setRunning(unsigned int i, bool r) { running[i] = r ? 1.0 : 0.0; }
+  void setRequiredBandwidth(unsigned int i, double b) { bw_req[i] = b; }
+  void setMinBandwidth(unsigned int i, double b) { bw_min[i] = b; }
+  void setWeight(unsigned int i, double w) { weight[i] = w; }
+  void setCurrentBandwidth(unsigned int i, double b) { bw_cur[i] = b; }
+
+  bool isRunning(unsigned int i) const { return running[i] != 0.0; }
+
+  /** Raw arrays, for supervisor loops (valid until the next addTask())	*/
+  const double *getRunning() const { return running.empty() ? 0 : &running[0]; }
+  const double *getRequiredBandwidth() const { return bw_req.empty() ? 0 : &bw_req[0]; }
+  const double *getMinBandwidth() const { return bw_min.empty() ? 0 : &bw_min[0]; }
+  const double *getWeight() const { return weight.empty() ? 0 : &weight[0]; }
+  const double *getCurrentBandwidth() const { return bw_cur.empty() ? 0 : &bw_cur[0]; }
+
+  /** Sum of the required bandwidths of the running tasks	*/
+  double sumRunningRequired() const;
+
+  /** Sum of the configured minimum guaranteed bandwidths	*/
+  double sumMin() const;
+};
+
+#endif
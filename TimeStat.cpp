@@ -29,10 +29,7 @@ TimeStat::TimeStat(double x_min, double x_max, long x_pmf_size, double now) {
   this->x_max = x_max;
   this->dx = (x_max - x_min) / x_pmf_size;
   this->x_pmf_size = x_pmf_size;
-  x_pmf = new double[x_pmf_size];
-  ASSERT(x_pmf != 0, "No memory");
-  for (long n = 0; n < x_pmf_size; n++)
-    x_pmf[n] = 0.0;
+  x_pmf = 0;		// See allocPMF()
   num_samples = 0;
   x_sum = 0;
   x_sqr_sum = 0;
@@ -52,10 +49,7 @@ TimeStat::TimeStat(double x_min, double x_max, double dx, double now)
   this->x_max = x_max;
   this->dx = dx;
   this->x_pmf_size = long(ceil((x_max - x_min) / dx));
-  x_pmf = new double[x_pmf_size];
-  ASSERT(x_pmf != 0, "No memory");
-  for (long n = 0; n < x_pmf_size; n++)
-    x_pmf[n] = 0.0;
+  x_pmf = 0;		// See allocPMF()
   num_samples = 0;
   x_sum = 0;
   x_sqr_sum = 0;
@@ -69,6 +63,13 @@ TimeStat::TimeStat(double x_min, double x_max, double dx, double now)
   prev_x = 0.0;
 }
 
+void TimeStat::allocPMF() {
+  x_pmf = new double[x_pmf_size];
+  ASSERT(x_pmf != 0, "No memory");
+  for (long n = 0; n < x_pmf_size; n++)
+    x_pmf[n] = 0.0;
+}
+
 TimeStat::~TimeStat() {
   delete[] x_pmf;
 }
@@ -76,7 +77,7 @@ TimeStat::~TimeStat() {
 double TimeStat::calcPMFMean() const {
   double sum = 0.0;
   for (long n = 0; n < x_pmf_size; n++)
-    sum += x_pmf[n] / (prev_t - orig_t) * (x_min + dx * double(n));
+    sum += getBin(n) / (prev_t - orig_t) * (x_min + dx * double(n));
   return sum;
 }
 
@@ -115,12 +116,12 @@ double TimeStat::getMeanAbs() const {
 double TimeStat::getPDFValue(double x) const {
   long n_sample = long((x - x_min) / dx);
   ASSERT1((n_sample >= 0) && (n_sample < x_pmf_size), "TimeStat::getDistrAt(): x out of range: %g", x);
-  return x_pmf[n_sample] / (dx * (prev_t - orig_t));
+  return getBin(n_sample) / (dx * (prev_t - orig_t));
 }
 
 double TimeStat::getPMFValue(long n_sample) const {
   ASSERT1((n_sample >= 0) && (n_sample < x_pmf_size), "getPMFValue(): n_sample out of range: %ld", n_sample);
-  return x_pmf[n_sample] / (prev_t - orig_t);
+  return getBin(n_sample) / (prev_t - orig_t);
 }
 
 double TimeStat::getXValue(long n_sample) const {
@@ -131,15 +132,16 @@ double TimeStat::getXValue(long n_sample) const {
 double TimeStat::sumPMFValues() const {
   double sum = 0.0;
   for (long n = 0; n < x_pmf_size; n++)
-    sum += x_pmf[n];
+    sum += getBin(n);
   return sum / (prev_t - orig_t);
 }
 
 void TimeStat::clear(double now) {
   parent::clear();
   num_samples = 0;
-  for (long n = 0; n < x_pmf_size; n++)
-    x_pmf[n] = 0;
+  if (x_pmf != 0)
+    for (long n = 0; n < x_pmf_size; n++)
+      x_pmf[n] = 0;
   x_sum = 0;
   x_sqr_sum = 0;
   x_abs_sum = 0;
@@ -151,3 +153,27 @@ void TimeStat::clear(double now) {
   orig_t = now;
   prev_x = 0;
 }
+
+void TimeStat::merge(const BaseStat & s) {
+  const TimeStat *p_s = dynamic_cast<const TimeStat *>(&s);
+  CHECK(p_s != 0, "Merging statistics of different types");
+  CHECK(p_s->x_min == x_min && p_s->dx == dx && p_s->x_pmf_size == x_pmf_size,
+        "Merging TimeStat objects with different intervals");
+  mergeMinMax(s);
+  if (p_s->x_pmf != 0) {
+    if (x_pmf == 0)
+      allocPMF();
+    for (long n = 0; n < x_pmf_size; n++)
+      x_pmf[n] += p_s->x_pmf[n];
+  }
+  num_samples += p_s->num_samples;
+  x_sum += p_s->x_sum;
+  x_sqr_sum += p_s->x_sqr_sum;
+  x_abs_sum += p_s->x_abs_sum;
+  x_sum_pos += p_s->x_sum_pos;
+  t_sum_pos += p_s->t_sum_pos;
+  x_sum_neg_zero += p_s->x_sum_neg_zero;
+  t_sum_neg_zero += p_s->t_sum_neg_zero;
+  /* The observed duration, prev_t - orig_t, normalizes all the sums	*/
+  orig_t -= p_s->prev_t - p_s->orig_t;
+}
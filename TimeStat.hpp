@@ -26,7 +26,7 @@
 class TimeStat : public BaseStat {
   double x_min, x_max;
   double dx;
-  double *x_pmf;	// Temporally weighted occurrences in each dx-sized interval
+  double *x_pmf;	// Temporally weighted occurrences in each dx-sized interval, 0 until first needed
   long x_pmf_size;	// Number of pmf samples: (max-min)/dx
   long num_samples;	// Number of x samples
   double x_sum;		// Temporally weighted sum of samples
@@ -40,6 +40,11 @@ class TimeStat : public BaseStat {
   double prev_t;	// Time of insertion of last sample
   double orig_t;        // Time of start of statistics accumulation
 
+  /** Allocate the intervals at the first time a value is held for a
+   ** non-zero time						*/
+  void allocPMF();
+  double getBin(long n) const { return x_pmf != 0 ? x_pmf[n] : 0.0; }
+
  public:
 
   typedef BaseStat parent;
@@ -55,6 +60,11 @@ class TimeStat : public BaseStat {
   void addSample(double x, double t);
   /** Get number of samples   */
   virtual long getNumSamples() const { return num_samples; }
+  virtual double getWeight() const { return prev_t - orig_t; }
+  virtual double getWeightPos() const { return t_sum_pos; }
+  /** Add the samples of s, a TimeStat with the same intervals,
+   ** extending the observed duration by the one of s		*/
+  virtual void merge(const BaseStat & s);
   /** Calculate mean from calculated PMF			*/
   double calcPMFMean() const;
   /** Return mean of provided samples				*/
@@ -77,6 +87,11 @@ class TimeStat : public BaseStat {
   double sumPMFValues() const;
   /** Return the PMF size					*/
   long getPMFSize() const { return x_pmf_size; }
+  /** Return the raw PMF array: time spent in each interval (divide by getDuration()),
+   ** or 0 if no time elapsed since the first sample yet	*/
+  const double *getPMFData() const { return x_pmf; }
+  /** Return the time over which samples have been accumulated	*/
+  double getDuration() const { return prev_t - orig_t; }
   /** Return x value getPMFValue(n_sample) refers to		*/
   double getXValue(long n_sample) const;
 
@@ -97,12 +112,16 @@ inline void TimeStat::addSample(double x, double t) {
   else if (n_sample >= x_pmf_size)
     n_sample = x_pmf_size - 1;
 
-  x_pmf[n_sample] += w;
+  if (w != 0.0) {
+    if (x_pmf == 0)
+      allocPMF();
+    x_pmf[n_sample] += w;
+  }
   num_samples++;
   x_sum += prev_x * w;
   x_sqr_sum += prev_x * prev_x * w;
   x_abs_sum += fabs(prev_x) * w;
-  if (prev_x == 0.0) {
+  if (prev_x > 0.0) {
     x_sum_pos += prev_x * w;
     t_sum_pos += w;
   } else {
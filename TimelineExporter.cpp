@@ -0,0 +1,249 @@
+/*
+ * ARSim
+ * Copyright (c) 2000-2010 Tommaso Cucinotta
+ *
+ * This file is part of ARSim.
+ *
+ * ARSim is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * ARSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with ARSim. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <cstring>
+
+#include "TimelineExporter.hpp"
+#include "TaskScheduler.hpp"
+#include "ResourceManager.hpp"
+#include "util.hpp"
+
+/** Process ID used for the global optimizer track; resource r maps to pid r+1 */
+#define TL_GC_PID 0
+/** Thread ID used for the supervisor track; task t maps to tid t+1 */
+#define TL_SPV_TID 0
+
+TimelineExporter *TimelineExporter::p_tl = new TimelineExporter();
+
+TimelineExporter::TimelineExporter() {
+  tl_file = NULL;
+  enabled = false;
+  first_record = true;
+  t_from = 0.0;
+  t_to = -1.0;
+}
+
+void TimelineExporter::usage() {
+  printf("  TIMELINE EXPORT OPTIONS\n");
+  printf("           -tl      file: export a Chrome trace-event JSON timeline to file\n");
+  printf("           -tl-tsk  t[,r]: only export the specified task (may be repeated)\n");
+  printf("           -tl-rs   r: only export the specified resource (may be repeated)\n");
+  printf("           -tl-from t: only export events from the specified time on\n");
+  printf("           -tl-to   t: only export events up to the specified time\n");
+}
+
+bool TimelineExporter::parseArg(int& argc, char **& argv) {
+  if (strcmp(*argv, "-tl") == 0) {
+    CHECK(argc > 1, "Option requires an argument");
+    argv++;  argc--;
+    open(*argv);
+  } else if (strcmp(*argv, "-tl-tsk") == 0) {
+    CHECK(argc > 1, "Option requires an argument");
+    argv++;  argc--;
+    int tsk, rs = 0;
+    CHECK(sscanf(*argv, "%d,%d", &tsk, &rs) == 2 || sscanf(*argv, "%d", &tsk) == 1,
+          "Wrong format for -tl-tsk option");
+    flt_tasks.push_back(make_pair(tsk, rs));
+  } else if (strcmp(*argv, "-tl-rs") == 0) {
+    CHECK(argc > 1, "Option requires an argument");
+    argv++;  argc--;
+    int rs;
+    CHECK(sscanf(*argv, "%d", &rs) == 1, "Expecting integer as argument to -tl-rs option");
+    flt_rs.push_back(rs);
+  } else if (strcmp(*argv, "-tl-from") == 0) {
+    CHECK(argc > 1, "Option requires an argument");
+    argv++;  argc--;
+    CHECK(sscanf(*argv, "%lg", &t_from) == 1, "Expecting double as argument to -tl-from option");
+  } else if (strcmp(*argv, "-tl-to") == 0) {
+    CHECK(argc > 1, "Option requires an argument");
+    argv++;  argc--;
+    CHECK(sscanf(*argv, "%lg", &t_to) == 1, "Expecting double as argument to -tl-to option");
+  } else {
+    return false;
+  }
+  return true;
+}
+
+void TimelineExporter::open(const char *fname) {
+  CHECK(tl_file == NULL, "Timeline export file already specified");
+  tl_file = fopen(fname, "w");
+  CHECK(tl_file != NULL, "Could not open timeline export file");
+  fprintf(tl_file, "[\n");
+  enabled = true;
+  first_record = true;
+  nameTrack(-1, TL_SPV_TID);
+}
+
+void TimelineExporter::close() {
+  if (tl_file == NULL)
+    return;
+  fprintf(tl_file, "\n]\n");
+  fclose(tl_file);
+  tl_file = NULL;
+  enabled = false;
+}
+
+bool TimelineExporter::passTime() const {
+  Time t = EventList::getTime();
+  return t >= t_from && (t_to < 0 || t <= t_to);
+}
+
+bool TimelineExporter::passResource(int rs) const {
+  if (flt_rs.size() == 0)
+    return true;
+  for (vector<int>::const_iterator it = flt_rs.begin(); it != flt_rs.end(); ++it)
+    if (*it == rs)
+      return true;
+  return false;
+}
+
+bool TimelineExporter::passTask(int tsk, int rs) const {
+  if (! passResource(rs))
+    return false;
+  if (flt_tasks.size() == 0)
+    return true;
+  for (vector< pair<int, int> >::const_iterator it = flt_tasks.begin(); it != flt_tasks.end(); ++it)
+    if (it->first == tsk && it->second == rs)
+      return true;
+  return false;
+}
+
+void TimelineExporter::beginRecord() {
+  if (first_record)
+    first_record = false;
+  else
+    fprintf(tl_file, ",\n");
+}
+
+/** Write process/thread naming metadata the first time a track is used.
+ ** A resource index of -1 denotes the global optimizer process.
+ **/
+void TimelineExporter::nameTrack(int rs, int tid) {
+  if (named_tracks.find(make_pair(rs, tid)) != named_tracks.end())
+    return;
+  named_tracks.insert(make_pair(rs, tid));
+  if (rs < 0) {
+    beginRecord();
+    fprintf(tl_file, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"args\":{\"name\":\"GlobalOptimizer\"}}",
+            TL_GC_PID);
+    return;
+  }
+  if (named_tracks.find(make_pair(rs, -1)) == named_tracks.end()) {
+    named_tracks.insert(make_pair(rs, -1));
+    const char *rs_name = "";
+    if (rs < (int) ResourceManager::rs_controllers.size())
+      rs_name = ResourceManager::rs_controllers[rs]->getResourceName().c_str();
+    beginRecord();
+    fprintf(tl_file, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"args\":{\"name\":\"%s\"}}",
+            rs + 1, rs_name);
+  }
+  beginRecord();
+  if (tid == TL_SPV_TID)
+    fprintf(tl_file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":\"Supervisor\"}}",
+            rs + 1, tid);
+  else
+    fprintf(tl_file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":\"Task %d,%d\"}}",
+            rs + 1, tid, tid - 1, rs);
+}
+
+void TimelineExporter::writeTask(TaskScheduler *p_tsched, const char *ph, const char *name, long job_id) {
+  int rs = p_tsched->getResourceManager()->getResourceId();
+  int tsk = p_tsched->getTaskPos();
+  if (! passTime() || ! passTask(tsk, rs))
+    return;
+  nameTrack(rs, tsk + 1);
+  beginRecord();
+  fprintf(tl_file, "{\"name\":\"%s\",\"ph\":\"%s\",\"ts\":%.3f,\"pid\":%d,\"tid\":%d%s,\"args\":{\"job\":%ld}}",
+          name, ph, EventList::getTime() * 1000.0, rs + 1, tsk + 1,
+          ph[0] == 'i' ? ",\"s\":\"t\"" : "", job_id);
+}
+
+void TimelineExporter::writeCounter(TaskScheduler *p_tsched, const char *name,
+                                    double v1, const char *v1_name, double v2, const char *v2_name) {
+  int rs = p_tsched->getResourceManager()->getResourceId();
+  int tsk = p_tsched->getTaskPos();
+  if (! passTime() || ! passTask(tsk, rs))
+    return;
+  nameTrack(rs, tsk + 1);
+  beginRecord();
+  fprintf(tl_file, "{\"name\":\"%s %d,%d\",\"ph\":\"C\",\"ts\":%.3f,\"pid\":%d,\"args\":{\"%s\":%g",
+          name, tsk, rs, EventList::getTime() * 1000.0, rs + 1, v1_name, v1);
+  if (v2_name != NULL)
+    fprintf(tl_file, ",\"%s\":%g", v2_name, v2);
+  fprintf(tl_file, "}}");
+}
+
+void TimelineExporter::jobArrive(TaskScheduler *p_tsched, long job_id) {
+  writeTask(p_tsched, "i", "arrive", job_id);
+}
+
+void TimelineExporter::jobStart(TaskScheduler *p_tsched, long job_id) {
+  writeTask(p_tsched, "B", "job", job_id);
+}
+
+void TimelineExporter::jobEnd(TaskScheduler *p_tsched, long job_id, double sched_err) {
+  writeTask(p_tsched, "E", "job", job_id);
+  writeCounter(p_tsched, "sched_err", sched_err, "sched_err", 0.0, NULL);
+}
+
+void TimelineExporter::bandwidth(TaskScheduler *p_tsched, double bw_current, double bw_required) {
+  writeCounter(p_tsched, "bw", bw_current, "bw_current", bw_required, "bw_required");
+}
+
+void TimelineExporter::compression(int rs, double bw_req_sum, double speed) {
+  if (! passTime() || ! passResource(rs))
+    return;
+  nameTrack(rs, TL_SPV_TID);
+  beginRecord();
+  fprintf(tl_file, "{\"name\":\"compress\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%.3f,\"pid\":%d,\"tid\":%d,"
+          "\"args\":{\"bw_req_sum\":%g,\"speed\":%g}}",
+          EventList::getTime() * 1000.0, rs + 1, TL_SPV_TID, bw_req_sum, speed);
+}
+
+void TimelineExporter::optimization(bool solved, double obj_val) {
+  if (! passTime())
+    return;
+  beginRecord();
+  fprintf(tl_file, "{\"name\":\"optimize\",\"ph\":\"i\",\"s\":\"p\",\"ts\":%.3f,\"pid\":%d,\"tid\":0,"
+          "\"args\":{\"solved\":%s,\"obj_val\":%g}}",
+          EventList::getTime() * 1000.0, TL_GC_PID, solved ? "true" : "false", obj_val);
+}
+
+void TimelineExporter::resourceMode(int rs, int res_mode) {
+  if (! passTime() || ! passResource(rs))
+    return;
+  nameTrack(rs, TL_SPV_TID);
+  beginRecord();
+  fprintf(tl_file, "{\"name\":\"res_mode %d\",\"ph\":\"C\",\"ts\":%.3f,\"pid\":%d,\"args\":{\"res_mode\":%d}}",
+          rs, EventList::getTime() * 1000.0, rs + 1, res_mode);
+}
+
+void TimelineExporter::appMode(int tsk, int rs, int app_mode) {
+  if (! passTime() || ! passTask(tsk, rs))
+    return;
+  nameTrack(rs, tsk + 1);
+  beginRecord();
+  fprintf(tl_file, "{\"name\":\"app_mode %d,%d\",\"ph\":\"C\",\"ts\":%.3f,\"pid\":%d,\"args\":{\"app_mode\":%d}}",
+          tsk, rs, EventList::getTime() * 1000.0, rs + 1, app_mode);
+}
+
+TimelineExporter::~TimelineExporter() {
+  close();
+}
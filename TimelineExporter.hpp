@@ -0,0 +1,101 @@
+/*
+ * ARSim
+ * Copyright (c) 2000-2010 Tommaso Cucinotta
+ *
+ * This file is part of ARSim.
+ *
+ * ARSim is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * ARSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with ARSim. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef __ARSIM_TIMELINE_EXPORTER_HPP__
+#  define __ARSIM_TIMELINE_EXPORTER_HPP__
+
+#include "Component.hpp"
+#include "Events.hpp"
+
+#include <stdio.h>
+#include <set>
+#include <vector>
+#include <utility>
+
+class TaskScheduler;
+
+/** Streaming export of the simulated schedule as a Chrome trace-event
+ ** JSON timeline, which can be loaded into chrome://tracing or Perfetto.
+ **
+ ** Each resource is shown as a process, and each task as a thread within
+ ** it. Job executions are duration slices on the task track, job arrivals,
+ ** supervisor compressions and optimizer decisions are instant events,
+ ** and bw_current, bw_required and sched_err are counter tracks.
+ **
+ ** Records are written while the corresponding events are dispatched,
+ ** using the JSON array format, where the closing bracket is optional, so
+ ** that a file cut short by an interrupted run can still be loaded.
+ ** Simulated time is assumed to be in ms, and converted to the us
+ ** time-base of trace events.
+ **/
+class TimelineExporter : public Component {
+  static TimelineExporter *p_tl;
+  friend class SimContext;
+
+  FILE *tl_file;
+  bool enabled;
+  bool first_record;
+
+  /** Filters: if empty, then all tasks/resources are exported */
+  vector< pair<int, int> > flt_tasks;
+  vector<int> flt_rs;
+  Time t_from, t_to;
+
+  /** Tracks for which the naming metadata has already been written */
+  set< pair<int, int> > named_tracks;
+
+  bool passTime() const;
+  bool passTask(int tsk, int rs) const;
+  bool passResource(int rs) const;
+  void beginRecord();
+  void nameTrack(int rs, int tsk);
+  void writeTask(TaskScheduler *p_tsched, const char *ph, const char *name, long job_id);
+  void writeCounter(TaskScheduler *p_tsched, const char *name, double v1, const char *v1_name,
+                    double v2, const char *v2_name);
+
+public:
+
+  TimelineExporter();
+
+  static inline TimelineExporter *getInstance() { return p_tl; }
+
+  static void usage();
+  virtual bool parseArg(int& argc, char **& argv);
+
+  /** Open the output file, writing the opening of the JSON array */
+  void open(const char *fname);
+  /** Close the JSON array and the output file */
+  void close();
+
+  bool isEnabled() const { return enabled; }
+
+  void jobArrive(TaskScheduler *p_tsched, long job_id);
+  void jobStart(TaskScheduler *p_tsched, long job_id);
+  void jobEnd(TaskScheduler *p_tsched, long job_id, double sched_err);
+  void bandwidth(TaskScheduler *p_tsched, double bw_current, double bw_required);
+  void compression(int rs, double bw_req_sum, double speed);
+  void optimization(bool solved, double obj_val);
+  void resourceMode(int rs, int res_mode);
+  void appMode(int tsk, int rs, int app_mode);
+
+  virtual ~TimelineExporter();
+};
+
+#endif
@@ -0,0 +1,175 @@
+/*
+ * ARSim
+ * Copyright (c) 2000-2010 Tommaso Cucinotta
+ *
+ * This file is part of ARSim.
+ *
+ * ARSim is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * ARSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with ARSim. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include "TraceCache.hpp"
+#include "util.hpp"
+
+#include <string.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define TC_MAGIC "ARSIMTRC"
+/** To be increased at each change of the sidecar layout	*/
+#define TC_VERSION 1
+
+struct TraceCacheHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t path_len;		/**< Trace path, following the header	*/
+  int64_t mtime_sec, mtime_nsec;
+  int64_t file_size;
+  int32_t col_number, disc_lines;
+  double mul_factor, sat_p_min, sat_p_max;
+  TraceCacheSummary summary;
+  uint64_t num_samples;
+  uint64_t samples_offset;	/**< Offset of the (aligned) samples	*/
+};
+
+static uint64_t fnv1a(uint64_t h, const void *p, size_t len) {
+  const unsigned char *c = (const unsigned char *) p;
+  for (size_t i = 0; i < len; ++i) {
+    h ^= c[i];
+    h *= 0x100000001b3ULL;
+  }
+  return h;
+}
+
+std::string TraceCache::getFileName(const TraceCacheKey & key) {
+  uint64_t h = 0xcbf29ce484222325ULL;
+  h = fnv1a(h, &key.col_number, sizeof(key.col_number));
+  h = fnv1a(h, &key.disc_lines, sizeof(key.disc_lines));
+  h = fnv1a(h, &key.mul_factor, sizeof(key.mul_factor));
+  h = fnv1a(h, &key.sat_p_min, sizeof(key.sat_p_min));
+  h = fnv1a(h, &key.sat_p_max, sizeof(key.sat_p_max));
+  char buf[32];
+  snprintf(buf, sizeof(buf), ".%016llx.tcache", (unsigned long long) h);
+  return key.fname + buf;
+}
+
+TraceCache *TraceCache::open(const TraceCacheKey & key) {
+  struct stat st;
+  if (stat(key.fname.c_str(), &st) != 0)
+    return 0;
+  std::string cache_fname = getFileName(key);
+  int fd = ::open(cache_fname.c_str(), O_RDONLY);
+  if (fd < 0)
+    return 0;
+  struct stat cst;
+  if (fstat(fd, &cst) != 0 || (size_t) cst.st_size < sizeof(TraceCacheHeader)) {
+    close(fd);
+    return 0;
+  }
+  void *p = mmap(0, cst.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (p == MAP_FAILED)
+    return 0;
+  TraceCache *p_tc = new TraceCache();
+  p_tc->p_map = p;
+  p_tc->map_size = cst.st_size;
+  const TraceCacheHeader *p_hdr = (const TraceCacheHeader *) p;
+  bool valid = memcmp(p_hdr->magic, TC_MAGIC, sizeof(p_hdr->magic)) == 0
+    && p_hdr->version == TC_VERSION
+    && p_hdr->path_len == key.fname.size()
+    && sizeof(TraceCacheHeader) + p_hdr->path_len <= p_tc->map_size
+    && memcmp((const char *) p + sizeof(TraceCacheHeader), key.fname.c_str(), p_hdr->path_len) == 0
+    && p_hdr->mtime_sec == (int64_t) st.st_mtim.tv_sec
+    && p_hdr->mtime_nsec == (int64_t) st.st_mtim.tv_nsec
+    && p_hdr->file_size == (int64_t) st.st_size
+    && p_hdr->col_number == key.col_number
+    && p_hdr->disc_lines == key.disc_lines
+    && p_hdr->mul_factor == key.mul_factor
+    && p_hdr->sat_p_min == key.sat_p_min
+    && p_hdr->sat_p_max == key.sat_p_max
+    && p_hdr->samples_offset % sizeof(double) == 0
+    && p_hdr->samples_offset + p_hdr->num_samples * sizeof(double) == p_tc->map_size;
+  if (! valid) {
+    Logger::debugLog("Ignoring stale or incompatible trace cache %s\n", cache_fname.c_str());
+    delete p_tc;
+    return 0;
+  }
+  p_tc->p_hdr = p_hdr;
+  return p_tc;
+}
+
+bool TraceCache::write(const TraceCacheKey & key, const TraceCacheSummary & sum,
+		       const double *p_samples, size_t num_samples) {
+  struct stat st;
+  if (stat(key.fname.c_str(), &st) != 0)
+    return false;
+  TraceCacheHeader hdr;
+  memset(&hdr, 0, sizeof(hdr));
+  memcpy(hdr.magic, TC_MAGIC, sizeof(hdr.magic));
+  hdr.version = TC_VERSION;
+  hdr.path_len = key.fname.size();
+  hdr.mtime_sec = st.st_mtim.tv_sec;
+  hdr.mtime_nsec = st.st_mtim.tv_nsec;
+  hdr.file_size = st.st_size;
+  hdr.col_number = key.col_number;
+  hdr.disc_lines = key.disc_lines;
+  hdr.mul_factor = key.mul_factor;
+  hdr.sat_p_min = key.sat_p_min;
+  hdr.sat_p_max = key.sat_p_max;
+  hdr.summary = sum;
+  hdr.num_samples = num_samples;
+  size_t off = sizeof(hdr) + hdr.path_len;
+  hdr.samples_offset = (off + sizeof(double) - 1) / sizeof(double) * sizeof(double);
+
+  /* Write to a temporary file renamed at the end, so that concurrent
+   * runs never see a partial sidecar
+   */
+  std::string cache_fname = getFileName(key);
+  char pid_suffix[16];
+  snprintf(pid_suffix, sizeof(pid_suffix), ".%d", (int) getpid());
+  std::string tmp_fname = cache_fname + pid_suffix;
+  FILE *f = fopen(tmp_fname.c_str(), "wb");
+  if (f == NULL)
+    return false;
+  static const char pad[sizeof(double)] = { 0 };
+  bool ok = fwrite(&hdr, sizeof(hdr), 1, f) == 1
+    && fwrite(key.fname.c_str(), 1, hdr.path_len, f) == hdr.path_len
+    && fwrite(pad, 1, hdr.samples_offset - off, f) == hdr.samples_offset - off
+    && fwrite(p_samples, sizeof(double), num_samples, f) == num_samples;
+  ok = (fclose(f) == 0) && ok;
+  if (ok)
+    ok = rename(tmp_fname.c_str(), cache_fname.c_str()) == 0;
+  if (! ok)
+    unlink(tmp_fname.c_str());
+  return ok;
+}
+
+const double *TraceCache::getSamples() const {
+  return (const double *) ((const char *) p_map + p_hdr->samples_offset);
+}
+
+size_t TraceCache::getNumSamples() const {
+  return p_hdr->num_samples;
+}
+
+const TraceCacheSummary & TraceCache::getSummary() const {
+  return p_hdr->summary;
+}
+
+TraceCache::~TraceCache() {
+  if (p_map != 0)
+    munmap(p_map, map_size);
+}
@@ -0,0 +1,81 @@
+/*
+ * ARSim
+ * Copyright (c) 2000-2010 Tommaso Cucinotta
+ *
+ * This file is part of ARSim.
+ *
+ * ARSim is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * ARSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with ARSim. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef __ARSIM_TRACE_CACHE_HPP__
+#  define __ARSIM_TRACE_CACHE_HPP__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+/** Summary of a loaded trace column, as printed by TraceTask	*/
+struct TraceCacheSummary {
+  double min, max, avg;
+  /** Percentiles 00, 05, 10, 15, 85, 90, 95, 99.95, 100	*/
+  double perc[9];
+  /** Same for the moving average on 3 samples			*/
+  double mm_min, mm_max, mm_avg;
+  double mm_perc[9];
+};
+
+/** What a cached trace column depends on			*/
+struct TraceCacheKey {
+  std::string fname;
+  int col_number;
+  int disc_lines;
+  double mul_factor;
+  double sat_p_min, sat_p_max;
+};
+
+/** Binary sidecar cache of a loaded trace column.
+ **
+ ** The first time a trace column is loaded, the scaled (and saturated)
+ ** samples and their summary are written next to the trace file, into
+ ** <trace>.<hash>.tcache, where the hash covers the loading parameters.
+ ** Later loads with the same parameters mmap the sidecar, provided that
+ ** the trace path, size and modification time still match the ones
+ ** recorded in it. The sidecar is in native byte order, and it is
+ ** ignored when its format version does not match.
+ **/
+class TraceCache {
+  void *p_map;
+  size_t map_size;
+  const struct TraceCacheHeader *p_hdr;
+
+  TraceCache() : p_map(0), map_size(0), p_hdr(0) { }
+
+public:
+
+  /** Open a valid sidecar for the key, or return 0 if there is none */
+  static TraceCache *open(const TraceCacheKey & key);
+  /** Write the sidecar for the key, returning false on failure	*/
+  static bool write(const TraceCacheKey & key, const TraceCacheSummary & sum,
+		    const double *p_samples, size_t num_samples);
+  /** Sidecar file name for the key				*/
+  static std::string getFileName(const TraceCacheKey & key);
+
+  const double *getSamples() const;
+  size_t getNumSamples() const;
+  const TraceCacheSummary & getSummary() const;
+
+  ~TraceCache();
+};
+
+#endif
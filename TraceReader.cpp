@@ -0,0 +1,242 @@
+/*
+ * ARSim
+ * Copyright (c) 2000-2010 Tommaso Cucinotta
+ *
+ * This file is part of ARSim.
+ *
+ * ARSim is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * ARSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with ARSim. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include "TraceReader.hpp"
+#include "util.hpp"
+
+#include <string.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <charconv>
+#include <string>
+#include <thread>
+
+/** Files smaller than this are parsed by a single thread	*/
+#define TR_MIN_PARALLEL_SIZE (16 << 20)
+
+static int tr_num_threads = 0;
+
+TraceReader::TraceReader(const char *fname) {
+  p_data = 0;
+  size = 0;
+  int fd = open(fname, O_RDONLY);
+  ASSERT1(fd >= 0, "Couldn't open trace file %s", fname);
+  struct stat st;
+  ASSERT1(fstat(fd, &st) == 0, "Couldn't stat trace file %s", fname);
+  size = st.st_size;
+  if (size > 0) {
+    void *p = mmap(0, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ASSERT1(p != MAP_FAILED, "Couldn't mmap trace file %s", fname);
+    madvise(p, size, MADV_SEQUENTIAL);
+    p_data = (const char *) p;
+  }
+  close(fd);
+  rewind();
+}
+
+TraceReader::~TraceReader() {
+  if (p_data != 0)
+    munmap((void *) p_data, size);
+}
+
+void TraceReader::setNumThreads(int num) {
+  tr_num_threads = num;
+}
+
+/** Return the end of the line starting at beg, i.e., the position of its
+ ** terminator, or end if the last line is not terminated.
+ **/
+static inline const char *lineEnd(const char *beg, const char *end) {
+  const char *p = (const char *) memchr(beg, '\n', end - beg);
+  return p == 0 ? end : p;
+}
+
+/** Strip trailing carriage returns of DOS line terminators	*/
+static inline const char *stripCR(const char *beg, const char *end) {
+  while (end > beg && end[-1] == '\r')
+    --end;
+  return end;
+}
+
+bool TraceReader::nextLine(const char **p_beg, const char **p_end) {
+  const char *end = p_data + size;
+  if (p_cursor >= end)
+    return false;
+  const char *eol = lineEnd(p_cursor, end);
+  *p_beg = p_cursor;
+  *p_end = stripCR(p_cursor, eol);
+  p_cursor = eol + 1;
+  ++line_num;
+  return true;
+}
+
+void TraceReader::skipLines(long num_lines) {
+  const char *beg, *end;
+  for (long i = 0; i < num_lines && nextLine(&beg, &end); ++i)
+    ;
+}
+
+void TraceReader::releaseConsumed() {
+  size_t page_size = sysconf(_SC_PAGESIZE);
+  size_t len = ((p_cursor - p_data) / page_size) * page_size;
+  if (len > 0 && len <= size)
+    madvise((void *) p_data, len, MADV_DONTNEED);
+}
+
+int TraceReader::splitColumns(const char *beg, const char *end,
+			      const char **cols_beg, const char **cols_end, int num_cols) {
+  int n = 0;
+  const char *p = beg;
+  while (n < num_cols) {
+    while (p < end && (*p == ' ' || *p == '\t'))
+      ++p;
+    if (p == end)
+      break;
+    cols_beg[n] = p;
+    while (p < end && *p != ' ' && *p != '\t')
+      ++p;
+    cols_end[n++] = p;
+  }
+  return n;
+}
+
+bool TraceReader::parseDouble(const char *beg, const char *end, double *p_val) {
+  /* from_chars does not accept the leading '+' accepted by strtod() */
+  if (beg < end && *beg == '+')
+    ++beg;
+  std::from_chars_result res = std::from_chars(beg, end, *p_val);
+  return res.ec == std::errc() && res.ptr == end;
+}
+
+/** Per-chunk parsing results, merged in order after the parallel parse */
+struct TraceChunk {
+  const char *beg, *end;
+  std::vector<double> samples;
+  long num_lines;
+  /** Chunk-relative line numbers and contents of skipped lines	*/
+  std::vector< std::pair<long, std::string> > skipped;
+};
+
+static void parseChunk(TraceChunk *p_chunk, int col_number, double mul_factor) {
+  const char **cols_beg = new const char *[col_number];
+  const char **cols_end = new const char *[col_number];
+  const char *p = p_chunk->beg;
+  p_chunk->num_lines = 0;
+  while (p < p_chunk->end) {
+    const char *eol = lineEnd(p, p_chunk->end);
+    const char *line_end = stripCR(p, eol);
+    ++p_chunk->num_lines;
+    if (p < line_end && *p == '#') {
+      p = eol + 1;
+      continue;
+    }
+    double sample;
+    if (TraceReader::splitColumns(p, line_end, cols_beg, cols_end, col_number) == col_number
+	&& TraceReader::parseDouble(cols_beg[col_number - 1], cols_end[col_number - 1], &sample))
+      p_chunk->samples.push_back(sample * mul_factor);
+    else
+      p_chunk->skipped.push_back(std::make_pair(p_chunk->num_lines, std::string(p, line_end)));
+    p = eol + 1;
+  }
+  delete[] cols_beg;
+  delete[] cols_end;
+}
+
+long TraceReader::readColumnNext(std::vector<double> & samples, int col_number, double mul_factor,
+				 size_t max_samples) {
+  ASSERT(col_number >= 1, "Trace column numbers start from 1");
+  const char **cols_beg = new const char *[col_number];
+  const char **cols_end = new const char *[col_number];
+  const char *beg, *end;
+  size_t num_samples = 0;
+  while (num_samples < max_samples && nextLine(&beg, &end)) {
+    if (beg < end && *beg == '#')
+      continue;
+    double sample;
+    if (splitColumns(beg, end, cols_beg, cols_end, col_number) == col_number
+	&& parseDouble(cols_beg[col_number - 1], cols_end[col_number - 1], &sample)) {
+      samples.push_back(sample * mul_factor);
+      ++num_samples;
+    } else {
+      fprintf(stderr, "Warning: skipping line %ld '%.*s': column %d not numeric\n",
+	      line_num, (int) (end - beg), beg, col_number);
+    }
+  }
+  delete[] cols_beg;
+  delete[] cols_end;
+  return num_samples;
+}
+
+long TraceReader::readColumn(std::vector<double> & samples, long disc_lines, int col_number, double mul_factor) {
+  ASSERT(col_number >= 1, "Trace column numbers start from 1");
+  const char *end = p_data + size;
+  const char *p = p_data;
+  long line_base = 0;
+  for (; line_base < disc_lines && p < end; ++line_base)
+    p = lineEnd(p, end) + 1;
+  if (p >= end)
+    return 0;
+
+  int num_chunks = 1;
+  if (size - (p - p_data) >= TR_MIN_PARALLEL_SIZE) {
+    num_chunks = tr_num_threads > 0 ? tr_num_threads : (int) std::thread::hardware_concurrency();
+    if (num_chunks < 1)
+      num_chunks = 1;
+  }
+  std::vector<TraceChunk> chunks(num_chunks);
+  size_t chunk_size = (end - p) / num_chunks;
+  for (int i = 0; i < num_chunks; ++i) {
+    chunks[i].beg = p;
+    if (i == num_chunks - 1)
+      p = end;
+    else if (p + chunk_size < end)
+      p = lineEnd(p + chunk_size, end) + 1;
+    if (p > end)
+      p = end;
+    chunks[i].end = p;
+  }
+
+  if (num_chunks == 1) {
+    parseChunk(&chunks[0], col_number, mul_factor);
+  } else {
+    std::vector<std::thread> threads;
+    for (int i = 0; i < num_chunks; ++i)
+      threads.push_back(std::thread(parseChunk, &chunks[i], col_number, mul_factor));
+    for (int i = 0; i < num_chunks; ++i)
+      threads[i].join();
+  }
+
+  size_t num_samples = 0;
+  for (int i = 0; i < num_chunks; ++i)
+    num_samples += chunks[i].samples.size();
+  samples.reserve(samples.size() + num_samples);
+  for (int i = 0; i < num_chunks; ++i) {
+    samples.insert(samples.end(), chunks[i].samples.begin(), chunks[i].samples.end());
+    for (unsigned int j = 0; j < chunks[i].skipped.size(); ++j)
+      fprintf(stderr, "Warning: skipping line %ld '%s': column %d not numeric\n",
+	      line_base + chunks[i].skipped[j].first, chunks[i].skipped[j].second.c_str(), col_number);
+    line_base += chunks[i].num_lines;
+  }
+  return num_samples;
+}
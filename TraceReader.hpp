@@ -0,0 +1,97 @@
+/*
+ * ARSim
+ * Copyright (c) 2000-2010 Tommaso Cucinotta
+ *
+ * This file is part of ARSim.
+ *
+ * ARSim is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * ARSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with ARSim. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef __ARSIM_TRACE_READER_HPP__
+#  define __ARSIM_TRACE_READER_HPP__
+
+#include <stddef.h>
+#include <vector>
+
+/** Memory-mapped reader of text trace files.
+ **
+ ** The whole file is mmap()ed read-only, lines and columns are located in
+ ** place without copying nor allocating, and numbers are parsed with
+ ** std::from_chars. Columns are separated by spaces or tabs, and lines
+ ** starting with '#' are comments. Large files are parsed in parallel by
+ ** splitting them into newline-aligned chunks.
+ **/
+class TraceReader {
+  const char *p_data;	/**< Mapped file contents	*/
+  size_t size;		/**< Size of the mapped file	*/
+  const char *p_cursor;	/**< Position of the next line for nextLine() */
+  long line_num;	/**< Number of lines returned by nextLine() */
+
+public:
+
+  /** Map the specified file, raising an assertion on failure	*/
+  TraceReader(const char *fname);
+  ~TraceReader();
+
+  /** Size of the mapped file in bytes				*/
+  size_t getSize() const { return size; }
+
+  /** Return the next line, comments included, as [*p_beg, *p_end)
+   ** without the line terminator. Returns false at end of file.
+   **/
+  bool nextLine(const char **p_beg, const char **p_end);
+  /** Number of lines returned so far by nextLine()		*/
+  long getLineNum() const { return line_num; }
+  /** Restart nextLine() from the beginning of the file		*/
+  void rewind() { p_cursor = p_data; line_num = 0; }
+  /** Skip the next num_lines lines				*/
+  void skipLines(long num_lines);
+  /** Give back to the kernel the mapped pages already walked by
+   ** nextLine(), bounding the memory used by sequential reads of
+   ** large files.
+   **/
+  void releaseConsumed();
+
+  /** Append column col_number (1 is the first one) of the next lines
+   ** (see nextLine()), skipping comments, scaled by mul_factor, to
+   ** samples, until max_samples have been appended or end of file.
+   **
+   ** @return The number of appended samples, 0 at end of file.
+   **/
+  long readColumnNext(std::vector<double> & samples, int col_number, double mul_factor, size_t max_samples);
+
+  /** Append column col_number (1 is the first one) of all lines, after
+   ** discarding the first disc_lines lines and the comments, scaled
+   ** by mul_factor, to samples. Lines where the column is missing or
+   ** not numeric are skipped, with a warning.
+   **
+   ** @return The number of appended samples.
+   **/
+  long readColumn(std::vector<double> & samples, long disc_lines, int col_number, double mul_factor);
+
+  /** Locate the first num_cols columns of the line [beg, end).
+   **
+   ** @return The number of columns found (at most num_cols)
+   **/
+  static int splitColumns(const char *beg, const char *end,
+			  const char **cols_beg, const char **cols_end, int num_cols);
+  /** Parse the whole [beg, end) range as a double		*/
+  static bool parseDouble(const char *beg, const char *end, double *p_val);
+  /** Set the number of threads used by readColumn() (0 for the
+   ** number of available CPUs)
+   **/
+  static void setNumThreads(int num);
+};
+
+#endif
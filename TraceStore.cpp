@@ -0,0 +1,125 @@
+/*
+ * ARSim
+ * Copyright (c) 2000-2010 Tommaso Cucinotta
+ *
+ * This file is part of ARSim.
+ *
+ * ARSim is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * ARSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with ARSim. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include "TraceStore.hpp"
+#include "FileUtil.hpp"
+#include "Stat.hpp"
+#include "util.hpp"
+
+#include <stdio.h>
+#include <algorithm>
+#include <numeric>
+
+using namespace std;
+
+map<string, TraceStore::Entry *> & TraceStore::entries() {
+  static map<string, Entry *> store;
+  return store;
+}
+
+string TraceStore::getId(const TraceCacheKey & key) {
+  char buf[128];
+  snprintf(buf, sizeof(buf), "|%d|%d|%a|%a|%a", key.col_number, key.disc_lines,
+	   key.mul_factor, key.sat_p_min, key.sat_p_max);
+  return key.fname + buf;
+}
+
+TraceStore::Entry *TraceStore::acquire(const TraceCacheKey & key, bool use_cache) {
+  string id = getId(key);
+  map<string, Entry *>::iterator it = entries().find(id);
+  if (it != entries().end()) {
+    it->second->refs++;
+    printf("# Sharing %lu samples of trace file '%s'\n", (unsigned long) it->second->num_samples, key.fname.c_str());
+    return it->second;
+  }
+  Entry *p_entry = new Entry();
+  p_entry->key = key;
+  p_entry->refs = 1;
+  p_entry->p_cache = 0;
+  load(p_entry, use_cache);
+  entries()[id] = p_entry;
+  return p_entry;
+}
+
+void TraceStore::release(Entry *p_entry) {
+  if (--p_entry->refs > 0)
+    return;
+  entries().erase(getId(p_entry->key));
+  if (p_entry->p_cache != 0)
+    delete p_entry->p_cache;
+  delete p_entry;
+}
+
+/** Compute the summary of the loaded (and saturated) samples	*/
+static void calcSummary(TraceCacheSummary & sum, const vector<double> & samples) {
+  sum.min = *min_element(samples.begin(), samples.end());
+  sum.max = *max_element(samples.begin(), samples.end());
+  sum.avg = accumulate(samples.begin(), samples.end(), 0.0) / samples.size();
+  sum.perc[0] = sum.min;
+  sum.perc[1] = Stat::getMinPercentile(samples, 0.95, sum.min, sum.max);
+  sum.perc[2] = Stat::getMinPercentile(samples, 0.90, sum.min, sum.max);
+  sum.perc[3] = Stat::getMinPercentile(samples, 0.85, sum.min, sum.max);
+  sum.perc[4] = Stat::getMaxPercentile(samples, 0.85, sum.min, sum.max);
+  sum.perc[5] = Stat::getMaxPercentile(samples, 0.90, sum.min, sum.max);
+  sum.perc[6] = Stat::getMaxPercentile(samples, 0.95, sum.min, sum.max);
+  sum.perc[7] = Stat::getMaxPercentile(samples, 0.9995, sum.min, sum.max);
+  sum.perc[8] = sum.max;
+  // Statistics on moving avg on 3 samples
+  vector<double> mm;
+  int k = 3;
+  ASSERT(int(samples.size()) >= k, "Too short trace");
+  for (int i = 0; i < (int)samples.size() - k + 1; i++)
+    mm.push_back(accumulate(samples.begin() + i, samples.begin() + i + k, 0.0) / k);
+  sum.mm_min = *min_element(mm.begin(), mm.end());
+  sum.mm_max = *max_element(mm.begin(), mm.end());
+  sum.mm_avg = accumulate(mm.begin(), mm.end(), 0.0) / mm.size();
+  sum.mm_perc[0] = sum.mm_min;
+  sum.mm_perc[1] = Stat::getMinPercentile(mm, 0.95, sum.mm_min, sum.mm_max);
+  sum.mm_perc[2] = Stat::getMinPercentile(mm, 0.90, sum.mm_min, sum.mm_max);
+  sum.mm_perc[3] = Stat::getMinPercentile(mm, 0.85, sum.mm_min, sum.mm_max);
+  sum.mm_perc[4] = Stat::getMaxPercentile(mm, 0.85, sum.mm_min, sum.mm_max);
+  sum.mm_perc[5] = Stat::getMaxPercentile(mm, 0.90, sum.mm_min, sum.mm_max);
+  sum.mm_perc[6] = Stat::getMaxPercentile(mm, 0.95, sum.mm_min, sum.mm_max);
+  sum.mm_perc[7] = Stat::getMaxPercentile(mm, 0.9995, sum.mm_min, sum.mm_max);
+  sum.mm_perc[8] = sum.mm_max;
+}
+
+void TraceStore::load(Entry *p_entry, bool use_cache) {
+  const TraceCacheKey & key = p_entry->key;
+  const char *fname = key.fname.c_str();
+  if (use_cache && (p_entry->p_cache = TraceCache::open(key)) != 0) {
+    p_entry->p_samples = p_entry->p_cache->getSamples();
+    p_entry->num_samples = p_entry->p_cache->getNumSamples();
+    p_entry->summary = p_entry->p_cache->getSummary();
+    printf("# Loaded %lu samples of trace file '%s' from cache\n", (unsigned long) p_entry->num_samples, fname);
+    return;
+  }
+  vector<double> & samples = p_entry->samples;
+  ASSERT1(::loadTrace(samples, fname, key.disc_lines, key.col_number, key.mul_factor) > 0, "Could not load trace file %s", fname);
+
+  if (key.sat_p_min > 0.0 || key.sat_p_max < 1.0)
+    fprintf(stderr, "# Saturated %lu samples\n", Stat::saturateAtPercentiles(samples.begin(), samples.end(), key.sat_p_min, key.sat_p_max));
+
+  calcSummary(p_entry->summary, samples);
+  p_entry->p_samples = &samples[0];
+  p_entry->num_samples = samples.size();
+  if (use_cache && ! TraceCache::write(key, p_entry->summary, p_entry->p_samples, p_entry->num_samples))
+    fprintf(stderr, "# Warning: could not write trace cache %s\n", TraceCache::getFileName(key).c_str());
+}
@@ -0,0 +1,61 @@
+/*
+ * ARSim
+ * Copyright (c) 2000-2010 Tommaso Cucinotta
+ *
+ * This file is part of ARSim.
+ *
+ * ARSim is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * ARSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with ARSim. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef __ARSIM_TRACE_STORE_HPP__
+#  define __ARSIM_TRACE_STORE_HPP__
+
+#include "TraceCache.hpp"
+
+#include <map>
+#include <string>
+#include <vector>
+
+/** Process-wide store of read-only trace columns, shared among tasks.
+ **
+ ** Tasks replaying the same trace column with the same loading options
+ ** share a single, reference-counted copy of the samples (mapped from
+ ** the sidecar cache, or parsed), each one only keeping a cursor.
+ **/
+class TraceStore {
+public:
+
+  struct Entry {
+    TraceCacheKey key;
+    int refs;
+    std::vector<double> samples;	/**< Parsed samples, unless mapped from p_cache */
+    TraceCache *p_cache;
+    const double *p_samples;
+    size_t num_samples;
+    TraceCacheSummary summary;
+  };
+
+  /** Get the samples for key, loading them at the first request	*/
+  static Entry *acquire(const TraceCacheKey & key, bool use_cache);
+  /** Release an entry, freeing it when no more referenced		*/
+  static void release(Entry *p_entry);
+
+private:
+
+  static std::map<std::string, Entry *> & entries();
+  static std::string getId(const TraceCacheKey & key);
+  static void load(Entry *p_entry, bool use_cache);
+};
+
+#endif
@@ -0,0 +1,212 @@
+/*
+ * ARSim
+ * Copyright (c) 2000-2010 Tommaso Cucinotta
+ *
+ * This file is part of ARSim.
+ *
+ * ARSim is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * ARSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with ARSim. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include "TraceStream.hpp"
+#include "Stat.hpp"
+#include "util.hpp"
+
+#include <string.h>
+#include <stdio.h>
+#include <algorithm>
+
+TraceStream::TraceStream(const char *fname, long disc_lines, int col_number, double mul_factor, size_t window)
+  : col_number(col_number), mul_factor(mul_factor), window(window) {
+  ASSERT(window > 0, "Trace stream window must be positive");
+  p_reader = new TraceReader(fname);
+  p_reader->skipLines(disc_lines);
+  pos = 0;
+  next_ready = false;
+  stop = false;
+  curr.reserve(window);
+  prefetched.reserve(window);
+  prefetcher = std::thread(&TraceStream::prefetchLoop, this);
+}
+
+TraceStream::~TraceStream() {
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    stop = true;
+  }
+  cv.notify_all();
+  prefetcher.join();
+  delete p_reader;
+}
+
+/* The prefetched vector is owned by the prefetcher while next_ready is false,
+ * and by the consumer while it is true.
+ */
+void TraceStream::prefetchLoop() {
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lock(mtx);
+      while (next_ready && ! stop)
+	cv.wait(lock);
+      if (stop)
+	return;
+    }
+    prefetched.clear();
+    long n = p_reader->readColumnNext(prefetched, col_number, mul_factor, window);
+    p_reader->releaseConsumed();
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+      next_ready = true;
+    }
+    cv.notify_all();
+    if (n == 0)
+      return;
+  }
+}
+
+bool TraceStream::nextWindow() {
+  std::unique_lock<std::mutex> lock(mtx);
+  while (! next_ready)
+    cv.wait(lock);
+  if (prefetched.size() == 0)
+    return false;
+  curr.swap(prefetched);
+  pos = 0;
+  next_ready = false;
+  lock.unlock();
+  cv.notify_all();
+  return true;
+}
+
+TraceSummary::TraceSummary(size_t res_size, unsigned long mm_len)
+  : res_size(res_size), rng(0x9E3779B97F4A7C15ULL), mm_len(mm_len), mm_sum(0.0),
+    num(0), mm_num(0), min(0.0), max(0.0), sum(0.0), mm_min(0.0), mm_max(0.0), mm_total(0.0) {
+}
+
+/* Algorithm R, with a private xorshift generator so as not to perturb
+ * the random() sequence used by the simulation.
+ */
+void TraceSummary::addReservoir(std::vector<double> & res, unsigned long n, double x) {
+  if (res.size() < res_size) {
+    res.push_back(x);
+    return;
+  }
+  rng ^= rng << 13;
+  rng ^= rng >> 7;
+  rng ^= rng << 17;
+  unsigned long long j = rng % n;
+  if (j < res_size)
+    res[j] = x;
+}
+
+void TraceSummary::addSample(double x) {
+  if (num == 0 || x < min)
+    min = x;
+  if (num == 0 || x > max)
+    max = x;
+  sum += x;
+  addReservoir(res, ++num, x);
+
+  /* Moving average on the last mm_len samples */
+  if (mm_buf.size() < mm_len)
+    mm_buf.push_back(x);
+  else {
+    mm_sum -= mm_buf[(num - 1) % mm_len];
+    mm_buf[(num - 1) % mm_len] = x;
+  }
+  mm_sum += x;
+  if (num >= mm_len) {
+    double mm = mm_sum / mm_len;
+    if (mm_num == 0 || mm < mm_min)
+      mm_min = mm;
+    if (mm_num == 0 || mm > mm_max)
+      mm_max = mm;
+    mm_total += mm;
+    addReservoir(mm_res, ++mm_num, mm);
+  }
+}
+
+void TraceSummary::scan(const char *fname, long disc_lines, int col_number, double mul_factor, size_t window,
+			TraceSaturator *p_sat) {
+  TraceReader reader(fname);
+  reader.skipLines(disc_lines);
+  std::vector<double> buf;
+  buf.reserve(window);
+  for (;;) {
+    buf.clear();
+    if (reader.readColumnNext(buf, col_number, mul_factor, window) == 0)
+      break;
+    for (unsigned int i = 0; i < buf.size(); ++i)
+      addSample(p_sat != 0 ? p_sat->next(buf[i]) : buf[i]);
+    reader.releaseConsumed();
+  }
+}
+
+double TraceSummary::getPercentile(double p) const {
+  if (res.size() == 0)
+    return 0.0;
+  return Stat::getMaxPercentile(res, p, min, max);
+}
+
+/* Same percentiles as calcSummary() in TraceStore.cpp */
+void TraceSummary::getSummary(TraceCacheSummary & s) const {
+  static const double ps[] = { 0.95, 0.90, 0.85 };
+  memset(&s, 0, sizeof(s));
+  if (num == 0)
+    return;
+  s.min = s.perc[0] = min;
+  s.max = s.perc[8] = max;
+  s.avg = sum / num;
+  for (int i = 0; i < 3; ++i) {
+    s.perc[1 + i] = Stat::getMinPercentile(res, ps[i], min, max);
+    s.perc[6 - i] = Stat::getMaxPercentile(res, ps[i], min, max);
+  }
+  s.perc[7] = Stat::getMaxPercentile(res, 0.9995, min, max);
+  if (mm_num == 0)
+    return;
+  s.mm_min = s.mm_perc[0] = mm_min;
+  s.mm_max = s.mm_perc[8] = mm_max;
+  s.mm_avg = mm_total / mm_num;
+  for (int i = 0; i < 3; ++i) {
+    s.mm_perc[1 + i] = Stat::getMinPercentile(mm_res, ps[i], mm_min, mm_max);
+    s.mm_perc[6 - i] = Stat::getMaxPercentile(mm_res, ps[i], mm_min, mm_max);
+  }
+  s.mm_perc[7] = Stat::getMaxPercentile(mm_res, 0.9995, mm_min, mm_max);
+}
+
+bool TraceSummary::readHeader(const char *fname, double mul_factor) {
+  TraceReader reader(fname);
+  const char *beg, *end;
+  bool has_min = false, has_max = false;
+  const char *tag = "# arsim-trace:";
+  size_t tag_len = strlen(tag);
+  while (reader.nextLine(&beg, &end) && beg < end && *beg == '#') {
+    if ((size_t) (end - beg) < tag_len || strncmp(beg, tag, tag_len) != 0)
+      continue;
+    const char *cols_beg[8], *cols_end[8];
+    int n = TraceReader::splitColumns(beg + tag_len, end, cols_beg, cols_end, 8);
+    for (int i = 0; i < n; ++i) {
+      double v;
+      if (cols_end[i] - cols_beg[i] > 4 && strncmp(cols_beg[i], "min=", 4) == 0
+	  && TraceReader::parseDouble(cols_beg[i] + 4, cols_end[i], &v)) {
+	min = v * mul_factor;
+	has_min = true;
+      } else if (cols_end[i] - cols_beg[i] > 4 && strncmp(cols_beg[i], "max=", 4) == 0
+		 && TraceReader::parseDouble(cols_beg[i] + 4, cols_end[i], &v)) {
+	max = v * mul_factor;
+	has_max = true;
+      }
+    }
+  }
+  return has_min && has_max;
+}
@@ -0,0 +1,139 @@
+/*
+ * ARSim
+ * Copyright (c) 2000-2010 Tommaso Cucinotta
+ *
+ * This file is part of ARSim.
+ *
+ * ARSim is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * ARSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with ARSim. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef __ARSIM_TRACE_STREAM_HPP__
+#  define __ARSIM_TRACE_STREAM_HPP__
+
+#include "TraceReader.hpp"
+#include "TraceCache.hpp"
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+/** Sequential reader of a trace column in fixed-size windows.
+ **
+ ** While the simulation consumes the current window, a background
+ ** thread parses the next one, and the already parsed part of the
+ ** mapped file is given back to the kernel, so that memory stays
+ ** bounded to two windows, whatever the trace length.
+ **/
+class TraceStream {
+  TraceReader *p_reader;
+  int col_number;
+  double mul_factor;
+  size_t window;
+
+  std::vector<double> curr;	/**< Window being consumed		*/
+  size_t pos;			/**< Next sample within curr		*/
+  std::vector<double> prefetched; /**< Window being prefetched		*/
+  bool next_ready;		/**< prefetched is filled (empty at end of trace) */
+  bool stop;
+  std::thread prefetcher;
+  std::mutex mtx;
+  std::condition_variable cv;
+
+  void prefetchLoop();
+  bool nextWindow();
+
+public:
+
+  TraceStream(const char *fname, long disc_lines, int col_number, double mul_factor, size_t window);
+  ~TraceStream();
+
+  /** Get the next sample, returning false at end of trace	*/
+  bool next(double *p_val) {
+    if (pos == curr.size() && ! nextWindow())
+      return false;
+    *p_val = curr[pos++];
+    return true;
+  }
+};
+
+/** Saturation of a sequence of samples, sample by sample, as done by
+ ** Stat::saturate() on a whole trace: samples outside [x_min, x_max] are
+ ** replaced by the (saturated) one LAG positions before, or clamped if
+ ** there is none.
+ **/
+class TraceSaturator {
+  enum { LAG = 12 };
+  double x_min, x_max;
+  double hist[LAG];	/**< Last LAG output samples, circularly	*/
+  unsigned long num;
+
+public:
+
+  TraceSaturator(double x_min, double x_max) : x_min(x_min), x_max(x_max), num(0) { }
+
+  double next(double x) {
+    if (x < x_min || x > x_max)
+      x = num >= LAG ? hist[num % LAG] : (x < x_min ? x_min : x_max);
+    hist[num++ % LAG] = x;
+    return x;
+  }
+};
+
+/** One-pass summary of a trace column with bounded memory.
+ **
+ ** Min, max and mean are exact, while percentiles are estimated from
+ ** a uniform reservoir sample of the column, as Stat does on the whole
+ ** column (so they are the same while the reservoir holds all of it).
+ ** The same is done for the moving average on mm_len samples.
+ **/
+class TraceSummary {
+  size_t res_size;
+  unsigned long long rng;
+  unsigned long mm_len;
+  std::vector<double> mm_buf;
+  double mm_sum;
+
+  void addReservoir(std::vector<double> & res, unsigned long n, double x);
+
+public:
+
+  unsigned long num, mm_num;
+  double min, max, sum;
+  double mm_min, mm_max, mm_total;
+  std::vector<double> res, mm_res;
+
+  TraceSummary(size_t res_size = 100000, unsigned long mm_len = 3);
+
+  void addSample(double x);
+  /** Load the whole column of the trace, in windows of the given size,
+   ** saturating the samples if p_sat is not null			*/
+  void scan(const char *fname, long disc_lines, int col_number, double mul_factor, size_t window,
+	    TraceSaturator *p_sat = 0);
+  /** Estimated value below which a fraction p of the samples lies, as
+   ** Stat::getMaxPercentile()						*/
+  double getPercentile(double p) const;
+  /** Fill s as the in-memory trace summary (see TraceStore)		*/
+  void getSummary(TraceCacheSummary & s) const;
+
+  /** Read "# arsim-trace: min=<v> max=<v>" header lines at the top of the
+   ** trace, which allow to skip the scan() pass. Values are multiplied
+   ** by mul_factor.
+   **
+   ** @return true if both min and max were found
+   **/
+  bool readHeader(const char *fname, double mul_factor);
+};
+
+#endif
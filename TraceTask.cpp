@@ -25,6 +25,7 @@
 #include "util.hpp"
 #include "FileUtil.hpp"
 #include "Stat.hpp"
+#include "TraceStore.hpp"
 
 /* Implementation includes */
 
@@ -45,76 +46,131 @@ TraceTask::TraceTask()
   ASSERT(trace_fname != 0, "Out of memory");
   mul_factor = 1.0;
   disc_lines = 0;
-  curr_sample = samples.begin();
+  p_samples = 0;
+  num_samples = 0;
+  curr_pos = 0;
+  num_generated = 0;
+  trace_off = 0;
+  trace_stride = 1;
+  p_trace = 0;
+  use_cache = true;
   col_number = 0;
   sat_p_min = 0.0;
   sat_p_max = 1.0;
+  stream_window = 0;
+  p_stream = 0;
+  p_sat = 0;
 }
 
 TraceTask::~TraceTask() {
   if (trace_fname != 0)
     free(trace_fname);
+  if (p_stream != 0)
+    delete p_stream;
+  if (p_sat != 0)
+    delete p_sat;
+  if (p_trace != 0)
+    TraceStore::release(p_trace);
+}
+
+/** Print the summary of the (saturated) trace samples */
+static void printTraceSummary(const TraceCacheSummary & sum, double mul_factor, double c_min, double c_max, double period) {
+  fprintf(stderr, "# Trace file (scaled by %g): min= %g max= %g avg= %g\n", mul_factor, c_min/period, c_max/period, sum.avg/period);
+  fprintf(stderr, "# Samples: Percentiles (00, 05, 10, 15, 85, 90, 95, 99.95, 100) = ( %g %g %g %g %g %g %g %g %g )\n",
+	  sum.perc[0]/period, sum.perc[1]/period, sum.perc[2]/period, sum.perc[3]/period, sum.perc[4]/period,
+	  sum.perc[5]/period, sum.perc[6]/period, sum.perc[7]/period, sum.perc[8]/period);
+  fprintf(stderr, "# Moving Avg on %d samples (scaled by %g): min= %g max= %g avg= %g\n", 3, mul_factor, sum.mm_min/period, sum.mm_max/period, sum.mm_avg/period);
+  fprintf(stderr, "# Moving Avg (%d): Percentiles (00, 05, 10, 15, 85, 90, 95, 99.95, 100) = ( %g %g %g %g %g %g %g %g %g )\n", 3,
+	  sum.mm_perc[0]/period, sum.mm_perc[1]/period, sum.mm_perc[2]/period, sum.mm_perc[3]/period, sum.mm_perc[4]/period,
+	  sum.mm_perc[5]/period, sum.mm_perc[6]/period, sum.mm_perc[7]/period, sum.mm_perc[8]/period);
 }
 
 void TraceTask::loadTrace() {
-  ASSERT1(::loadTrace(samples, trace_fname, disc_lines, col_number, mul_factor) > 0, "Could not load trace file %s", trace_fname);
+  TraceCacheKey key;
+  key.fname = trace_fname;
+  key.col_number = col_number;
+  key.disc_lines = disc_lines;
+  key.mul_factor = mul_factor;
+  key.sat_p_min = sat_p_min;
+  key.sat_p_max = sat_p_max;
 
-  if (sat_p_min > 0.0 || sat_p_max < 1.0)
-    fprintf(stderr, "# Saturated %lu samples\n", Stat::saturateAtPercentiles(samples.begin(), samples.end(), sat_p_min, sat_p_max));
+  p_trace = TraceStore::acquire(key, use_cache);
+  p_samples = p_trace->p_samples;
+  num_samples = p_trace->num_samples;
+  curr_pos = trace_off % num_samples;
+  num_generated = 0;
+  const TraceCacheSummary & sum = p_trace->summary;
 
   if (c_min == UNASSIGNED) {
-    vector<double>::iterator it = min_element(samples.begin(), samples.end());
-    c_min = *it;
+    c_min = sum.min;
     Logger::debugLog("min(c_k)=%g\n", c_min);
   }
   if (c_max == UNASSIGNED) {
-    vector<double>::iterator it = max_element(samples.begin(), samples.end());
-    c_max = *it;
+    c_max = sum.max;
     Logger::debugLog("max(c_k)=%g\n", c_max);
   }
-  double avg = accumulate(samples.begin(), samples.end(), 0.0) / samples.size();
-  fprintf(stderr, "# Trace file (scaled by %g): min= %g max= %g avg= %g\n", mul_factor, c_min/period, c_max/period, avg/period);
-  fprintf(stderr, "# Samples: Percentiles (00, 05, 10, 15, 85, 90, 95, 99.95, 100) = ( %g %g %g %g %g %g %g %g %g )\n",
-	  (*min_element(samples.begin(), samples.end()))/period,
-	  Stat::getMinPercentile(samples, 0.95, c_min, c_max)/period,
-	  Stat::getMinPercentile(samples, 0.90, c_min, c_max)/period,
-	  Stat::getMinPercentile(samples, 0.85, c_min, c_max)/period,
-	  Stat::getMaxPercentile(samples, 0.85, c_min, c_max)/period,
-	  Stat::getMaxPercentile(samples, 0.90, c_min, c_max)/period,
-	  Stat::getMaxPercentile(samples, 0.95, c_min, c_max)/period,
-	  Stat::getMaxPercentile(samples, 0.9995, c_min, c_max)/period,
-	  (*max_element(samples.begin(), samples.end()))/period);
-  // Output statistics on moving avg on 3 samples
-  vector<double> mm;
-  int k = 3;
-  ASSERT(int(samples.size()) >= k, "Too short trace");
-  for (int i = 0; i < (int)samples.size() - k + 1; i++)
-    mm.push_back(accumulate(samples.begin() + i, samples.begin() + i + k, 0.0) / k);
-  double mm_min = *min_element(mm.begin(), mm.end());
-  double mm_max = *max_element(mm.begin(), mm.end());
-  double mm_avg = accumulate(mm.begin(), mm.end(), 0.0) / mm.size();
-  fprintf(stderr, "# Moving Avg on %d samples (scaled by %g): min= %g max= %g avg= %g\n", k, mul_factor, mm_min/period, mm_max/period, mm_avg/period);
-  fprintf(stderr, "# Moving Avg (%d): Percentiles (00, 05, 10, 15, 85, 90, 95, 99.95, 100) = ( %g %g %g %g %g %g %g %g %g )\n", k,
-	  (*min_element(mm.begin(), mm.end()))/period,
-	  Stat::getMinPercentile(mm, 0.95, mm_min, mm_max)/period,
-	  Stat::getMinPercentile(mm, 0.90, mm_min, mm_max)/period,
-	  Stat::getMinPercentile(mm, 0.85, mm_min, mm_max)/period,
-	  Stat::getMaxPercentile(mm, 0.85, mm_min, mm_max)/period,
-	  Stat::getMaxPercentile(mm, 0.90, mm_min, mm_max)/period,
-	  Stat::getMaxPercentile(mm, 0.95, mm_min, mm_max)/period,
-	  Stat::getMaxPercentile(mm, 0.9995, mm_min, mm_max)/period,
-	  (*max_element(mm.begin(), mm.end()))/period);
+  printTraceSummary(sum, mul_factor, c_min, c_max, period);
+}
+
+/** Streaming mode: take c_min/c_max from the trace header or from a
+ ** bounded-memory summary pass, then start the prefetching stream.
+ **/
+void TraceTask::openStream() {
+  CHECK(trace_off == 0 && trace_stride == 1, "Options -tr-off and -tr-stride are not supported with -tr-stream");
+  TraceSummary sum;
+  bool need_scan = sat_p_min > 0.0 || sat_p_max < 1.0 || ! sum.readHeader(trace_fname, mul_factor);
+  if (need_scan) {
+    fprintf(stderr, "# Scanning trace file %s\n", trace_fname);
+    sum.scan(trace_fname, disc_lines, col_number, mul_factor, stream_window);
+    ASSERT1(sum.num > 0, "Could not load trace file %s", trace_fname);
+    if (sat_p_min > 0.0 || sat_p_max < 1.0) {
+      /* Same thresholds as Stat::saturateAtPercentiles() in memory */
+      double sat_min = sum.getPercentile(sat_p_min);
+      double sat_max = sum.getPercentile(sat_p_max);
+      fprintf(stderr, "# Saturating samples to [%g, %g]\n", sat_min, sat_max);
+      p_sat = new TraceSaturator(sat_min, sat_max);
+      /* Summarize the saturated samples, with a second pass */
+      TraceSaturator sat(sat_min, sat_max);
+      sum = TraceSummary();
+      sum.scan(trace_fname, disc_lines, col_number, mul_factor, stream_window, &sat);
+    }
+  }
+  if (c_min == UNASSIGNED) {
+    c_min = sum.min;
+    Logger::debugLog("min(c_k)=%g\n", c_min);
+  }
+  if (c_max == UNASSIGNED) {
+    c_max = sum.max;
+    Logger::debugLog("max(c_k)=%g\n", c_max);
+  }
+  if (need_scan) {
+    TraceCacheSummary s;
+    sum.getSummary(s);
+    printTraceSummary(s, mul_factor, c_min, c_max, period);
+  } else {
+    fprintf(stderr, "# Trace file (scaled by %g): min= %g max= %g (from header)\n", mul_factor, c_min/period, c_max/period);
+  }
+  p_stream = new TraceStream(trace_fname, disc_lines, col_number, mul_factor, stream_window);
 }
 
 double TraceTask::generateInstance() {
   double sample;
-  if (curr_sample == samples.end()) {
+  if (p_stream != 0) {
+    if (! p_stream->next(&sample)) {
+      fprintf(stderr, "Reached EOF of %s\n", trace_fname);
+      return 0.0;
+    }
+    return p_sat != 0 ? p_sat->next(sample) : sample;
+  }
+  if (num_generated * trace_stride >= num_samples) {
     fprintf(stderr, "Reached EOF of %s\n", trace_fname);
     return 0.0;
   }
 
-  sample = *curr_sample;
-  ++curr_sample;
+  sample = p_samples[curr_pos];
+  /* With an offset and/or stride, the cursor wraps around the trace */
+  curr_pos = (curr_pos + trace_stride) % num_samples;
+  ++num_generated;
   return sample;
 }
 
@@ -125,6 +181,10 @@ void TraceTask::usage() {
   printf("(-t tr)    -disc   Lines to discard at head of trace file (defaults to 0)\n");
   printf("(-t tr)    -tr-s p Saturate input at specified top distribution percentile (defaults to 1.0)\n");
   printf("(-t tr)    -tr-S p Saturate input at specified distribution percentile (defaults to 0.0)\n");
+  printf("(-t tr)    -tr-off n Start replaying the trace from sample n, wrapping around at its end\n");
+  printf("(-t tr)    -tr-stride s Use one sample every s, wrapping around at the end of the trace\n");
+  printf("(-t tr)    -tr-no-cache Do not use nor write the binary sidecar cache of the trace\n");
+  printf("(-t tr)    -tr-stream w Stream the trace in windows of w samples, instead of loading it in memory\n");
 }
 
 bool TraceTask::parseArg(int& argc, char **& argv) {
@@ -157,6 +217,26 @@ bool TraceTask::parseArg(int& argc, char **& argv) {
     CHECK(argc > 1, "Option requires an argument");
     argv++;  argc--;
     CHECK((sscanf(*argv, "%lg", &sat_p_max) == 1) && (sat_p_max >= 0.0 && sat_p_max <= 1.0), "Expecting positive real in the [0,1] range as argument to -tr-S option");
+  } else if (strcmp(*argv, "-tr-off") == 0) {
+    CHECK(argc > 1, "Option requires an argument");
+    argv++;  argc--;
+    long off;
+    CHECK((sscanf(*argv, "%ld", &off) == 1) && (off >= 0), "Expecting non-negative integer as argument to -tr-off option");
+    trace_off = off;
+  } else if (strcmp(*argv, "-tr-stride") == 0) {
+    CHECK(argc > 1, "Option requires an argument");
+    argv++;  argc--;
+    long stride;
+    CHECK((sscanf(*argv, "%ld", &stride) == 1) && (stride >= 1), "Expecting positive integer as argument to -tr-stride option");
+    trace_stride = stride;
+  } else if (strcmp(*argv, "-tr-no-cache") == 0) {
+    use_cache = false;
+  } else if (strcmp(*argv, "-tr-stream") == 0) {
+    CHECK(argc > 1, "Option requires an argument");
+    argv++;  argc--;
+    long w;
+    CHECK((sscanf(*argv, "%ld", &w) == 1) && (w > 0), "Expecting positive integer as argument to -tr-stream option");
+    stream_window = w;
   } else
     return false;
   return true;
@@ -172,9 +252,11 @@ bool TraceTask::checkParams() {
 
 void TraceTask::calcParams() {
   parent::calcParams();
-  if (samples.size() == 0) {
+  if (stream_window > 0) {
+    if (p_stream == 0)
+      openStream();
+  } else if (num_samples == 0) {
     loadTrace();
-    ASSERT(samples.size() > 0, "Could not load trace samples");
-    curr_sample = samples.begin();
+    ASSERT(num_samples > 0, "Could not load trace samples");
   }
 }
@@ -22,6 +22,8 @@
 #  define __ARSIM_TRACE_TASK_HPP__
 
 #include "DoubleLimitedTask.hpp"
+#include "TraceStream.hpp"
+#include "TraceStore.hpp"
 
 #include <stdio.h>
 #include <vector>
@@ -39,8 +41,19 @@ class TraceTask : public DoubleLimitedTask {
   int col_number;       //< Column number to be used from the trace file
   double sat_p_min;     //< Bottom percentile saturation value for the input samples
   double sat_p_max;     //< Top percentile saturation value for the input samples
-  vector<double> samples;
-  vector<double>::iterator curr_sample;
+  TraceStore::Entry *p_trace;	//< Shared samples of the trace
+  const double *p_samples;
+  size_t num_samples;
+  size_t curr_pos;		//< Cursor within p_samples
+  size_t num_generated;		//< Samples generated so far
+  size_t trace_off;		//< Start position within the trace
+  size_t trace_stride;		//< Distance between consecutive samples
+  bool use_cache;
+  size_t stream_window;	//< Samples per window in streaming mode (0 if trace is loaded in memory)
+  TraceStream *p_stream;
+  TraceSaturator *p_sat;	//< Saturation of the samples in streaming mode, if any
+
+  void openStream();
 
  public:
 
@@ -58,9 +71,10 @@ class TraceTask : public DoubleLimitedTask {
   virtual bool checkParams();
   virtual void calcParams();
 
-  vector<double> const & getSamples() const {
-    return samples;
-  }
+  const double *getSamples() const { return p_samples; }
+  size_t getNumSamples() const { return num_samples; }
+  /** Whether the trace is streamed, so there are no samples in memory */
+  bool isStreaming() const { return stream_window > 0; }
 };
 
 #endif
@@ -0,0 +1,121 @@
+/*
+ * ARSim
+ * Copyright (c) 2000-2010 Tommaso Cucinotta
+ *
+ * This file is part of ARSim.
+ *
+ * ARSim is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * ARSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with ARSim. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <algorithm>
+
+#include "WindowTimeStat.hpp"
+#include "util.hpp"
+
+WindowTimeStat::WindowTimeStat(double window, int num_buckets, double now) {
+  CHECK(window > 0.0 && num_buckets > 0, "Window and number of sub-buckets of a WindowTimeStat must be positive");
+  dt = window / num_buckets;
+  /* One more sub-bucket, partially overlapping the window, makes it
+   * always cover a time span between window and window + dt	*/
+  buckets.resize(num_buckets + 1);
+  clear(now);
+}
+
+void WindowTimeStat::clear(double now) {
+  for (unsigned int i = 0; i < buckets.size(); ++i) {
+    buckets[i].id = -1;
+    buckets[i].w = buckets[i].x_sum = buckets[i].x_sqr_sum = 0.0;
+  }
+  prev_x = 0.0;
+  prev_t = now;
+  has_samples = false;
+}
+
+void WindowTimeStat::addInterval(double x, double t1, double t2) {
+  long n = buckets.size();
+  long id1 = getBucketId(t1);
+  long id2 = getBucketId(t2);
+  /* Sub-buckets older than the window ending at t2 would be overwritten */
+  if (id2 - id1 >= n) {
+    id1 = id2 - n + 1;
+    t1 = id1 * dt;
+  }
+  for (long id = id1; id <= id2; ++id) {
+    Bucket & b = buckets[id % n];
+    if (b.id != id) {
+      b.id = id;
+      b.w = b.x_sum = b.x_sqr_sum = 0.0;
+    }
+    double w = std::min(t2, (id + 1) * dt) - std::max(t1, id * dt);
+    if (w <= 0.0)
+      continue;
+    b.w += w;
+    b.x_sum += x * w;
+    b.x_sqr_sum += x * x * w;
+  }
+}
+
+void WindowTimeStat::addSample(double x, double t) {
+  if (has_samples)
+    addInterval(prev_x, prev_t, t);
+  prev_x = x;
+  prev_t = t;
+  has_samples = true;
+}
+
+void WindowTimeStat::getSums(double now, double & w, double & xs, double & xss) const {
+  long n = buckets.size();
+  long id_now = getBucketId(now);
+  w = xs = xss = 0.0;
+  for (long i = 0; i < n; ++i) {
+    const Bucket & b = buckets[i];
+    if (b.id > id_now - n && b.id <= id_now) {
+      w += b.w;
+      xs += b.x_sum;
+      xss += b.x_sqr_sum;
+    }
+  }
+  if (has_samples) {
+    double dw = now - std::max(prev_t, (id_now - n + 1) * dt);
+    if (dw > 0.0) {
+      w += dw;
+      xs += prev_x * dw;
+      xss += prev_x * prev_x * dw;
+    }
+  }
+}
+
+double WindowTimeStat::getMean(double now) const {
+  double w, xs, xss;
+  getSums(now, w, xs, xss);
+  if (w <= 0.0)
+    return prev_x;
+  return xs / w;
+}
+
+double WindowTimeStat::getDev(double now) const {
+  double w, xs, xss;
+  getSums(now, w, xs, xss);
+  if (w <= 0.0)
+    return 0.0;
+  double m = xs / w;
+  double v = xss / w - m * m;
+  return v > 0.0 ? sqrt(v) : 0.0;
+}
+
+double WindowTimeStat::getWeight(double now) const {
+  double w, xs, xss;
+  getSums(now, w, xs, xss);
+  return w;
+}
@@ -0,0 +1,65 @@
+/*
+ * ARSim
+ * Copyright (c) 2000-2010 Tommaso Cucinotta
+ *
+ * This file is part of ARSim.
+ *
+ * ARSim is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * ARSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with ARSim. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef __ARSIM_WINDOW_TIME_STAT_HPP__
+#define   __ARSIM_WINDOW_TIME_STAT_HPP__
+
+#include "MovingTimeStat.hpp"
+
+#include <math.h>
+#include <vector>
+
+/** Time-weighted mean and variance over a sliding time window, kept as
+ ** a ring of num_buckets sub-buckets of width window/num_buckets. The
+ ** window slides by whole sub-buckets: at time now, it covers the
+ ** current sub-bucket and the num_buckets-1 previous ones.
+ **/
+class WindowTimeStat : public MovingTimeStat {
+  struct Bucket {
+    long id;		// Absolute index of the sub-bucket: floor(t / dt)
+    double w;		// Time covered within the sub-bucket
+    double x_sum;	// Time-weighted sum of samples
+    double x_sqr_sum;	// Time-weighted sum of square samples
+  };
+  std::vector<Bucket> buckets;
+  double dt;		// Width of a sub-bucket
+  double prev_x;	// Last sample
+  double prev_t;	// Time of insertion of last sample
+  bool has_samples;
+
+  long getBucketId(double t) const { return long(floor(t / dt)); }
+  /** Account for x held during [t1, t2]			*/
+  void addInterval(double x, double t1, double t2);
+  /** Sums at time now, accounting for prev_x held since prev_t	*/
+  void getSums(double now, double & w, double & xs, double & xss) const;
+
+ public:
+
+  WindowTimeStat(double window, int num_buckets, double now = 0.0);
+
+  virtual void addSample(double x, double t);
+  virtual double getMean(double now) const;
+  virtual double getDev(double now) const;
+  virtual double getWeight(double now) const;
+  virtual bool hasSamples() const { return has_samples; }
+  virtual void clear(double now);
+};
+
+#endif
@@ -0,0 +1,375 @@
+/*
+ * ARSim
+ * Copyright (c) 2000-2010 Tommaso Cucinotta
+ *
+ * This file is part of ARSim.
+ *
+ * ARSim is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * ARSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with ARSim. If not, see <http://www.gnu.org/licenses/>
+ */
+
+/* Interface includes */
+
+#include "arsim.h"
+#include "globals.hpp"
+#include "SimContext.hpp"
+#include "ResourceManager.hpp"
+#include "TaskScheduler.hpp"
+#include "Controller.hpp"
+#include "GlobalOptimizer.hpp"
+#include "ReplayHarness.hpp"
+#include "Stat.hpp"
+#include "TimeStat.hpp"
+#include "util.hpp"
+
+/* Implementation includes */
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <limits.h>
+
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+struct arsim_sim {
+  SimContext *p_ctx;
+  std::string dir;		/**< Output directory, or empty		*/
+  std::string err;		/**< Last error message, or empty	*/
+  bool failed;			/**< Unusable after an error		*/
+  bool started;			/**< startSimulation() has been called	*/
+  bool done;			/**< Exit condition reached		*/
+  std::vector<char *> args;	/**< Copies of the options, which parsers may keep pointers to */
+};
+
+/** Serializes all the simulations of the process, as only one SimContext
+ ** may be entered at a time */
+static std::mutex sim_mtx;
+
+/** Lock the process-wide mutex and enter the simulation context for the
+ ** scope of an API call, switching to its output directory if any. */
+class SimScope {
+  arsim_sim *sim;
+  std::lock_guard<std::mutex> lock;
+  char prev_dir[PATH_MAX];
+  bool changed_dir;
+public:
+  SimScope(arsim_sim *sim) : sim(sim), lock(sim_mtx), changed_dir(false) {
+    if (sim->dir.size() > 0 && getcwd(prev_dir, sizeof(prev_dir)) != NULL
+        && chdir(sim->dir.c_str()) == 0)
+      changed_dir = true;
+    sim->p_ctx->enter();
+  }
+  ~SimScope() {
+    sim->p_ctx->leave();
+    if (changed_dir && chdir(prev_dir) != 0)
+      fprintf(stderr, "Warning: could not restore working directory %s\n", prev_dir);
+  }
+};
+
+/** Record a failure, after which the simulation may be inconsistent	*/
+static int fail(arsim_sim *sim, const char *msg) {
+  sim->err = msg;
+  sim->failed = true;
+  return ARSIM_ERR;
+}
+
+/** Record a wrong argument, which leaves the simulation usable		*/
+static int wrongArg(arsim_sim *sim, const char *msg) {
+  sim->err = msg;
+  return ARSIM_ERR_ARG;
+}
+
+/** Copy the options, which are kept for the simulation lifetime, and
+ ** parse them on p_tsched, or else on p_rm, or else as general options,
+ ** returning false on an unknown option.				*/
+static bool parseOptions(arsim_sim *sim, int argc, const char * const *argv,
+                         ResourceManager *p_rm, TaskScheduler *p_tsched) {
+  size_t first = sim->args.size();
+  for (int i = 0; i < argc; ++i) {
+    char *s = strdup(argv[i]);
+    CHECK(s != NULL, "No memory");
+    sim->args.push_back(s);
+  }
+  if (argc == 0)
+    return true;
+  char **p_argv = &sim->args[first];
+  while (argc > 0) {
+    bool parsed;
+    if (p_tsched != 0)
+      parsed = p_tsched->parseArg(argc, p_argv);
+    else if (p_rm != 0)
+      parsed = p_rm->parseArg(argc, p_argv);
+    else
+      parsed = parseArg(argc, p_argv);
+    if (! parsed) {
+      sim->err = std::string("Unknown option: ") + *p_argv;
+      return false;
+    }
+    p_argv++;  argc--;
+  }
+  return true;
+}
+
+static ResourceManager *getResource(int rs) {
+  if (rs < 0 || rs >= (int) ResourceManager::rs_controllers.size())
+    return 0;
+  return ResourceManager::rs_controllers[rs];
+}
+
+static TaskScheduler *getTask(int tsk, int rs) {
+  ResourceManager *p_rm = getResource(rs);
+  if (p_rm == 0 || tsk < 0)
+    return 0;
+  return p_rm->getTaskSchedulerAt(tsk);
+}
+
+/** Start the simulation on the first step				*/
+static void ensureStarted(arsim_sim *sim) {
+  if (! sim->started) {
+    startSimulation();
+    sim->started = true;
+  }
+}
+
+extern "C" {
+
+int arsim_api_version(void) {
+  return ARSIM_API_VERSION;
+}
+
+arsim_sim *arsim_create(const char *dir, unsigned int seed, int argc, const char * const *argv) {
+  arsim_sim *sim = new (std::nothrow) arsim_sim();
+  if (sim == NULL)
+    return NULL;
+  sim->failed = false;
+  sim->started = false;
+  sim->done = false;
+  if (dir != NULL)
+    sim->dir = dir;
+  sim->p_ctx = new (std::nothrow) SimContext(seed);
+  if (sim->p_ctx == NULL) {
+    delete sim;
+    return NULL;
+  }
+  SimScope scope(sim);
+  try {
+    p_gsched = new ResourceManager();
+    if (! parseOptions(sim, argc, argv, 0, 0))
+      sim->failed = true;
+    else if (ReplayHarness::getInstance()->isEnabled())
+      fail(sim, "The replay harness cannot be embedded");
+  } catch (std::exception & e) {
+    fail(sim, e.what());
+  }
+  return sim;
+}
+
+void arsim_destroy(arsim_sim *sim) {
+  if (sim == NULL)
+    return;
+  {
+    std::lock_guard<std::mutex> lock(sim_mtx);
+    delete sim->p_ctx;
+  }
+  for (std::vector<char *>::iterator it = sim->args.begin(); it != sim->args.end(); ++it)
+    free(*it);
+  delete sim;
+}
+
+const char *arsim_last_error(const arsim_sim *sim) {
+  return sim->err.size() > 0 ? sim->err.c_str() : NULL;
+}
+
+int arsim_run(arsim_sim *sim) {
+  if (sim->failed)
+    return ARSIM_ERR_STATE;
+  SimScope scope(sim);
+  try {
+    ensureStarted(sim);
+    while (! sim->done)
+      sim->done = stepSimulation() >= 1.0;
+  } catch (std::exception & e) {
+    return fail(sim, e.what());
+  }
+  return ARSIM_DONE;
+}
+
+int arsim_step_time(arsim_sim *sim, double dt) {
+  if (sim->failed)
+    return ARSIM_ERR_STATE;
+  SimScope scope(sim);
+  try {
+    ensureStarted(sim);
+    Time t_end = EventList::getTime() + dt;
+    Time t_next = EventList::events().getNextTime();
+    while (t_next >= 0 && t_next <= t_end) {
+      sim->done = stepSimulation() >= 1.0 || sim->done;
+      t_next = EventList::events().getNextTime();
+    }
+  } catch (std::exception & e) {
+    return fail(sim, e.what());
+  }
+  return sim->done ? ARSIM_DONE : ARSIM_OK;
+}
+
+int arsim_step_jobs(arsim_sim *sim, long num_jobs, int tsk, int rs) {
+  if (sim->failed)
+    return ARSIM_ERR_STATE;
+  SimScope scope(sim);
+  TaskScheduler *p_tsched = getTask(tsk, rs);
+  if (p_tsched == 0)
+    return wrongArg(sim, "No such task");
+  try {
+    ensureStarted(sim);
+    long job_end = p_tsched->getLastFinishedJobID() + num_jobs;
+    while (p_tsched->getLastFinishedJobID() < job_end)
+      sim->done = stepSimulation() >= 1.0 || sim->done;
+  } catch (std::exception & e) {
+    return fail(sim, e.what());
+  }
+  return sim->done ? ARSIM_DONE : ARSIM_OK;
+}
+
+int arsim_finish(arsim_sim *sim) {
+  if (sim->failed)
+    return ARSIM_ERR_STATE;
+  SimScope scope(sim);
+  try {
+    ensureStarted(sim);
+    endSimulation();
+  } catch (std::exception & e) {
+    return fail(sim, e.what());
+  }
+  return ARSIM_OK;
+}
+
+double arsim_get_time(arsim_sim *sim) {
+  SimScope scope(sim);
+  try {
+    return EventList::getTime();
+  } catch (std::exception & e) {
+    return fail(sim, e.what());
+  }
+}
+
+int arsim_num_resources(arsim_sim *sim) {
+  SimScope scope(sim);
+  try {
+    return ResourceManager::rs_controllers.size();
+  } catch (std::exception & e) {
+    return fail(sim, e.what());
+  }
+}
+
+int arsim_num_tasks(arsim_sim *sim, int rs) {
+  SimScope scope(sim);
+  try {
+    ResourceManager *p_rm = getResource(rs);
+    if (p_rm == 0)
+      return wrongArg(sim, "No such resource");
+    return p_rm->getTaskSchedulerNum();
+  } catch (std::exception & e) {
+    return fail(sim, e.what());
+  }
+}
+
+long arsim_last_job(arsim_sim *sim, int tsk, int rs) {
+  SimScope scope(sim);
+  try {
+    TaskScheduler *p_tsched = getTask(tsk, rs);
+    if (p_tsched == 0)
+      return wrongArg(sim, "No such task");
+    return p_tsched->getLastFinishedJobID();
+  } catch (std::exception & e) {
+    return fail(sim, e.what());
+  }
+}
+
+int arsim_get_stat(arsim_sim *sim, int tsk, int rs, const char *name, arsim_stat_view *view) {
+  SimScope scope(sim);
+  try {
+    TaskScheduler *p_tsched = getTask(tsk, rs);
+    if (p_tsched == 0)
+      return wrongArg(sim, "No such task");
+    vector< pair<const char *, const BaseStat *> > stats;
+    p_tsched->getStats(stats);
+    const BaseStat *p_stat = 0;
+    for (unsigned int i = 0; i < stats.size(); ++i)
+      if (strcmp(stats[i].first, name) == 0)
+        p_stat = stats[i].second;
+    if (p_stat == 0)
+      return wrongArg(sim, "No such statistic, or not available before the first step");
+
+    memset(view, 0, sizeof(*view));
+    view->size = p_stat->getPMFSize();
+    view->x_min = view->size > 0 ? p_stat->getXValue(0) : 0.0;
+    view->dx = view->size > 1 ? p_stat->getXValue(1) - view->x_min : 1.0;
+    const Stat *p_s = dynamic_cast<const Stat *>(p_stat);
+    const TimeStat *p_ts = dynamic_cast<const TimeStat *>(p_stat);
+    if (p_s != 0) {
+      view->kind = ARSIM_STAT_COUNT;
+      view->counts = p_s->getPMFData();
+      view->num_samples = p_s->getNumSamples();
+      view->norm = view->num_samples;
+    } else if (p_ts != 0) {
+      view->kind = ARSIM_STAT_TIME;
+      view->weights = p_ts->getPMFData();
+      view->num_samples = p_ts->getNumSamples();
+      view->norm = p_ts->getDuration();
+    } else {
+      view->kind = ARSIM_STAT_SKETCH;
+      view->num_samples = p_stat->getNumSamples();
+      view->norm = 1.0;
+    }
+    view->mean = p_stat->getMean();
+    view->dev = p_stat->getDev();
+    view->min = p_stat->getMin();
+    view->max = p_stat->getMax();
+    return ARSIM_OK;
+  } catch (std::exception & e) {
+    return fail(sim, e.what());
+  }
+}
+
+int arsim_set_options(arsim_sim *sim, int tsk, int rs, int argc, const char * const *argv) {
+  if (sim->failed)
+    return ARSIM_ERR_STATE;
+  SimScope scope(sim);
+  try {
+    if (rs < 0)
+      return parseOptions(sim, argc, argv, 0, 0) ? ARSIM_OK : ARSIM_ERR_ARG;
+    ResourceManager *p_rm = getResource(rs);
+    if (p_rm == 0)
+      return wrongArg(sim, "No such resource");
+    if (tsk < 0)
+      return parseOptions(sim, argc, argv, p_rm, 0) ? ARSIM_OK : ARSIM_ERR_ARG;
+    TaskScheduler *p_tsched = getTask(tsk, rs);
+    if (p_tsched == 0)
+      return wrongArg(sim, "No such task");
+    if (! parseOptions(sim, argc, argv, p_rm, p_tsched))
+      return ARSIM_ERR_ARG;
+    if (sim->started) {
+      p_tsched->calcParams();
+      CHECK(p_tsched->checkParams(), "Scheduling not possible with the new parameters");
+    }
+  } catch (std::exception & e) {
+    return fail(sim, e.what());
+  }
+  return ARSIM_OK;
+}
+
+}
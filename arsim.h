@@ -0,0 +1,152 @@
+/*
+ * ARSim
+ * Copyright (c) 2000-2010 Tommaso Cucinotta
+ *
+ * This file is part of ARSim.
+ *
+ * ARSim is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * ARSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with ARSim. If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef ARSIM_H_
+#define ARSIM_H_
+
+#ifdef  __cplusplus
+extern "C" {
+#endif
+
+/** Embeddable C API of the simulator, built as libarsim.so.
+ **
+ ** A simulation is created from the same options accepted by the arsim
+ ** program, advanced by time or by jobs, inspected through zero-copy views
+ ** over its live statistics, reconfigured between steps, and destroyed.
+ **
+ ** Independent simulations may be driven from different threads: calls are
+ ** serialized internally, each one swapping in the state of its own
+ ** simulation. A single simulation must not be used by two threads at the
+ ** same time. Errors in the options do not terminate the host program:
+ ** they are reported through return codes and arsim_last_error().
+ **/
+
+/** Version of this interface, bumped on incompatible changes */
+#define ARSIM_API_VERSION 1
+
+/** Return codes */
+#define ARSIM_OK	0	/**< Success					*/
+#define ARSIM_DONE	1	/**< Exit condition (-xj/-xt) reached		*/
+#define ARSIM_ERR	-1	/**< Error, see arsim_last_error()		*/
+#define ARSIM_ERR_ARG	-2	/**< Wrong argument (no such task, stat, ...)	*/
+#define ARSIM_ERR_STATE	-3	/**< Simulation unusable after a previous error	*/
+
+/** Kinds of statistics */
+#define ARSIM_STAT_COUNT 0	/**< Per-sample histogram (Stat)		*/
+#define ARSIM_STAT_TIME  1	/**< Time-weighted histogram (TimeStat)		*/
+#define ARSIM_STAT_SKETCH 2	/**< Quantile sketch, or sparse histogram: no bin arrays */
+
+/** Opaque simulation handle */
+typedef struct arsim_sim arsim_sim;
+
+/** View over a live statistic, without copies.
+ **
+ ** The arrays point into the statistic itself: they are updated in place by
+ ** the following steps, and are valid until the simulation is destroyed.
+ ** Bin n covers [x_min + n*dx, x_min + (n+1)*dx), and its PMF value is
+ ** counts[n] / norm, or weights[n] / norm. Bin arrays are allocated at the
+ ** first sample falling within them, and are NULL (all zero) up to then, so
+ ** the view needs to be taken again. Sketch and sparse statistics have no
+ ** bin arrays, and only report the summary fields; disabled ones have size 0.
+ **/
+typedef struct arsim_stat_view {
+  int kind;			/**< ARSIM_STAT_COUNT, _TIME or _SKETCH	*/
+  const long *counts;		/**< Occurrences per bin, or NULL		*/
+  const double *weights;	/**< Time spent per bin, or NULL		*/
+  long size;			/**< Number of bins				*/
+  double x_min;			/**< Left edge of the first bin			*/
+  double dx;			/**< Bin width					*/
+  double norm;			/**< Number of samples, or accumulated time	*/
+  long num_samples;		/**< Number of samples				*/
+  double mean, dev, min, max;	/**< Summary at the time of the call		*/
+} arsim_stat_view;
+
+/** Return ARSIM_API_VERSION as built into the library */
+int arsim_api_version(void);
+
+/** Create a simulation from command-line options (without program name),
+ ** e.g. { "-s", "la", "-t", "u", "-T", "40", "-xj", "1000", "-so" }.
+ **
+ ** Output files are written within dir, or within the current directory if
+ ** dir is NULL. As the working directory is process-wide, it is switched
+ ** only during the calls on this simulation. Each simulation has a private
+ ** random() state, initialized from seed: unlike within the arsim program,
+ ** tasks do not reseed it on creation, so simulations created with the same
+ ** seed and options produce the same results.
+ **
+ ** The returned handle is NULL only if out of memory. Configuration errors
+ ** make all the following calls fail with ARSIM_ERR_STATE: check them with
+ ** arsim_last_error(), which returns NULL on success.
+ **/
+arsim_sim *arsim_create(const char *dir, unsigned int seed, int argc, const char * const *argv);
+
+/** Destroy the simulation, closing its files */
+void arsim_destroy(arsim_sim *sim);
+
+/** Message describing the last error, or NULL */
+const char *arsim_last_error(const arsim_sim *sim);
+
+/** Run until the exit condition set with -xj or -xt */
+int arsim_run(arsim_sim *sim);
+
+/** Dispatch all events up to dt time units after the current time.
+ ** Returns ARSIM_DONE if the exit condition has been reached. */
+int arsim_step_time(arsim_sim *sim, double dt);
+
+/** Run until num_jobs more jobs of task tsk on resource rs have finished.
+ ** Returns ARSIM_DONE if the exit condition has been reached. */
+int arsim_step_jobs(arsim_sim *sim, long num_jobs, int tsk, int rs);
+
+/** Dump the final statistics files and summaries, as the arsim program
+ ** does at the end of the simulation */
+int arsim_finish(arsim_sim *sim);
+
+/** Current simulated time (negative on error) */
+double arsim_get_time(arsim_sim *sim);
+
+/** Number of resources, or of tasks on resource rs (negative on error) */
+int arsim_num_resources(arsim_sim *sim);
+int arsim_num_tasks(arsim_sim *sim, int rs);
+
+/** ID of the last finished job of task tsk on resource rs (negative on error) */
+long arsim_last_job(arsim_sim *sim, int tsk, int rs);
+
+/** Fill view with the statistic name of task tsk on resource rs, one of:
+ **   bw   granted bandwidth        rbw  required bandwidth
+ **   dbw  bandwidth difference     se   scheduling error
+ **   ck   c_k / T                  rs   reservation steps
+ **   pi   in-invariant indicator   pii  in-inner-invariant indicator
+ **/
+int arsim_get_stat(arsim_sim *sim, int tsk, int rs, const char *name, arsim_stat_view *view);
+
+/** Parse options between steps, as if given on the command line:
+ ** - on task tsk of resource rs (task and controller options), after which
+ **   the controller parameters are recomputed and checked;
+ ** - on resource rs (resource and supervisor options), if tsk < 0;
+ ** - as general options (optimizer, exporters, ...), if rs < 0.
+ ** Options that add resources or tasks are only meaningful at creation.
+ **/
+int arsim_set_options(arsim_sim *sim, int tsk, int rs, int argc, const char * const *argv);
+
+#ifdef  __cplusplus
+}
+#endif
+
+#endif
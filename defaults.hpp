@@ -72,8 +72,17 @@
 #define DEF_EPS_MIN (-1.0)
 #define DEF_EPS_MAX (4.0)
 
+/** Quantile statistics (QuantileStat) parameters	*/
+#define DEF_QUANTILE_PMF_SIZE (100)
+#define DEF_SKETCH_COMPRESSION (100.0)
+#define DEF_HDR_DIGITS (3)
+/** HdrStat resolution, as a fraction of the default stat interval	*/
+#define DEF_HDR_UNITS_PER_DX (1000)
+
 /** Global Optimizer defaults		*/
 /** Default load for optimiz. problem	*/
 #define DEF_AVG_LOAD (0.3)
+/** Default number of sub-buckets of a sliding window load estimate	*/
+#define DEF_WINDOW_BUCKETS (10)
 
 #endif
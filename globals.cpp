@@ -0,0 +1,231 @@
+/*
+ * ARSim
+ * Copyright (c) 2000-2010 Tommaso Cucinotta
+ *
+ * This file is part of ARSim.
+ *
+ * ARSim is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * ARSim is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with ARSim. If not, see <http://www.gnu.org/licenses/>
+ */
+
+/* Interface includes */
+
+#include "globals.hpp"
+
+#include "ResourceManager.hpp"
+#include "Task.hpp"
+#include "PairedDiff.hpp"
+#include "ReplicationAggregator.hpp"
+#include "util.hpp"
+#include "GlobalOptimizer.hpp"
+#include "TimelineExporter.hpp"
+#include "LiveMetrics.hpp"
+#include "StatSnapshot.hpp"
+#include "ScenarioGenerator.hpp"
+#include "ScenarioFile.hpp"
+#include "ReplayHarness.hpp"
+#include "ControllerBank.hpp"
+
+/* Implementation includes */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+ExitCond exit_cond = XC_JOB;
+double x_time = 1000000;	/**< 1 second					*/
+long int x_job = 10000;		/**< Exit at the end of the 10000th job...	*/
+int x_tsk = 0;			/**< ...of the first defined task		*/
+int x_rs = 0;			/**< ...within the first defined resource	*/
+bool stat_only = false;         /**< Dump statistics only (do not dump time-by-time changes)     */
+
+/** Options that only run a tool and exit, which would terminate the host
+ ** program of the embedded simulator, are refused there instead	*/
+#ifdef ARSIM_EMBEDDED
+#  define CHECK_STANDALONE(opt) checkFailed("Option %s is not available in the embedded simulator", opt)
+#else
+#  define CHECK_STANDALONE(opt) do { } while (0)
+#endif
+
+ResourceManager *p_gsched;	/**< Current ResourceManager while parsing args	*/
+
+char const *prog_name = "arsim";
+
+void usage() {
+  printf("\n");
+  printf("Usage: %s [options]\n", prog_name);
+  printf("  GENERAL OPTIONS\n");
+  printf("           -h      Print this help message and exit\n");
+  printf("           -xj j[,t[,r]] Exit at the specified job end\n");
+  printf("           -xt     Exit at the specified time\n");
+  printf("           -d      Enable log to specified file (defaults to /dev/null)\n");
+  printf("                   (.gz suffix: compressed text, .blog suffix: binary, decoded with -ld)\n");
+  printf("           -dc     Set debug log levels per category: cat=level,... (cat: gen/evt/sched/pred/spv/opt/all)\n");
+  printf("           -dn     Set number of debug log records dumped on a failed assertion\n");
+  printf("           -ld     Decode the specified binary debug log file to stdout and exit\n");
+  printf("           -r      Start definition of new resource\n");
+  printf("           -rn     Set new resource name\n");
+  printf("           -so     Dump statistics only (do not dump time-by-time changes)\n");
+  printf("           -crn    seed: Common random numbers, each task drawing from its own stream\n");
+  printf("           -crn-cmp a b: Print paired differences between the job records a and b (-rec) and exit\n");
+  printf("           -agg    out dir...: Merge the stats files of the replication directories into out,\n");
+  printf("                   with confidence intervals in out/replications.dat, and exit (last option)\n");
+  ResourceManager::usage();
+  GlobalOptimizer::usage();
+  TimelineExporter::usage();
+  LiveMetrics::usage();
+  StatSnapshot::usage();
+  ScenarioGenerator::usage();
+  ScenarioFile::usage();
+  ReplayHarness::usage();
+  ControllerBank::usage();
+  printf("\n");
+}
+
+bool parseArg(int & argc, char ** & argv) {
+  if (strcmp(*argv, "-xj") == 0) {
+    CHECK(argc > 1, "Option requires an argument");
+    argv++;  argc--;
+    CHECK(sscanf(*argv, "%ld,%d,%d", &x_job, &x_tsk, &x_rs) == 3
+	  || sscanf(*argv, "%ld,%d", &x_job, &x_tsk) == 2
+	  || sscanf(*argv, "%ld", &x_job) == 1,
+	  "Wrong format for -xj option");
+    exit_cond = XC_JOB;
+    Logger::debugLog("# Setting x_job=%d,%d,%d\n", x_job,x_tsk,x_rs);
+  } else if (strcmp(*argv, "-xt") == 0) {
+    CHECK(argc > 1, "Option requires an argument");
+    argv++;  argc--;
+    CHECK((sscanf(*argv, "%lg", &x_time) == 1) && (x_time > 0), "Expecting positive real as argument to -xt option");
+    exit_cond = XC_TIME;
+    Logger::debugLog("# Setting x_time=%g\n", x_time);
+  } else if (strcmp(*argv, "-d") == 0) {
+    CHECK(argc > 1, "Option requires an argument");
+    argv++;  argc--;
+    fprintf(stderr, "# Enabling debug log to file '%s'\n", *argv);
+    Logger::setLogFile(*argv);
+  } else if (strcmp(*argv, "-dc") == 0) {
+    CHECK(argc > 1, "Option requires an argument");
+    argv++;  argc--;
+    Logger::setLevels(*argv);
+  } else if (strcmp(*argv, "-dn") == 0) {
+    CHECK(argc > 1, "Option requires an argument");
+    argv++;  argc--;
+    int num_records;
+    CHECK(sscanf(*argv, "%d", &num_records) == 1, "Expecting integer as argument to -dn option");
+    Logger::setFlightRecorderSize(num_records);
+  } else if (strcmp(*argv, "-ld") == 0) {
+    CHECK_STANDALONE(*argv);
+    CHECK(argc > 1, "Option requires an argument");
+    argv++;  argc--;
+    exit(Logger::decodeFile(*argv, stdout) ? 0 : -1);
+  } else if (strcmp(*argv, "-r") == 0) {
+    p_gsched = new ResourceManager();
+  } else if (strcmp(*argv, "-rn") == 0) {
+    CHECK(argc > 1, "Option requires an argument");
+    argv++;  argc--;
+    p_gsched->setResourceName(*argv);
+  } else if (strcmp(*argv, "-so") == 0) {
+    stat_only = true;
+  } else if (strcmp(*argv, "-crn") == 0) {
+    CHECK(argc > 1, "Option requires an argument");
+    argv++;  argc--;
+    unsigned long long seed;
+    CHECK(sscanf(*argv, "%llu", &seed) == 1, "Expecting non-negative integer as argument to -crn option");
+    Task::setCRN(seed);
+  } else if (strcmp(*argv, "-crn-cmp") == 0) {
+    CHECK_STANDALONE(*argv);
+    CHECK(argc > 2, "Option requires two arguments");
+    PairedDiff::compare(argv[1], argv[2], stdout);
+    exit(0);
+  } else if (strcmp(*argv, "-agg") == 0) {
+    CHECK_STANDALONE(*argv);
+    CHECK(argc > 2, "Option requires an output directory and at least one replication directory");
+    int num_files = ReplicationAggregator::aggregate(argv[1], argc - 2, argv + 2);
+    fprintf(stderr, "Aggregated %d stats files from %d replications into %s\n", num_files, argc - 2, argv[1]);
+    exit(0);
+  } else if (strcmp(*argv, "-scn") == 0) {
+    CHECK(argc > 1, "Option requires an argument");
+    argv++;  argc--;
+    ScenarioFile::getInstance()->load(*argv);
+#ifdef ARSIM_EMBEDDED
+    CHECK(ScenarioFile::getInstance()->getNumRuns() == 1, "Only single-run scenario files can be embedded");
+#endif
+    int scn_argc;
+    char **scn_argv;
+    ScenarioFile::getInstance()->fanOut(scn_argc, scn_argv);
+    while (scn_argc > 0) {
+      CHECK1(parseArg(scn_argc, scn_argv), "Unknown option in scenario file: %s", *scn_argv);
+      scn_argv++;  scn_argc--;
+    }
+  } else if ((strcmp(*argv, "-h") == 0) || (strcmp(*argv, "--help") == 0)) {
+    CHECK_STANDALONE(*argv);
+    usage();
+    exit(-1);
+  } else if (p_gsched->parseArg(argc, argv)) {
+    ;
+  } else if (GlobalOptimizer::getInstance()->parseArg(argc, argv)) {
+    ;
+  } else if (TimelineExporter::getInstance()->parseArg(argc, argv)) {
+    ;
+  } else if (LiveMetrics::getInstance()->parseArg(argc, argv)) {
+    ;
+  } else if (StatSnapshot::getInstance()->parseArg(argc, argv)) {
+    ;
+  } else if (ScenarioGenerator::getInstance()->parseArg(argc, argv)) {
+    ;
+  } else if (ScenarioFile::getInstance()->parseArg(argc, argv)) {
+    ;
+  } else if (ReplayHarness::getInstance()->parseArg(argc, argv)) {
+    ;
+  } else if (ControllerBank::getInstance()->parseArg(argc, argv)) {
+    ;
+  } else
+    return false;
+  return true;
+}
+
+void startSimulation() {
+  ScenarioGenerator::getInstance()->generate();
+
+  p_gsched = 0;		// Global should not be used anymore from now on
+
+  ResourceManager::calcParamsAll();
+  GlobalOptimizer::getInstance()->calcParams();
+  CHECK(ResourceManager::checkParamsAll(), "Scheduling not possible with provided and default parameters");
+  CHECK(GlobalOptimizer::getInstance()->checkParams(), "Simulation impossible with current GlobalOptimizer parameters");
+}
+
+double stepSimulation() {
+  EventList::events().step();
+  if (! stat_only)
+    ResourceManager::dump();
+  double progress = 0.0;
+  switch (exit_cond) {
+  case XC_TIME:
+    progress = EventList::getTime() / x_time;
+    break;
+  case XC_JOB:
+    progress = double(ResourceManager::rs_controllers[0]->getLastFinishedJobID(0)) / double(x_job);
+    break;
+  }
+  LiveMetrics::getInstance()->update(progress);
+  return progress;
+}
+
+void endSimulation() {
+  StatSnapshot::getInstance()->close();
+  ResourceManager::dumpStatistics();
+  GlobalOptimizer::getInstance()->dumpStatistics();
+  TimelineExporter::getInstance()->close();
+  LiveMetrics::getInstance()->close();
+}
@@ -32,5 +32,26 @@ extern double x_time;		/**< Virtual time of exit		*/
 extern long int x_job;		/**< Last Job Id to execute		*/
 extern int x_rs;		/**< Resource to which last job belongs	*/
 extern int x_tsk;		/**< Task to which last job belongs	*/
+extern bool stat_only;		/**< Dump statistics only		*/
+
+class ResourceManager;
+
+extern ResourceManager *p_gsched; /**< Current ResourceManager while parsing args */
+extern char const *prog_name;
+
+/** Print the help message for all the simulator options	*/
+void usage();
+/** Parse one of the general options, or hand it over to the current
+ ** ResourceManager and to the singleton components.		*/
+bool parseArg(int & argc, char ** & argv);
+
+/** Generate the scenario, if requested, then compute and check the
+ ** parameters of all resources and of the global optimizer.	*/
+void startSimulation();
+/** Perform an event-based simulation step, returning the progress
+ ** towards the exit condition (1.0 or more once it is reached).	*/
+double stepSimulation();
+/** Close the exporters and dump the final statistics		*/
+void endSimulation();
 
 #endif
@@ -294,6 +294,8 @@ int solve(qos_opt *this) {
     good_idx = good_idx2 = -1;
 
     for (i = 0; i < p_op->num_apps; i++) {
+      if (p_op->appl_mode[i] == 0)
+        continue;
       p_op->appl_mode[i]--;
       val2 = qos_compute(this);
       dbg_printf("A%d: ", i);
@@ -309,6 +311,8 @@ int solve(qos_opt *this) {
       p_op->appl_mode[good_idx]--;
     } else {
       for (i = 0; i < p_op->num_res; i++) {
+	if (p_op->res_pot[i] + 1 >= p_op->res_modes)
+	  continue;
 	p_op->res_pot[i]++;
 	val2 = qos_compute(this);
 	dbg_printf("R%d: ", i);
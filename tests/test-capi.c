@@ -0,0 +1,134 @@
+#include <arsim.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <assert.h>
+
+static const char *opts[] = {
+  "-gc-type", "heur", "-gc-nums", "2,1,1,1",
+  "-spd", "1.0", "-s", "la", "-t", "u", "-T", "40", "-c", "10", "-C", "20",
+  "-s", "pdnv", "-t", "u", "-T", "20", "-c", "2", "-C", "8",
+  "-xj", "2000", "-so"
+};
+#define NUM_OPTS (sizeof(opts) / sizeof(opts[0]))
+
+/** Run one simulation, stepping by jobs and reading the live scheduling
+ ** error statistic of the first task */
+static void *runSim(void *arg) {
+  double *p_mean = (double *) arg;
+  arsim_sim *sim = arsim_create(NULL, 1, NUM_OPTS, opts);
+  assert(sim != NULL && arsim_last_error(sim) == NULL);
+  assert(arsim_num_resources(sim) == 1 && arsim_num_tasks(sim, 0) == 2);
+
+  int rv;
+  while ((rv = arsim_step_jobs(sim, 500, 0, 0)) == ARSIM_OK)
+    ;
+  assert(rv == ARSIM_DONE);
+  assert(arsim_last_job(sim, 0, 0) >= 2000);
+
+  arsim_stat_view v;
+  assert(arsim_get_stat(sim, 0, 0, "se", &v) == ARSIM_OK);
+  assert(v.kind == ARSIM_STAT_COUNT && v.counts != NULL);
+  long n = 0;
+  for (long i = 0; i < v.size; ++i)
+    n += v.counts[i];
+  assert(n <= v.num_samples);
+  *p_mean = v.mean;
+  arsim_destroy(sim);
+  return NULL;
+}
+
+/** Run the simulation with the -crn seed, with or without the controller
+ ** bank, changing the maximum bandwidth of the first task midway, and
+ ** return the scheduling error means of both tasks */
+static void runBank(int bank, double *means) {
+  const char *extra[] = { "-crn", "7", "-cbank" };
+  const char *argv[NUM_OPTS + 3];
+  int argc = 0;
+  for (int i = 0; i < 2 + bank; ++i)
+    argv[argc++] = extra[i];
+  for (unsigned int i = 0; i < NUM_OPTS; ++i)
+    argv[argc++] = opts[i];
+  arsim_sim *sim = arsim_create(NULL, 1, argc, argv);
+  assert(arsim_last_error(sim) == NULL);
+  assert(arsim_step_time(sim, 1000.0) == ARSIM_OK);
+  const char *bmax[] = { "-B", "0.7" };
+  assert(arsim_set_options(sim, 0, 0, 2, bmax) == ARSIM_OK);
+  assert(arsim_run(sim) == ARSIM_DONE);
+  arsim_stat_view v;
+  for (int t = 0; t < 2; ++t) {
+    assert(arsim_get_stat(sim, t, 0, "se", &v) == ARSIM_OK);
+    means[t] = v.mean;
+  }
+  arsim_destroy(sim);
+}
+
+int main(int argc, char *argv[]) {
+  assert(arsim_api_version() == ARSIM_API_VERSION);
+
+  /* Configuration errors are reported, not fatal */
+  const char *bad[] = { "-s", "la", "-T", "xyz" };
+  arsim_sim *sim = arsim_create(NULL, 1, 4, bad);
+  assert(arsim_last_error(sim) != NULL);
+  printf("Expected error: %s\n", arsim_last_error(sim));
+  assert(arsim_run(sim) == ARSIM_ERR_STATE);
+  arsim_destroy(sim);
+
+  /* Options that would exit the host program are refused */
+  const char *help[] = { "-h" };
+  sim = arsim_create(NULL, 1, 1, help);
+  assert(arsim_last_error(sim) != NULL);
+  printf("Expected error: %s\n", arsim_last_error(sim));
+  arsim_destroy(sim);
+
+  /* Changing parameters between steps */
+  sim = arsim_create(NULL, 1, NUM_OPTS, opts);
+  assert(arsim_step_time(sim, 1000.0) == ARSIM_OK);
+  assert(arsim_get_time(sim) <= 1000.0);
+  const char *inv[] = { "-inv-e", "2", "-inv-E", "2" };
+  assert(arsim_set_options(sim, 0, 0, 4, inv) == ARSIM_OK);
+  const char *unk[] = { "-foo" };
+  assert(arsim_set_options(sim, 0, 0, 1, unk) == ARSIM_ERR_ARG);
+  assert(arsim_run(sim) == ARSIM_DONE);
+  arsim_stat_view v;
+  assert(arsim_get_stat(sim, 0, 0, "bw", &v) == ARSIM_OK && v.kind == ARSIM_STAT_TIME);
+  printf("bw: mean=%g, time=%g\n", v.mean, v.norm);
+  arsim_destroy(sim);
+
+  /* Replacing the predictors of a task after its predictor got composed */
+  sim = arsim_create(NULL, 1, NUM_OPTS, opts);
+  assert(arsim_step_time(sim, 1000.0) == ARSIM_OK);
+  const char *vp[] = { "-vp", "sv" };
+  assert(arsim_set_options(sim, 1, 0, 2, vp) == ARSIM_OK);
+  assert(arsim_step_time(sim, 1000.0) == ARSIM_OK);
+  const char *rp[] = { "-rp", "sr" };
+  assert(arsim_set_options(sim, 1, 0, 2, rp) == ARSIM_OK);
+  assert(arsim_run(sim) == ARSIM_DONE);
+  arsim_destroy(sim);
+
+  /* The controller bank computes the same bandwidths as the scalar path */
+  double scalar[2], banked[2];
+  runBank(0, scalar);
+  runBank(1, banked);
+  for (int t = 0; t < 2; ++t) {
+    printf("se(%d,0) mean: scalar %g, banked %g\n", t, scalar[t], banked[t]);
+    assert(scalar[t] == banked[t]);
+  }
+
+  /* Independent instances from concurrent threads */
+  pthread_t th[4];
+  double means[4];
+  for (int i = 0; i < 4; ++i)
+    pthread_create(&th[i], NULL, runSim, &means[i]);
+  for (int i = 0; i < 4; ++i)
+    pthread_join(th[i], NULL);
+  for (int i = 0; i < 4; ++i) {
+    printf("se(0,0) mean of simulation %d: %g\n", i, means[i]);
+    /* Same seed and options, hence the same results */
+    assert(means[i] == means[0]);
+  }
+
+  printf("Test passed\n");
+  return 0;
+}
@@ -0,0 +1,40 @@
+#include <HdrStat.hpp>
+
+#include <vector>
+#include <algorithm>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <assert.h>
+
+/* Compare HdrStat quantiles against the exact ones, on heavy-tailed samples
+ * of both signs, split across two merged histograms */
+int main(int argc, char *argv[]) {
+  long n = argc > 1 ? atol(argv[1]) : 1000000;
+  int digits = argc > 2 ? atoi(argv[2]) : 3;
+  HdrStat h1(1e-6, digits), h2(1e-6, digits);
+  std::vector<double> v;
+  srandom(1);
+  for (long i = 0; i < n; ++i) {
+    double x = -log(1.0 - random() / (RAND_MAX + 1.0)) - 0.5;
+    if (i % 2)
+      h1.addSample(x);
+    else
+      h2.addSample(x);
+    v.push_back(x);
+  }
+  h1.merge(h2);
+  std::sort(v.begin(), v.end());
+  printf("samples=%ld buckets=%ld mean=%g\n", h1.getNumSamples(), h1.getNumBuckets(), h1.getMean());
+  assert(h1.getNumSamples() == n);
+
+  double tol = pow(10.0, -digits);
+  double ps[] = { 0.001, 0.01, 0.1, 0.5, 0.9, 0.99, 0.999, 0.9999 };
+  for (unsigned int i = 0; i < sizeof(ps) / sizeof(ps[0]); ++i) {
+    double exact = v[long(ceil(ps[i] * n)) - 1];
+    double est = h1.getQuantile(ps[i]);
+    printf("p=%-7g exact=%-10.6g hdr=%-10.6g\n", ps[i], exact, est);
+    assert(fabs(est - exact) <= fabs(exact) * tol + 2e-6);
+  }
+  return 0;
+}
@@ -0,0 +1,36 @@
+#include <WindowTimeStat.hpp>
+#include <DecayTimeStat.hpp>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <assert.h>
+
+/* Feed a square wave switching between 0.2 and 0.6 every 1000 time units,
+ * and compare the moving statistics against the closed-form values */
+int main(int argc, char *argv[]) {
+  double half_life = argc > 1 ? atof(argv[1]) : 500.0;
+  WindowTimeStat w(2000.0, 8);
+  DecayTimeStat d(half_life);
+  for (int t = 0; t <= 8000; t += 10) {
+    double x = (t / 1000) % 2 ? 0.2 : 0.6;
+    w.addSample(x, t);
+    d.addSample(x, t);
+    if (t % 1000 == 0 && t >= 2000) {
+      /* Half of the window at each level, up to now			*/
+      printf("t=%d window=%g (dev %g) decay=%g (dev %g)\n", t, w.getMean(t), w.getDev(t), d.getMean(t), d.getDev(t));
+      assert(fabs(w.getMean(t) - 0.4) < 1e-9);
+      assert(fabs(w.getDev(t) - 0.2) < 1e-9);
+      assert(fabs(w.getWeight(t) - 2000.0) < 1e-9);
+      /* Alternating levels, each one decayed by a w.r.t. the next one	*/
+      double a = pow(2.0, -1000.0 / half_life);
+      double x_last = ((t - 1) / 1000) % 2 ? 0.2 : 0.6;
+      double exp_mean = (x_last + (0.8 - x_last) * a) / (1 + a);
+      assert(t < 6000 || fabs(d.getMean(t) - exp_mean) < 1e-3);
+    }
+  }
+  /* Readers account for the last sample up to now, without updates	*/
+  assert(fabs(w.getMean(20000.0) - 0.6) < 1e-9);
+  assert(fabs(d.getMean(20000.0) - 0.6) < 1e-6);
+  return 0;
+}
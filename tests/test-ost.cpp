@@ -0,0 +1,41 @@
+#include <OrderStatTree.hpp>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <algorithm>
+#include <deque>
+#include <vector>
+
+/* Slide a window over random samples with many duplicates, checking every
+ * order statistic of OrderStatTree against a sorted copy of the window */
+int main(int argc, char *argv[]) {
+  long n = argc > 1 ? atol(argv[1]) : 20000;
+  unsigned int w = argc > 2 ? atoi(argv[2]) : 50;
+  OrderStatTree t;
+  std::deque<double> win;
+  srandom(1);
+  for (long i = 0; i < n; ++i) {
+    double x = random() % 100 / 4.0;
+    t.insert(x);
+    win.push_back(x);
+    if (win.size() > w) {
+      assert(t.erase(win.front()));
+      win.pop_front();
+    }
+    std::vector<double> v(win.begin(), win.end());
+    std::sort(v.begin(), v.end());
+    assert(t.size() == (int) v.size());
+    for (unsigned int k = 0; k < v.size(); ++k)
+      assert(t.select(k) == v[k]);
+  }
+  /* Removing a missing value leaves the tree untouched		*/
+  assert(! t.erase(-1.0));
+  assert(t.size() == (int) w);
+  t.clear();
+  assert(t.size() == 0);
+  t.insert(1.0);
+  assert(t.size() == 1 && t.select(0) == 1.0);
+  printf("order statistics checked over %ld windows of %u samples\n", n, w);
+  return 0;
+}
@@ -0,0 +1,54 @@
+#include <SketchStat.hpp>
+
+#include <vector>
+#include <algorithm>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <assert.h>
+
+/* Compare SketchStat quantiles against the exact ones, on heavy-tailed samples */
+int main(int argc, char *argv[]) {
+  long n = argc > 1 ? atol(argv[1]) : 1000000;
+  double compression = argc > 2 ? atof(argv[2]) : 100.0;
+  SketchStat s(compression);
+  std::vector<double> v;
+  srandom(1);
+  for (long i = 0; i < n; ++i) {
+    double x = -log(1.0 - random() / (RAND_MAX + 1.0));
+    s.addSample(x);
+    v.push_back(x);
+  }
+  std::sort(v.begin(), v.end());
+  printf("samples=%ld centroids=%ld\n", n, s.getNumCentroids());
+  assert(s.getNumCentroids() <= 2 * compression);
+
+  double ps[] = { 0.001, 0.01, 0.1, 0.5, 0.9, 0.99, 0.999, 0.9999 };
+  for (unsigned int i = 0; i < sizeof(ps) / sizeof(ps[0]); ++i) {
+    double exact = v[long(ps[i] * (n - 1))];
+    double est = s.getQuantile(ps[i]);
+    double cdf = s.getCDF(exact);
+    printf("p=%-7g exact=%-10.6g sketch=%-10.6g cdf(exact)=%-10.6g\n", ps[i], exact, est, cdf);
+    assert(fabs(cdf - ps[i]) < 0.01 * std::min(ps[i], 1 - ps[i]) + 1e-4);
+  }
+
+  /* Time-weighted: x=1 during [0,9), x=2 during [9,10) */
+  SketchStat ts(100.0, true);
+  ts.addSample(1.0, 0.0);
+  ts.addSample(2.0, 9.0);
+  ts.addSample(2.0, 10.0);
+  printf("time-weighted mean=%g p50=%g p95=%g\n", ts.getMean(), ts.getQuantile(0.5), ts.getQuantile(0.95));
+  assert(fabs(ts.getMean() - 1.1) < 1e-9);
+  assert(ts.getQuantile(0.5) == 1.0 && ts.getQuantile(0.95) == 2.0);
+  assert(fabs(ts.getCDF(1.0) - 0.9) < 1e-9);
+
+  /* Same, with x=1 sampled again at each time unit */
+  SketchStat ts2(100.0, true);
+  for (int t = 0; t < 9; ++t)
+    ts2.addSample(1.0, t);
+  ts2.addSample(2.0, 9.0);
+  ts2.addSample(2.0, 10.0);
+  printf("time-weighted p50=%g p95=%g\n", ts2.getQuantile(0.5), ts2.getQuantile(0.95));
+  assert(ts2.getQuantile(0.5) == 1.0 && ts2.getQuantile(0.95) == 2.0);
+  return 0;
+}
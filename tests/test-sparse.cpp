@@ -0,0 +1,44 @@
+#include <SparseStat.hpp>
+#include <Stat.hpp>
+#include <TimeStat.hpp>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <assert.h>
+
+/* Feed the same samples, partly out of range, to SparseStat and to Stat
+ * (TimeStat), and check that they report the same summaries and PMFs */
+int main(int argc, char *argv[]) {
+  long n = argc > 1 ? atol(argv[1]) : 100000;
+  SparseStat s(-1.0, 4.0, 0.01, false), ts(0.0, 1.0, 0.01, true);
+  Stat h(-1.0, 4.0, 0.01);
+  TimeStat th(0.0, 1.0, 0.01);
+  srandom(1);
+  double t = 0.0;
+  for (long i = 0; i < n; ++i) {
+    /* A few distinct values, plus some outliers			*/
+    double x = (random() % 4) * 0.25 - 0.1 + (random() % 100 == 0 ? 5.0 : 0.0);
+    s.addSample(x);
+    h.addSample(x);
+    t += random() / (RAND_MAX + 1.0);
+    ts.addSample(x / 4.0, t);
+    th.addSample(x / 4.0, t);
+  }
+  printf("sparse bins=%ld of %ld, time-weighted bins=%ld of %ld\n",
+         s.getNumBins(), s.getPMFSize(), ts.getNumBins(), ts.getPMFSize());
+  assert(s.getMean() == h.getMean() && s.getDev() == h.getDev());
+  assert(s.getMeanPos() == h.getMeanPos() && s.getMeanNegZero() == h.getMeanNegZero());
+  assert(s.sumPMFValues() == h.sumPMFValues() && s.calcPMFMean() == h.calcPMFMean());
+  assert(ts.getMean() == th.getMean() && ts.getDev() == th.getDev());
+  assert(ts.getMeanPos() == th.getMeanPos() && ts.getMeanNegZero() == th.getMeanNegZero());
+  assert(ts.sumPMFValues() == th.sumPMFValues() && ts.calcPMFMean() == th.calcPMFMean());
+  for (long k = 0; k < h.getPMFSize(); ++k)
+    assert(s.getPMFValue(k) == h.getPMFValue(k));
+  for (long k = 0; k < th.getPMFSize(); ++k)
+    assert(ts.getPMFValue(k) == th.getPMFValue(k));
+  double ps[] = { 0.05, 0.5, 0.95, 0.99 };
+  for (unsigned int i = 0; i < sizeof(ps) / sizeof(ps[0]); ++i)
+    assert(s.getPMFPercentile(ps[i]) == h.getPMFPercentile(ps[i]));
+  return 0;
+}
@@ -22,31 +22,457 @@
 #include <stdarg.h>
 #include <string.h>
 #include <zlib.h>
+#include <pthread.h>
+#include <time.h>
+
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/** Maximum number of arguments recorded for each binary log record	*/
+#define LOG_MAX_ARGS 8
+/** Space for the (NUL-separated) string arguments of each record	*/
+#define LOG_STR_SIZE 64
+
+/** Magic number at the beginning of binary log files			*/
+#define LOG_MAGIC "ARSIMBLG"
+#define LOG_VERSION 1
+
+/** Argument type codes, as derived from the conversions in a format string */
+enum {
+  ARG_INT = 'i', ARG_LONG = 'l', ARG_LLONG = 'L', ARG_DOUBLE = 'd', ARG_STR = 's', ARG_PTR = 'p'
+};
+
+/** Parse the conversion specification starting at p (just after the '%').
+ ** Return the position just after the conversion character, and fill in
+ ** the argument type and the number of '*' width/precision arguments.
+ **/
+static const char *parseConversion(const char *p, char *type, int *stars) {
+  *stars = 0;
+  while (*p != 0 && strchr("-+ #0'", *p) != NULL)
+    p++;
+  if (*p == '*') {
+    (*stars)++;
+    p++;
+  } else
+    while (*p >= '0' && *p <= '9')
+      p++;
+  if (*p == '.') {
+    p++;
+    if (*p == '*') {
+      (*stars)++;
+      p++;
+    } else
+      while (*p >= '0' && *p <= '9')
+	p++;
+  }
+  int longs = 0;
+  while (*p != 0 && strchr("hlLqjzt", *p) != NULL) {
+    if (*p == 'l' || *p == 'j' || *p == 'z' || *p == 't')
+      longs++;
+    else if (*p == 'q' || *p == 'L')
+      longs += 2;
+    p++;
+  }
+  switch (*p) {
+  case 'd': case 'i': case 'o': case 'u': case 'x': case 'X': case 'c':
+    *type = (longs == 0 ? ARG_INT : (longs == 1 ? ARG_LONG : ARG_LLONG));
+    break;
+  case 'e': case 'E': case 'f': case 'F': case 'g': case 'G': case 'a': case 'A':
+    *type = ARG_DOUBLE;
+    break;
+  case 's':
+    *type = ARG_STR;
+    break;
+  case 'p': case 'n':
+    *type = ARG_PTR;
+    break;
+  case '%':
+    *type = 0;
+    break;
+  default:
+    /* Unknown conversion: leave it as literal text */
+    *type = 0;
+    return p;
+  }
+  return p + 1;
+}
+
+/** Format a record, given its format string and raw arguments. String
+ ** arguments are offsets within strs, or -1 if they did not fit.
+ **/
+static void formatRecord(FILE *out, const char *fmt, const unsigned long long *args, int nargs,
+			 const char *strs) {
+  char spec[64];
+  char buf[1024];
+  int a = 0;
+  const char *p = fmt;
+  while (*p != 0) {
+    if (*p != '%') {
+      fputc(*p++, out);
+      continue;
+    }
+    const char *beg = p++;
+    char type;
+    int stars;
+    p = parseConversion(p, &type, &stars);
+    size_t len = p - beg;
+    if (type == 0 || len >= sizeof(spec) || a + stars + 1 > nargs) {
+      if (len == 2 && beg[1] == '%')
+	fputc('%', out);
+      else
+	fwrite(beg, 1, len, out);
+      continue;
+    }
+    memcpy(spec, beg, len);
+    spec[len] = 0;
+    int w1 = (stars > 0 ? (int) args[a] : 0);
+    int w2 = (stars > 1 ? (int) args[a + 1] : 0);
+    a += stars;
+    unsigned long long v = args[a++];
+    double d;
+    const char *str;
+#define FMT_STARS(val) \
+    (stars == 0 ? snprintf(buf, sizeof(buf), spec, val) \
+     : (stars == 1 ? snprintf(buf, sizeof(buf), spec, w1, val) \
+	: snprintf(buf, sizeof(buf), spec, w1, w2, val)))
+    switch (type) {
+    case ARG_INT:
+      FMT_STARS((int) v);
+      break;
+    case ARG_LONG:
+      FMT_STARS((long) v);
+      break;
+    case ARG_LLONG:
+      FMT_STARS((long long) v);
+      break;
+    case ARG_DOUBLE:
+      memcpy(&d, &v, sizeof(d));
+      FMT_STARS(d);
+      break;
+    case ARG_STR:
+      str = ((long long) v >= 0 && v < LOG_STR_SIZE) ? strs + v : "(...)";
+      FMT_STARS(str);
+      break;
+    default:
+      snprintf(buf, sizeof(buf), "%p", (void *) (unsigned long) v);
+    }
+#undef FMT_STARS
+    fputs(buf, out);
+  }
+}
+
+#ifdef ARSIM_EMBEDDED
+void checkFailed(const char *fmt, ...) {
+  char msg[512];
+  va_list args;
+  va_start(args, fmt);
+  vsnprintf(msg, sizeof(msg), fmt, args);
+  va_end(args);
+  throw std::runtime_error(msg);
+}
+#endif
+
+double getWallClock() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static bool readAll(FILE *f, void *p, size_t len) {
+  return fread(p, 1, len, f) == len;
+}
+
+bool Logger::decodeFile(const char *fname, FILE *out) {
+  FILE *f = fopen(fname, "rb");
+  BCHECK(f != NULL, "Could not open binary log file");
+  char magic[8];
+  unsigned int version;
+  if (! readAll(f, magic, sizeof(magic)) || memcmp(magic, LOG_MAGIC, sizeof(magic)) != 0
+      || ! readAll(f, &version, sizeof(version)) || version != LOG_VERSION) {
+    fclose(f);
+    BCHECK(false, "Not a binary log file, or unsupported version");
+  }
+  std::map<unsigned long long, std::string> fmts;
+  int c;
+  while ((c = fgetc(f)) != EOF) {
+    unsigned long long id;
+    if (c == 'F') {
+      unsigned int len;
+      if (! readAll(f, &id, sizeof(id)) || ! readAll(f, &len, sizeof(len)))
+	break;
+      std::string s(len, ' ');
+      if (len > 0 && ! readAll(f, &s[0], len))
+	break;
+      fmts[id] = s;
+    } else if (c == 'R') {
+      unsigned char hdr[4];	// cat, level, nargs, str_len
+      unsigned long long seq;
+      unsigned long long args[LOG_MAX_ARGS];
+      char strs[LOG_STR_SIZE];
+      if (! readAll(f, hdr, sizeof(hdr)) || ! readAll(f, &seq, sizeof(seq))
+	  || ! readAll(f, &id, sizeof(id)) || hdr[2] > LOG_MAX_ARGS || hdr[3] > LOG_STR_SIZE
+	  || ! readAll(f, args, hdr[2] * sizeof(args[0])) || ! readAll(f, strs, hdr[3]))
+	break;
+      std::map<unsigned long long, std::string>::iterator it = fmts.find(id);
+      if (it == fmts.end()) {
+	fprintf(out, "# Record %llu with unknown format ID %llx\n", seq, id);
+	continue;
+      }
+      formatRecord(out, it->second.c_str(), args, hdr[2], strs);
+    } else {
+      fprintf(stderr, "Error: corrupted binary log file\n");
+      break;
+    }
+  }
+  fclose(f);
+  return true;
+}
 
 #ifdef DEBUG_LOGGER
 
+/** Compute the argument types of a format string, '*' arguments included.
+ ** Return the number of arguments, truncated to max_types.
+ **/
+static int parseFormat(const char *fmt, char *types, int max_types) {
+  int n = 0;
+  for (const char *p = fmt; *p != 0; ) {
+    if (*p++ != '%')
+      continue;
+    char type;
+    int stars;
+    p = parseConversion(p, &type, &stars);
+    for (int i = 0; i < stars && n < max_types; ++i)
+      types[n++] = ARG_INT;
+    if (type != 0 && n < max_types)
+      types[n++] = type;
+  }
+  return n;
+}
+
 FILE *log_file = stderr;
 gzFile gz_log_file = NULL;
+/** Binary log file, if the deferred-format backend is in use	*/
+FILE *blog_file = NULL;
+pthread_mutex_t blog_mtx = PTHREAD_MUTEX_INITIALIZER;
 
-/** If fname has a ".gz" suffix, then logfile is automatically compressed. **/
+int Logger::cat_levels[LOG_NUM_CATEGORIES] = { 3, 3, 3, 3, 3, 3 };
+
+static const char *cat_names[Logger::LOG_NUM_CATEGORIES] = {
+  "gen", "evt", "sched", "pred", "spv", "opt"
+};
+
+/** A raw log record: format string and arguments, still to be formatted */
+struct LogRecord {
+  const char *fmt;
+  unsigned long long seq;
+  unsigned char cat, level, nargs, str_len;
+  unsigned long long args[LOG_MAX_ARGS];
+  char strs[LOG_STR_SIZE];
+};
+
+/** Cached argument types of a format string, to avoid re-parsing it	*/
+struct LogFmtSig {
+  const char *fmt;
+  int nargs;
+  char types[LOG_MAX_ARGS];
+};
+
+#define LOG_SIG_CACHE_SIZE 1024
+
+/** Per-thread ring buffer of the last log records			*/
+struct LogRing {
+  LogRecord *records;
+  unsigned long size;
+  unsigned long long seq;		/**< Number of records ever added	*/
+  unsigned long long flushed_seq;	/**< Records up to here already in blog_file */
+  LogFmtSig sigs[LOG_SIG_CACHE_SIZE];
+  std::set<const char *> written_fmts;
+};
+
+static unsigned long ring_size = 4096;
+static __thread LogRing *p_ring = NULL;
+/** All rings ever created, flushed to blog_file on close()	*/
+static std::vector<LogRing *> rings;
+
+static LogRing *getRing() {
+  if (p_ring == NULL) {
+    p_ring = new LogRing();
+    p_ring->size = ring_size;
+    p_ring->records = new LogRecord[ring_size];
+    p_ring->seq = p_ring->flushed_seq = 0;
+    memset(p_ring->sigs, 0, sizeof(p_ring->sigs));
+    pthread_mutex_lock(&blog_mtx);
+    rings.push_back(p_ring);
+    pthread_mutex_unlock(&blog_mtx);
+  }
+  return p_ring;
+}
+
+static const LogFmtSig *getSignature(LogRing *p, const char *fmt, LogFmtSig *p_tmp) {
+  unsigned long h = (((unsigned long) fmt) >> 3) % LOG_SIG_CACHE_SIZE;
+  for (int i = 0; i < LOG_SIG_CACHE_SIZE; ++i, h = (h + 1) % LOG_SIG_CACHE_SIZE) {
+    LogFmtSig *p_sig = &p->sigs[h];
+    if (p_sig->fmt == fmt)
+      return p_sig;
+    if (p_sig->fmt == NULL) {
+      p_sig->fmt = fmt;
+      p_sig->nargs = parseFormat(fmt, p_sig->types, LOG_MAX_ARGS);
+      return p_sig;
+    }
+  }
+  /* Cache full */
+  p_tmp->fmt = fmt;
+  p_tmp->nargs = parseFormat(fmt, p_tmp->types, LOG_MAX_ARGS);
+  return p_tmp;
+}
+
+/** Write the not yet written records of the ring to the binary log file */
+static void flushRing(LogRing *p) {
+  if (blog_file == NULL) {
+    p->flushed_seq = p->seq;
+    return;
+  }
+  pthread_mutex_lock(&blog_mtx);
+  for (unsigned long long s = p->flushed_seq; s < p->seq; ++s) {
+    LogRecord *r = &p->records[s % p->size];
+    unsigned long long id = (unsigned long) r->fmt;
+    if (p->written_fmts.find(r->fmt) == p->written_fmts.end()) {
+      p->written_fmts.insert(r->fmt);
+      unsigned int len = strlen(r->fmt);
+      fputc('F', blog_file);
+      fwrite(&id, sizeof(id), 1, blog_file);
+      fwrite(&len, sizeof(len), 1, blog_file);
+      fwrite(r->fmt, 1, len, blog_file);
+    }
+    fputc('R', blog_file);
+    fwrite(&r->cat, 1, 4, blog_file);	// cat, level, nargs, str_len
+    fwrite(&r->seq, sizeof(r->seq), 1, blog_file);
+    fwrite(&id, sizeof(id), 1, blog_file);
+    fwrite(r->args, sizeof(r->args[0]), r->nargs, blog_file);
+    fwrite(r->strs, 1, r->str_len, blog_file);
+  }
+  pthread_mutex_unlock(&blog_mtx);
+  p->flushed_seq = p->seq;
+}
+
+/** Store format string and raw arguments into the calling thread ring */
+static void addRecord(int cat, int level, const char *fmt, va_list val) {
+  LogRing *p = getRing();
+  if (p->seq - p->flushed_seq == p->size)
+    flushRing(p);
+  LogFmtSig tmp;
+  const LogFmtSig *p_sig = getSignature(p, fmt, &tmp);
+  LogRecord *r = &p->records[p->seq % p->size];
+  r->fmt = fmt;
+  r->seq = p->seq++;
+  r->cat = cat;
+  r->level = level;
+  r->nargs = p_sig->nargs;
+  r->str_len = 0;
+  for (int i = 0; i < p_sig->nargs; ++i) {
+    double d;
+    const char *s;
+    size_t len;
+    switch (p_sig->types[i]) {
+    case ARG_INT:
+      r->args[i] = (unsigned long long) va_arg(val, int);
+      break;
+    case ARG_LONG:
+      r->args[i] = (unsigned long long) va_arg(val, long);
+      break;
+    case ARG_LLONG:
+      r->args[i] = va_arg(val, unsigned long long);
+      break;
+    case ARG_DOUBLE:
+      d = va_arg(val, double);
+      memcpy(&r->args[i], &d, sizeof(d));
+      break;
+    case ARG_STR:
+      s = va_arg(val, const char *);
+      if (s == NULL)
+	s = "(null)";
+      len = strlen(s) + 1;
+      if (r->str_len + len > LOG_STR_SIZE) {
+	r->args[i] = (unsigned long long) -1;
+      } else {
+	memcpy(r->strs + r->str_len, s, len);
+	r->args[i] = r->str_len;
+	r->str_len += len;
+      }
+      break;
+    default:
+      r->args[i] = (unsigned long) va_arg(val, void *);
+    }
+  }
+}
+
+/** If fname has a ".gz" suffix, then logfile is automatically compressed.
+ ** If fname has a ".blog" suffix, then records are stored unformatted in
+ ** a binary file, to be decoded offline with the -ld option.
+ **/
 void Logger::setLogFile(const char *fname) {
-  if (log_file != stderr)
+  if (log_file != stderr && log_file != NULL)
     fclose(log_file);
+  log_file = NULL;
   if (strlen(fname) >= 3 && strcmp(fname + strlen(fname) - 3, ".gz") == 0) {
-    log_file = NULL;
     gz_log_file = gzopen(fname, "w");
     ASSERT1(gz_log_file != NULL, "Couldn't open log file '%s' !\n", fname);
+  } else if (strlen(fname) >= 5 && strcmp(fname + strlen(fname) - 5, ".blog") == 0) {
+    blog_file = fopen(fname, "wb");
+    ASSERT1(blog_file != NULL, "Couldn't open log file '%s' !\n", fname);
+    fwrite(LOG_MAGIC, 1, strlen(LOG_MAGIC), blog_file);
+    unsigned int version = LOG_VERSION;
+    fwrite(&version, sizeof(version), 1, blog_file);
   } else {
     log_file = fopen(fname, "w");
     ASSERT1(log_file != NULL, "Couldn't open log file '%s' !\n", fname);
   }
 }
 
+void Logger::setLevels(const char *spec) {
+  char name[16];
+  int level, n;
+  while (sscanf(spec, "%15[^=,]=%d%n", name, &level, &n) == 2) {
+    bool found = false;
+    for (int c = 0; c < LOG_NUM_CATEGORIES; ++c)
+      if (strcmp(name, cat_names[c]) == 0 || strcmp(name, "all") == 0) {
+	cat_levels[c] = level;
+	found = true;
+      }
+    CHECK1(found, "Unknown log category '%s'", name);
+    spec += n;
+    if (*spec != ',')
+      break;
+    spec++;
+  }
+  CHECK(*spec == 0, "Wrong format for log category levels (expecting cat=level,...)");
+}
+
+/** Rings created from now on will have the new size, and the ring of
+ ** the calling thread is resized, after flushing its records (if needed).
+ **/
+void Logger::setFlightRecorderSize(int num_records) {
+  CHECK(num_records > 0, "Log ring size must be positive");
+  ring_size = num_records;
+  if (p_ring != NULL) {
+    flushRing(p_ring);
+    delete [] p_ring->records;
+    p_ring->records = new LogRecord[ring_size];
+    p_ring->size = ring_size;
+    p_ring->seq = p_ring->flushed_seq = 0;
+  }
+}
+
 char line_buf[1024];
 
-void Logger::debugLog(const char *fmt, ...) {
-  va_list val;
-  va_start(val, fmt);
+static void logRecord(int cat, int level, const char *fmt, va_list val) {
+  va_list val2;
+  va_copy(val2, val);
+  addRecord(cat, level, fmt, val2);
+  va_end(val2);
   if (log_file != NULL) {
     vfprintf(log_file, fmt, val);
     fflush(log_file);
@@ -57,11 +483,51 @@ void Logger::debugLog(const char *fmt, ...) {
   }
 }
 
+void Logger::debugLog(const char *fmt, ...) {
+  if (! isEnabled(LOG_GENERIC, 1))
+    return;
+  va_list val;
+  va_start(val, fmt);
+  logRecord(LOG_GENERIC, 1, fmt, val);
+  va_end(val);
+}
+
+void Logger::debugLogC(int cat, int level, const char *fmt, ...) {
+  if (! isEnabled(cat, level))
+    return;
+  va_list val;
+  va_start(val, fmt);
+  logRecord(cat, level, fmt, val);
+  va_end(val);
+}
+
+void Logger::dumpFlightRecorder() {
+  if (p_ring == NULL)
+    return;
+  flushRing(p_ring);
+  if (blog_file != NULL)
+    fflush(blog_file);
+  unsigned long long first = (p_ring->seq > p_ring->size ? p_ring->seq - p_ring->size : 0);
+  fprintf(stderr, "# Last %llu debug log records:\n", p_ring->seq - first);
+  for (unsigned long long s = first; s < p_ring->seq; ++s) {
+    LogRecord *r = &p_ring->records[s % p_ring->size];
+    fprintf(stderr, "[%s] ", cat_names[r->cat]);
+    formatRecord(stderr, r->fmt, r->args, r->nargs, r->strs);
+  }
+  fflush(stderr);
+}
+
 void Logger::close() {
   if (log_file != NULL) {
     fclose(log_file);
   } else if (gz_log_file != NULL) {
     gzclose(gz_log_file);
+  } else if (blog_file != NULL) {
+    /* Other threads are supposed to be terminated at this point */
+    for (unsigned int i = 0; i < rings.size(); ++i)
+      flushRing(rings[i]);
+    fclose(blog_file);
+    blog_file = NULL;
   }
 }
 
@@ -24,13 +24,23 @@
 #include <stdio.h>
 #include <stdlib.h>
 
-/** Debugging asserts: failure of cond is usually a programming error */
-#define ASSERT(cond, msg) do { if (!(cond)) { fprintf(stderr, "ASSERT FAILED at line %d of file %s: %s\n", __LINE__, __FILE__, msg); abort(); } } while (0)
-#define ASSERT1(cond, msg, param) do { if (!(cond)) { fprintf(stderr, "ASSERT FAILED: " msg "\n", param); abort(); } } while (0)
+/** Debugging asserts: failure of cond is usually a programming error.
+ ** In DEBUG_LOGGER builds, the last debug log records are dumped before aborting. */
+#define ASSERT(cond, msg) do { if (!(cond)) { fprintf(stderr, "ASSERT FAILED at line %d of file %s: %s\n", __LINE__, __FILE__, msg); Logger::dumpFlightRecorder(); abort(); } } while (0)
+#define ASSERT1(cond, msg, param) do { if (!(cond)) { fprintf(stderr, "ASSERT FAILED: " msg "\n", param); Logger::dumpFlightRecorder(); abort(); } } while (0)
 
 /** Unrecoverable check: failure of cond implies a run-time error to be notified to the user, and exit(-1) */
+#ifndef ARSIM_EMBEDDED
 #define CHECK(cond, msg) do { if (!(cond)) { fprintf(stderr, "Error: %s\n", msg); exit(-1); } } while (0)
 #define CHECK1(cond, msg, param) do { if (!(cond)) { fprintf(stderr, "Error: " msg "\n", param); exit(-1); } } while (0)
+#else
+/** Within the embeddable library (see arsim.h), the host program must survive
+ ** a wrong configuration: the error is thrown as a std::runtime_error instead,
+ ** and turned into an error code at the API boundary. */
+void checkFailed(const char *fmt, ...) __attribute__ ((noreturn, format (printf, 1, 2)));
+#define CHECK(cond, msg) do { if (!(cond)) checkFailed("%s", msg); } while (0)
+#define CHECK1(cond, msg, param) do { if (!(cond)) checkFailed(msg, param); } while (0)
+#endif
 /** Boolean recoverable check: failure of cond implies a run-time error to be notified to the user */
 #define BCHECK(cond, msg) do { if (!(cond)) { fprintf(stderr, "Error: %s\n", msg); return false; } } while (0)
 
@@ -39,14 +49,49 @@
 
 #define DELTA 0.000001
 
+/** Monotonic wall-clock time in seconds, for measuring the simulator itself */
+double getWallClock();
+
 namespace Logger {
+  /** Runtime log categories, each one with its own verbosity level	*/
+  enum Category {
+    LOG_GENERIC = 0,	/**< Uncategorized messages, from debugLog()	*/
+    LOG_EVENTS,		/**< Event list management			*/
+    LOG_SCHED,		/**< Task schedulers and controllers		*/
+    LOG_PRED,		/**< Task predictors				*/
+    LOG_SUPERVISOR,	/**< Supervisors				*/
+    LOG_OPTIMIZER,	/**< Global optimizer				*/
+    LOG_NUM_CATEGORIES
+  };
+
+  /** Decode a binary log file (as written when the log file name has a
+   ** ".blog" suffix) into its textual form. Available in any build.	*/
+  bool decodeFile(const char *fname, FILE *out);
+
 #ifdef DEBUG_LOGGER
+  /** Maximum level of the messages logged for each category	*/
+  extern int cat_levels[LOG_NUM_CATEGORIES];
+  static inline bool isEnabled(int cat, int level) { return level <= cat_levels[cat]; }
+
   void debugLog(const char *fmt, ...);
+  /** Log a message of the specified category and level	*/
+  void debugLogC(int cat, int level, const char *fmt, ...);
   void setLogFile(const char *fname);
+  /** Set category levels from a "cat=level,..." specification	*/
+  void setLevels(const char *spec);
+  /** Set the number of records kept by each per-thread ring buffer	*/
+  void setFlightRecorderSize(int num_records);
+  /** Dump to stderr the last records of the calling thread	*/
+  void dumpFlightRecorder();
   void close();
 #else
+  static inline bool isEnabled(int cat, int level) { return false; }
   static inline void debugLog(const char *fmt, ...) {  }
+  static inline void debugLogC(int cat, int level, const char *fmt, ...) {  }
   static inline void setLogFile(const char *fname) {  }
+  static inline void setLevels(const char *spec) {  }
+  static inline void setFlightRecorderSize(int num_records) {  }
+  static inline void dumpFlightRecorder() {  }
   static inline void close() {  }
 #endif
 }